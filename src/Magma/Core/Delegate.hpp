@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace Magma
+{
+	template <typename TSignature>
+	class Delegate;
+
+	/// <summary>
+	///		Non-allocating type erased callable (a replacement for std::function).
+	///		Callables are stored inline in a fixed size buffer (enough for a lambda capturing four pointers or references),
+	///		and larger callables fail to compile instead of being moved to the heap.
+	/// </summary>
+	template <typename TRet, typename ... TArgs>
+	class Delegate<TRet(TArgs...)> final
+	{
+	public:
+		/// <summary>
+		///		Size of the inline buffer callables are stored in
+		/// </summary>
+		static constexpr size_t Capacity = 4 * sizeof(void*);
+
+		/// <summary>
+		///		Creates an empty delegate
+		/// </summary>
+		inline Delegate() { m_invoke = nullptr; m_manage = nullptr; }
+
+		/// <summary>
+		///		Creates a delegate which calls a callable object (a lambda, a function object or a function pointer)
+		/// </summary>
+		template <typename TCallable, typename = typename std::enable_if<!std::is_same<typename std::decay<TCallable>::type, Delegate>::value>::type>
+		inline Delegate(TCallable&& callable)
+		{
+			using Callable = typename std::decay<TCallable>::type;
+			static_assert(sizeof(Callable) <= Capacity, "Callable is too large to be stored in a Delegate (capture less, or capture a pointer to a struct)");
+			static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is over aligned for a Delegate");
+			static_assert(std::is_nothrow_move_constructible<Callable>::value, "Callables stored in Delegates must be nothrow move constructible");
+
+			new (&m_storage) Callable(std::forward<TCallable>(callable));
+			m_invoke = &Delegate::Invoke<Callable>;
+			m_manage = &Delegate::Manage<Callable>;
+		}
+
+		inline Delegate(const Delegate& rhs) { this->CopyFrom(rhs); }
+		inline Delegate(Delegate&& rhs) noexcept { this->MoveFrom(rhs); }
+		inline ~Delegate() { this->Reset(); }
+
+		inline Delegate& operator=(const Delegate& rhs) { if (this != &rhs) { this->Reset(); this->CopyFrom(rhs); } return *this; }
+		inline Delegate& operator=(Delegate&& rhs) noexcept { if (this != &rhs) { this->Reset(); this->MoveFrom(rhs); } return *this; }
+
+		/// <summary>
+		///		Calls the stored callable
+		/// </summary>
+		inline TRet operator()(TArgs ... args) const
+		{
+			if (m_invoke == nullptr)
+				throw std::runtime_error("Failed to call Delegate: delegate is empty");
+			return m_invoke(const_cast<void*>(static_cast<const void*>(&m_storage)), std::forward<TArgs>(args)...);
+		}
+
+		/// <summary>
+		///		Does the delegate store a callable?
+		/// </summary>
+		inline explicit operator bool() const { return m_invoke != nullptr; }
+
+		/// <summary>
+		///		Destroys the stored callable, leaving the delegate empty
+		/// </summary>
+		inline void Reset()
+		{
+			if (m_manage != nullptr)
+				m_manage(Operation::Destroy, &m_storage, nullptr);
+			m_invoke = nullptr;
+			m_manage = nullptr;
+		}
+
+	private:
+		enum class Operation
+		{
+			Invalid = -1,
+
+			Copy,
+			Move,
+			Destroy,
+
+			Count
+		};
+
+		template <typename TCallable>
+		static TRet Invoke(void* storage, TArgs ... args)
+		{
+			return (*static_cast<TCallable*>(storage))(std::forward<TArgs>(args)...);
+		}
+
+		template <typename TCallable>
+		static void Manage(Operation operation, void* dst, void* src)
+		{
+			switch (operation)
+			{
+				case Operation::Copy: new (dst) TCallable(*static_cast<const TCallable*>(src)); break;
+				case Operation::Move: new (dst) TCallable(std::move(*static_cast<TCallable*>(src))); static_cast<TCallable*>(src)->~TCallable(); break;
+				case Operation::Destroy: static_cast<TCallable*>(dst)->~TCallable(); break;
+				default: break;
+			}
+		}
+
+		inline void CopyFrom(const Delegate& rhs)
+		{
+			m_invoke = rhs.m_invoke;
+			m_manage = rhs.m_manage;
+			if (m_manage != nullptr)
+				m_manage(Operation::Copy, &m_storage, const_cast<void*>(static_cast<const void*>(&rhs.m_storage)));
+		}
+
+		inline void MoveFrom(Delegate& rhs)
+		{
+			m_invoke = rhs.m_invoke;
+			m_manage = rhs.m_manage;
+			if (m_manage != nullptr)
+				m_manage(Operation::Move, &m_storage, &rhs.m_storage);
+			rhs.m_invoke = nullptr;
+			rhs.m_manage = nullptr;
+		}
+
+		typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type m_storage;
+		TRet (*m_invoke)(void*, TArgs...);
+		void (*m_manage)(Operation, void*, void*);
+	};
+}
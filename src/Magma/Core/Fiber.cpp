@@ -0,0 +1,116 @@
+#include "Fiber.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+Magma::Fiber::Fiber()
+{
+	m_entry = nullptr;
+	m_argument = nullptr;
+	m_thread = true;
+	m_converted = false;
+	m_fiber = ConvertThreadToFiber(nullptr);
+	if (m_fiber != nullptr)
+		m_converted = true;
+	else if (GetLastError() == ERROR_ALREADY_FIBER)
+		m_fiber = GetCurrentFiber();
+	else throw std::runtime_error("Failed to create Fiber: couldn't convert the thread to a fiber");
+}
+
+Magma::Fiber::Fiber(Function entry, void * argument, size_t stackSize)
+{
+	m_entry = entry;
+	m_argument = argument;
+	m_thread = false;
+	m_converted = false;
+	m_fiber = CreateFiber(stackSize, &Fiber::Start, this);
+	if (m_fiber == nullptr)
+		throw std::runtime_error("Failed to create Fiber: CreateFiber failed");
+}
+
+Magma::Fiber::~Fiber()
+{
+	if (!m_thread)
+		DeleteFiber(m_fiber);
+	else if (m_converted)
+		ConvertFiberToThread();
+}
+
+void Magma::Fiber::SwitchTo(Fiber & fiber)
+{
+	SwitchToFiber(fiber.m_fiber);
+}
+
+void __stdcall Magma::Fiber::Start(void * fiber)
+{
+	((Fiber*)fiber)->m_entry(((Fiber*)fiber)->m_argument);
+}
+#else
+Magma::Fiber::Fiber()
+{
+	// The context is saved by the first switch from the thread
+	m_stack = nullptr;
+	m_stackSize = 0;
+	m_entry = nullptr;
+	m_argument = nullptr;
+}
+
+Magma::Fiber::Fiber(Function entry, void * argument, size_t stackSize)
+{
+	m_entry = entry;
+	m_argument = argument;
+
+	// The lowest page is left inaccessible, so a stack overflow crashes instead of corrupting memory
+	auto pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	m_stackSize = (stackSize + pageSize - 1) / pageSize * pageSize + pageSize;
+	m_stack = mmap(nullptr, m_stackSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (m_stack == MAP_FAILED)
+		throw std::runtime_error("Failed to create Fiber: couldn't allocate the stack");
+	if (mprotect(m_stack, pageSize, PROT_NONE) != 0)
+	{
+		munmap(m_stack, m_stackSize);
+		throw std::runtime_error("Failed to create Fiber: couldn't protect the stack guard page");
+	}
+
+	if (getcontext(&m_context) != 0)
+	{
+		munmap(m_stack, m_stackSize);
+		throw std::runtime_error("Failed to create Fiber: getcontext failed");
+	}
+	m_context.uc_stack.ss_sp = m_stack;
+	m_context.uc_stack.ss_size = m_stackSize;
+	m_context.uc_link = nullptr;
+
+	// makecontext only passes int arguments, so the fiber pointer is split in two halves
+	auto address = (uint64_t)(uintptr_t)this;
+	makecontext(&m_context, (void(*)())&Fiber::Start, 2, (unsigned int)(address >> 32), (unsigned int)address);
+}
+
+Magma::Fiber::~Fiber()
+{
+	if (m_stack != nullptr)
+		munmap(m_stack, m_stackSize);
+}
+
+void Magma::Fiber::SwitchTo(Fiber & fiber)
+{
+	if (swapcontext(&m_context, &fiber.m_context) != 0)
+		throw std::runtime_error("Failed to switch Fiber: swapcontext failed");
+}
+
+void Magma::Fiber::Start(unsigned int high, unsigned int low)
+{
+	auto fiber = (Fiber*)(uintptr_t)(((uint64_t)high << 32) | low);
+	fiber->m_entry(fiber->m_argument);
+}
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+
+#ifndef _WIN32
+#include <ucontext.h>
+#endif
+
+namespace Magma
+{
+	/// <summary>
+	///		Execution context with its own stack, which is switched to and from explicitly on the same thread (cooperative multitasking).
+	///		Uses the system fibers on Windows and ucontext elsewhere (Linux x86-64 and AArch64), with a guard page below the stack.
+	///		Switching only saves the callee saved registers (and the signal mask with ucontext), so it is much cheaper than parking a thread.
+	/// </summary>
+	class Fiber final
+	{
+	public:
+		/// <summary>
+		///		Fiber entry point, which must never return (switch to another fiber instead)
+		/// </summary>
+		using Function = void(*)(void* argument);
+
+		/// <summary>
+		///		Creates a fiber for the calling thread's own context, so other fibers can switch back to the thread.
+		///		It must be destroyed on the same thread.
+		/// </summary>
+		Fiber();
+
+		/// <summary>
+		///		Creates a new fiber, which starts running its entry point the first time it is switched to
+		/// </summary>
+		/// <param name="entry">Entry point</param>
+		/// <param name="argument">Argument passed to the entry point</param>
+		/// <param name="stackSize">Stack size in bytes (rounded up to the page size)</param>
+		Fiber(Function entry, void* argument, size_t stackSize);
+
+		/// <summary>
+		///		Frees the fiber stack (a suspended fiber is discarded without unwinding its stack)
+		/// </summary>
+		~Fiber();
+
+		Fiber(const Fiber&) = delete;
+		Fiber& operator=(const Fiber&) = delete;
+
+		/// <summary>
+		///		Suspends this fiber, which must be the one running on the calling thread, and resumes another one
+		/// </summary>
+		/// <param name="fiber">Fiber to resume</param>
+		void SwitchTo(Fiber& fiber);
+
+	private:
+		Function m_entry;
+		void* m_argument;
+
+#ifdef _WIN32
+		static void __stdcall Start(void* fiber);
+
+		void* m_fiber;
+		bool m_thread;
+		bool m_converted;
+#else
+		static void Start(unsigned int high, unsigned int low);
+
+		ucontext_t m_context;
+		void* m_stack;
+		size_t m_stackSize;
+#endif
+	};
+}
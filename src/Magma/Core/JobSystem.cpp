@@ -0,0 +1,423 @@
+#include "JobSystem.hpp"
+
+#include <stdexcept>
+
+// Worker of the calling thread (a thread is a worker of at most one job system at a time)
+static thread_local const Magma::JobSystem* currentJobSystem = nullptr;
+static thread_local void* currentWorker = nullptr;
+static thread_local int currentWorkerIndex = -1;
+
+// Number of job slots checked before giving up and running a job immediately (a full scan would make every job O(pool) once the pool is full)
+static constexpr size_t AllocateProbeCount = 16;
+
+// Idle workers retry stealing a few times before sleeping, as new jobs usually follow shortly
+static constexpr size_t IdleSpinCount = 64;
+
+Magma::JobSystem::JobSystem(size_t workerCount, size_t jobsPerWorker, size_t fibersPerWorker, size_t fiberStackSize)
+{
+	if (workerCount == 0)
+		workerCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	if (currentJobSystem != nullptr)
+		throw std::runtime_error("Failed to create JobSystem: the calling thread is already a worker of another job system");
+
+	m_queuedJobs.store(0, std::memory_order_relaxed);
+	m_sleepingWorkers.store(0, std::memory_order_relaxed);
+	m_stopping.store(false, std::memory_order_relaxed);
+
+	// Every fiber of a worker, and the creating thread's own context, can be waiting to be resumed at once
+	size_t resumedCount = 2;
+	while (resumedCount < fibersPerWorker + 1)
+		resumedCount *= 2;
+
+	for (size_t i = 0; i < workerCount; ++i)
+	{
+		m_workers.emplace_back(new Worker(jobsPerWorker, resumedCount));
+		auto& worker = *m_workers.back();
+		worker.random = (uint32_t)(i * 2654435761u + 1);
+		for (size_t j = 0; j < jobsPerWorker; ++j)
+			worker.jobs[j].free.store(true, std::memory_order_relaxed);
+
+		worker.currentFiber = nullptr;
+		worker.previousFiber = nullptr;
+		worker.previousAction = SwitchAction::None;
+		worker.previousCounter = nullptr;
+		for (size_t j = 0; j < fibersPerWorker; ++j)
+		{
+			worker.fibers.emplace_back(new WorkerFiber());
+			auto fiber = worker.fibers.back().get();
+			fiber->fiber.reset(new Fiber(&JobSystem::FiberMain, fiber, fiberStackSize));
+			fiber->system = this;
+			fiber->worker = &worker;
+			fiber->next = nullptr;
+			worker.freeFibers.push_back(fiber);
+		}
+	}
+
+	currentJobSystem = this;
+	currentWorker = m_workers[0].get();
+	currentWorkerIndex = 0;
+
+	// The creating thread's context is a fiber too, so it can be suspended while it waits
+	if (fibersPerWorker != 0)
+		this->CreateThreadFiber(*m_workers[0]);
+
+	for (size_t i = 1; i < workerCount; ++i)
+		m_workers[i]->thread = std::thread(&JobSystem::WorkerMain, this, i);
+}
+
+Magma::JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_stopping.store(true, std::memory_order_seq_cst);
+	}
+	m_sleepCondition.notify_all();
+
+	for (auto& w : m_workers)
+		if (w->thread.joinable())
+			w->thread.join();
+
+	if (currentJobSystem == this)
+	{
+		currentJobSystem = nullptr;
+		currentWorker = nullptr;
+		currentWorkerIndex = -1;
+	}
+}
+
+void Magma::JobSystem::Run(Function function, JobCounter * counter, JobCounter * dependency)
+{
+	auto worker = this->GetCurrentWorker();
+	if (worker == nullptr)
+		throw std::runtime_error("Failed to run job on JobSystem: jobs can only be created from the job system's workers");
+
+	if (counter != nullptr)
+		counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+	auto job = this->Allocate(*worker);
+	if (job == nullptr)
+	{
+		// Every job slot of this worker is pending, run the job now instead of waiting for one
+		if (dependency != nullptr)
+			this->Wait(*dependency);
+		function();
+		this->Finish(counter);
+		return;
+	}
+
+	job->function = std::move(function);
+	job->counter = counter;
+	job->next = nullptr;
+
+	if (dependency != nullptr)
+	{
+		std::unique_lock<std::mutex> lock(dependency->m_mutex);
+		if (dependency->m_count.load(std::memory_order_acquire) != 0)
+		{
+			job->next = (Job*)dependency->m_continuations;
+			dependency->m_continuations = job;
+			return;
+		}
+	}
+
+	this->Push(*worker, job);
+}
+
+void Magma::JobSystem::Wait(JobCounter & counter)
+{
+	auto worker = this->GetCurrentWorker();
+	while (!counter.IsDone())
+	{
+		if (worker != nullptr && worker->currentFiber != nullptr)
+		{
+			// Suspend the calling fiber, preferably for a resumed one (which may be what the counter is waiting on), else for a free one
+			WorkerFiber* fiber = nullptr;
+			if (worker->resumed.TryPop(fiber))
+				m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			else if (!worker->freeFibers.empty())
+			{
+				fiber = worker->freeFibers.back();
+				worker->freeFibers.pop_back();
+			}
+
+			if (fiber != nullptr)
+			{
+				this->SwitchFiber(*worker, fiber, SwitchAction::Suspend, &counter);
+				continue;
+			}
+		}
+
+		// No fiber to switch to, run jobs on this stack meanwhile
+		if (worker == nullptr || !this->TryRunJob(*worker))
+			std::this_thread::yield();
+	}
+
+	// Wait for the last job to release the counter
+	std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+int Magma::JobSystem::GetWorkerIndex() const
+{
+	return currentJobSystem == this ? currentWorkerIndex : -1;
+}
+
+void Magma::JobSystem::FiberMain(void * argument)
+{
+	auto fiber = (WorkerFiber*)argument;
+	auto system = fiber->system;
+	auto& worker = *fiber->worker;
+	system->FinishSwitch(worker);
+	system->RunWorker(worker);
+
+	// The job system is stopping, go back to the worker thread so it can exit
+	worker.previousFiber = worker.currentFiber;
+	worker.previousAction = SwitchAction::None;
+	worker.currentFiber = worker.threadFiber.get();
+	worker.previousFiber->fiber->SwitchTo(*worker.currentFiber->fiber);
+}
+
+Magma::JobSystem::Worker * Magma::JobSystem::GetCurrentWorker() const
+{
+	return currentJobSystem == this ? (Worker*)currentWorker : nullptr;
+}
+
+Magma::JobSystem::Job * Magma::JobSystem::Allocate(Worker & worker)
+{
+	// Jobs are usually finished in the order they were allocated, so the next slot is almost always free
+	auto probeCount = std::min(worker.jobCount, AllocateProbeCount);
+	for (size_t i = 0; i < probeCount; ++i)
+	{
+		auto& job = worker.jobs[worker.nextJob];
+		worker.nextJob = (worker.nextJob + 1) & (worker.jobCount - 1);
+		if (job.free.load(std::memory_order_acquire))
+		{
+			job.free.store(false, std::memory_order_relaxed);
+			return &job;
+		}
+	}
+	return nullptr;
+}
+
+void Magma::JobSystem::Push(Worker & worker, Job * job)
+{
+	// Counted before pushing, so a thief taking the job right away can't bring the count below zero
+	m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+	if (!worker.deque.Push(job))
+	{
+		m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		this->Execute(job);
+		return;
+	}
+
+	if (m_sleepingWorkers.load(std::memory_order_seq_cst) != 0)
+	{
+		// Taking the lock orders the wake up after a sleeping worker's last check of the queued jobs
+		{ std::lock_guard<std::mutex> lock(m_sleepMutex); }
+		m_sleepCondition.notify_one();
+	}
+}
+
+bool Magma::JobSystem::TryRunJob(Worker & worker)
+{
+	auto job = worker.deque.Pop();
+	if (job == nullptr && m_workers.size() > 1)
+	{
+		// Start stealing from a random worker, so thieves spread over the victims
+		worker.random ^= worker.random << 13;
+		worker.random ^= worker.random >> 17;
+		worker.random ^= worker.random << 5;
+		auto first = worker.random % m_workers.size();
+		for (size_t i = 0; i < m_workers.size() && job == nullptr; ++i)
+		{
+			auto& victim = *m_workers[(first + i) % m_workers.size()];
+			if (&victim != &worker)
+				job = victim.deque.Steal();
+		}
+	}
+
+	if (job == nullptr)
+		return false;
+
+	m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	this->Execute(job);
+	return true;
+}
+
+void Magma::JobSystem::Execute(Job * job)
+{
+	// The slot is released before running the job, so the job can create others in it
+	auto function = std::move(job->function);
+	auto counter = job->counter;
+	job->function.Reset();
+	job->free.store(true, std::memory_order_release);
+
+	function();
+	this->Finish(counter);
+}
+
+void Magma::JobSystem::Finish(JobCounter * counter)
+{
+	if (counter == nullptr)
+		return;
+
+	// Jobs which aren't the last one of the counter only decrement it
+	auto count = counter->m_count.load(std::memory_order_relaxed);
+	while (count > 1)
+		if (counter->m_count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+			return;
+
+	// The last job reaches zero while holding the lock, which waiters take before returning, so the counter can't be destroyed under it
+	Job* continuations;
+	WorkerFiber* fibers;
+	{
+		std::lock_guard<std::mutex> lock(counter->m_mutex);
+		if (counter->m_count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+		continuations = (Job*)counter->m_continuations;
+		counter->m_continuations = nullptr;
+		fibers = (WorkerFiber*)counter->m_waitingFibers;
+		counter->m_waitingFibers = nullptr;
+	}
+
+	while (fibers != nullptr)
+	{
+		auto next = fibers->next;
+		this->Resume(fibers);
+		fibers = next;
+	}
+
+	auto& worker = *this->GetCurrentWorker();
+	while (continuations != nullptr)
+	{
+		auto next = continuations->next;
+		this->Push(worker, continuations);
+		continuations = next;
+	}
+}
+
+void Magma::JobSystem::CreateThreadFiber(Worker & worker)
+{
+	worker.threadFiber.reset(new WorkerFiber());
+	worker.threadFiber->fiber.reset(new Fiber());
+	worker.threadFiber->system = this;
+	worker.threadFiber->worker = &worker;
+	worker.threadFiber->next = nullptr;
+	worker.currentFiber = worker.threadFiber.get();
+}
+
+void Magma::JobSystem::Resume(WorkerFiber * fiber)
+{
+	// The queue can hold every fiber of its worker, so it is never full
+	m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+	fiber->next = nullptr;
+	fiber->worker->resumed.TryPush(fiber);
+
+	// Only the fiber's own worker can resume it, so every sleeping worker is woken up
+	if (m_sleepingWorkers.load(std::memory_order_seq_cst) != 0)
+	{
+		{ std::lock_guard<std::mutex> lock(m_sleepMutex); }
+		m_sleepCondition.notify_all();
+	}
+}
+
+bool Magma::JobSystem::ResumeFiber(Worker & worker)
+{
+	WorkerFiber* fiber;
+	if (worker.currentFiber == nullptr || !worker.resumed.TryPop(fiber))
+		return false;
+
+	// Only called from the worker loop, where the current fiber has no job left on its stack, so it can be reused
+	m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	this->SwitchFiber(worker, fiber, SwitchAction::Free, nullptr);
+	return true;
+}
+
+void Magma::JobSystem::SwitchFiber(Worker & worker, WorkerFiber * fiber, SwitchAction action, JobCounter * counter)
+{
+	// The fiber switched from is freed or suspended by the fiber switched to, once its context is saved,
+	// otherwise a job finishing on another worker could resume it while it is still running
+	worker.previousFiber = worker.currentFiber;
+	worker.previousAction = action;
+	worker.previousCounter = counter;
+	worker.currentFiber = fiber;
+	worker.previousFiber->fiber->SwitchTo(*fiber->fiber);
+	this->FinishSwitch(worker);
+}
+
+void Magma::JobSystem::FinishSwitch(Worker & worker)
+{
+	auto fiber = worker.previousFiber;
+	auto action = worker.previousAction;
+	auto counter = worker.previousCounter;
+	worker.previousFiber = nullptr;
+	worker.previousAction = SwitchAction::None;
+	worker.previousCounter = nullptr;
+
+	if (action == SwitchAction::Free)
+		worker.freeFibers.push_back(fiber);
+	else if (action == SwitchAction::Suspend)
+	{
+		{
+			std::lock_guard<std::mutex> lock(counter->m_mutex);
+			if (counter->m_count.load(std::memory_order_acquire) != 0)
+			{
+				fiber->next = (WorkerFiber*)counter->m_waitingFibers;
+				counter->m_waitingFibers = fiber;
+				return;
+			}
+		}
+
+		// The counter reached zero during the switch
+		this->Resume(fiber);
+	}
+}
+
+void Magma::JobSystem::RunWorker(Worker & worker)
+{
+	size_t idle = 0;
+	while (!m_stopping.load(std::memory_order_relaxed))
+	{
+		if (this->ResumeFiber(worker) || this->TryRunJob(worker))
+		{
+			idle = 0;
+			continue;
+		}
+
+		if (++idle < IdleSpinCount)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+		{
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepCondition.wait(lock, [&]() { return m_queuedJobs.load(std::memory_order_seq_cst) != 0 || m_stopping.load(std::memory_order_relaxed); });
+		}
+		m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+		idle = 0;
+	}
+}
+
+void Magma::JobSystem::WorkerMain(size_t index)
+{
+	currentJobSystem = this;
+	currentWorker = m_workers[index].get();
+	currentWorkerIndex = (int)index;
+	auto& worker = *m_workers[index];
+
+	if (worker.freeFibers.empty())
+	{
+		this->RunWorker(worker);
+		return;
+	}
+
+	// The thread's own context only waits for the job system to stop, the worker loop runs on the fibers
+	this->CreateThreadFiber(worker);
+	auto fiber = worker.freeFibers.back();
+	worker.freeFibers.pop_back();
+	this->SwitchFiber(worker, fiber, SwitchAction::None, nullptr);
+
+	// Converted threads must be converted back on their own thread
+	worker.threadFiber.reset();
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "Delegate.hpp"
+#include "Fiber.hpp"
+#include "MPSCQueue.hpp"
+#include "WorkStealingDeque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Magma
+{
+	/// <summary>
+	///		Counts the unfinished jobs of a group, which can be waited on or used as a dependency of other jobs
+	/// </summary>
+	class JobCounter final
+	{
+	public:
+		inline JobCounter() { m_count.store(0, std::memory_order_relaxed); m_continuations = nullptr; m_waitingFibers = nullptr; }
+		inline ~JobCounter() { }
+
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		/// <summary>
+		///		Have all the jobs of the group finished?
+		/// </summary>
+		inline bool IsDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+		/// <summary>
+		///		Gets the number of unfinished jobs
+		/// </summary>
+		inline size_t GetCount() const { return m_count.load(std::memory_order_acquire); }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<size_t> m_count;
+
+		// Jobs which depend on this counter, pushed when it reaches zero, and fibers suspended on it, resumed when it reaches zero
+		std::mutex m_mutex;
+		void* m_continuations;
+		void* m_waitingFibers;
+	};
+
+	/// <summary>
+	///		Work stealing job scheduler, with one worker thread per core.
+	///		The thread which creates the job system is its first worker: it runs jobs while it waits on a counter.
+	///		Each worker pushes the jobs it creates into its own deque and pops them back in LIFO order (hot in cache),
+	///		idle workers steal the oldest jobs of a random other worker (usually the largest pieces of work), and sleep when there are none.
+	///		Jobs are non-allocating delegates stored in per-worker pools, so scheduling a job never allocates.
+	///		Jobs can only be created from the workers (the creating thread, or other jobs), but counters can be waited on from any thread.
+	///
+	///		Workers run on fibers, so a job waiting on a counter suspends its fiber instead of blocking its worker: the worker switches to
+	///		another fiber, which keeps running jobs, and the suspended fiber is resumed on the same worker once the counter reaches zero.
+	///		Jobs only switch fibers when they wait, so jobs which don't wait cost no more than without fibers.
+	///		When a worker has no free fiber left, waiting jobs fall back to running other jobs on their own stack until the counter reaches zero.
+	/// </summary>
+	class JobSystem final
+	{
+	public:
+		/// <summary>
+		///		Job function type
+		/// </summary>
+		using Function = Delegate<void()>;
+
+		/// <summary>
+		///		Creates a new job system and starts its worker threads
+		/// </summary>
+		/// <param name="workerCount">Number of workers, including the calling thread (0 for one per hardware thread)</param>
+		/// <param name="jobsPerWorker">Maximum number of pending jobs per worker (power of two), jobs created past it run immediately</param>
+		/// <param name="fibersPerWorker">Number of fibers per worker, which bounds the jobs suspended at once on a worker (0 to disable fibers)</param>
+		/// <param name="fiberStackSize">Stack size of each fiber in bytes (only the pages used are committed)</param>
+		JobSystem(size_t workerCount = 0, size_t jobsPerWorker = 4096, size_t fibersPerWorker = 16, size_t fiberStackSize = 256 * 1024);
+
+		/// <summary>
+		///		Stops the worker threads (jobs still pending or suspended are discarded, wait on their counters first)
+		/// </summary>
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		/// <summary>
+		///		Schedules a job (must be called from a worker)
+		/// </summary>
+		/// <param name="function">Job function</param>
+		/// <param name="counter">Counter incremented until the job finishes (optional)</param>
+		/// <param name="dependency">Counter which must reach zero before the job starts (optional)</param>
+		void Run(Function function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+		/// <summary>
+		///		Blocks until a counter reaches zero. Called from a job, it suspends the job's fiber until then, and from the creating thread,
+		///		the thread switches to a fiber which runs jobs meanwhile. Called from any other thread, it only yields.
+		///		A counter must not be destroyed before being waited on, even if it is done.
+		/// </summary>
+		void Wait(JobCounter& counter);
+
+		/// <summary>
+		///		Calls a function over the range [0, count[ split in chunks run in parallel, and waits for all of them (must be called from a worker).
+		///		The range is split in halves until the chunks are small enough for every worker to get a few, so thieves take the largest
+		///		ranges left and split them further themselves.
+		/// </summary>
+		/// <param name="count">Number of elements</param>
+		/// <param name="function">Function called with each chunk's range, as (first, last) with last excluded</param>
+		/// <param name="minChunk">Minimum number of elements per chunk (raise it when elements are cheap)</param>
+		template <typename TFunction>
+		void ParallelFor(size_t count, const TFunction& function, size_t minChunk = 1)
+		{
+			if (count == 0)
+				return;
+
+			auto chunk = std::max<size_t>(std::max<size_t>(minChunk, 1), (count + m_workers.size() * 4 - 1) / (m_workers.size() * 4));
+			if (count <= chunk)
+			{
+				function((size_t)0, count);
+				return;
+			}
+
+			JobCounter counter;
+			ParallelForRange<TFunction> range { this, &function, &counter, chunk };
+			range.Split(0, count);
+			this->Wait(counter);
+		}
+
+		/// <summary>
+		///		Gets the number of workers, including the thread which created the job system
+		/// </summary>
+		inline size_t GetWorkerCount() const { return m_workers.size(); }
+
+		/// <summary>
+		///		Gets the index of the calling worker in this job system (0 for the creating thread, -1 if the caller isn't a worker)
+		/// </summary>
+		int GetWorkerIndex() const;
+
+	private:
+		struct Job
+		{
+			Function function;
+			JobCounter* counter;
+			Job* next;
+			std::atomic<bool> free;
+		};
+
+		struct Worker;
+
+		struct WorkerFiber
+		{
+			std::unique_ptr<Fiber> fiber;
+			JobSystem* system;
+			Worker* worker;
+			WorkerFiber* next;
+		};
+
+		// What the fiber switched to does with the fiber switched from, once it can't run anymore
+		enum class SwitchAction
+		{
+			Invalid = -1,
+
+			None,
+			Free,
+			Suspend,
+
+			Count
+		};
+
+		struct Worker
+		{
+			Worker(size_t jobCount, size_t resumedCount) : deque(jobCount), jobs(new Job[jobCount]), jobCount(jobCount), nextJob(0), random(0), resumed(resumedCount) { }
+
+			WorkStealingDeque<Job> deque;
+			std::unique_ptr<Job[]> jobs;
+			size_t jobCount;
+			size_t nextJob;
+			uint32_t random;
+			std::thread thread;
+
+			// Fibers are owned by a worker and never migrate, so thread locals stay valid across switches
+			std::vector<std::unique_ptr<WorkerFiber>> fibers;
+			std::vector<WorkerFiber*> freeFibers;
+			MPSCQueue<WorkerFiber*> resumed;
+			std::unique_ptr<WorkerFiber> threadFiber;
+			WorkerFiber* currentFiber;
+			WorkerFiber* previousFiber;
+			SwitchAction previousAction;
+			JobCounter* previousCounter;
+		};
+
+		template <typename TFunction>
+		struct ParallelForRange
+		{
+			JobSystem* system;
+			const TFunction* function;
+			JobCounter* counter;
+			size_t chunk;
+
+			void Split(size_t first, size_t last) const
+			{
+				while (last - first > chunk)
+				{
+					auto middle = first + (last - first) / 2;
+					auto range = this;
+					system->Run([range, middle, last]() { range->Split(middle, last); }, counter);
+					last = middle;
+				}
+				(*function)(first, last);
+			}
+		};
+
+		static void FiberMain(void* argument);
+
+		Worker* GetCurrentWorker() const;
+		void CreateThreadFiber(Worker& worker);
+		Job* Allocate(Worker& worker);
+		void Push(Worker& worker, Job* job);
+		bool TryRunJob(Worker& worker);
+		void Execute(Job* job);
+		void Finish(JobCounter* counter);
+		void Resume(WorkerFiber* fiber);
+		bool ResumeFiber(Worker& worker);
+		void SwitchFiber(Worker& worker, WorkerFiber* fiber, SwitchAction action, JobCounter* counter);
+		void FinishSwitch(Worker& worker);
+		void RunWorker(Worker& worker);
+		void WorkerMain(size_t index);
+
+		std::vector<std::unique_ptr<Worker>> m_workers;
+
+		// Number of jobs in the deques and fibers waiting to be resumed, and number of workers sleeping until it isn't zero
+		std::atomic<size_t> m_queuedJobs;
+		std::atomic<size_t> m_sleepingWorkers;
+		std::atomic<bool> m_stopping;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_sleepCondition;
+	};
+}
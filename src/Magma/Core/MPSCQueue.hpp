@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+namespace Magma
+{
+	/// <summary>
+	///		Bounded lock-free multiple producer single consumer queue (Dmitry Vyukov's bounded queue, with a single consumer).
+	///		Producers reserve a slot with a compare and swap on the tail and publish it through the slot's sequence number,
+	///		the consumer never needs atomic read-modify-writes.
+	/// </summary>
+	template <typename T>
+	class MPSCQueue final
+	{
+	public:
+		/// <summary>
+		///		Creates a new queue
+		/// </summary>
+		/// <param name="capacity">Maximum number of values in the queue (power of two)</param>
+		MPSCQueue(size_t capacity)
+		{
+			if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+				throw std::runtime_error("Failed to create MPSCQueue: capacity must be a power of two");
+
+			m_capacity = capacity;
+			m_cells.reset(new Cell[capacity]);
+			for (size_t i = 0; i < capacity; ++i)
+				m_cells[i].sequence.store(i, std::memory_order_relaxed);
+			m_tail.store(0, std::memory_order_relaxed);
+			m_head = 0;
+		}
+
+		MPSCQueue(const MPSCQueue&) = delete;
+		MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+		/// <summary>
+		///		Pushes a value (can be called from any thread)
+		/// </summary>
+		/// <returns>False if the queue is full</returns>
+		bool TryPush(T value)
+		{
+			Cell* cell;
+			auto position = m_tail.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				cell = &m_cells[position & (m_capacity - 1)];
+				auto sequence = cell->sequence.load(std::memory_order_acquire);
+				auto difference = (ptrdiff_t)sequence - (ptrdiff_t)position;
+				if (difference == 0)
+				{
+					if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+					return false;
+				else position = m_tail.load(std::memory_order_relaxed);
+			}
+
+			cell->value = std::move(value);
+			cell->sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary>
+		///		Pops a value (must only be called from the consumer thread)
+		/// </summary>
+		/// <returns>False if the queue is empty</returns>
+		bool TryPop(T& value)
+		{
+			auto& cell = m_cells[m_head & (m_capacity - 1)];
+			if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+				return false;
+
+			value = std::move(cell.value);
+			cell.value = T();
+			cell.sequence.store(m_head + m_capacity, std::memory_order_release);
+			++m_head;
+			return true;
+		}
+
+		/// <summary>
+		///		Pops every value pushed before the call and passes them to a function (must only be called from the consumer thread).
+		///		Values pushed while draining, including by the function itself, are left for the next drain.
+		/// </summary>
+		/// <returns>Number of values drained</returns>
+		template <typename TFunction>
+		size_t Drain(TFunction&& function)
+		{
+			auto end = m_tail.load(std::memory_order_acquire);
+			size_t count = 0;
+			T value;
+			while (m_head != end && this->TryPop(value))
+			{
+				function(value);
+				++count;
+			}
+			return count;
+		}
+
+		/// <summary>
+		///		Gets the queue capacity
+		/// </summary>
+		inline size_t GetCapacity() const { return m_capacity; }
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			T value;
+		};
+
+		// The tail is written by every producer, so it is kept on its own cache line, away from the consumer's head
+		alignas(64) std::atomic<size_t> m_tail;
+		alignas(64) size_t m_head;
+		size_t m_capacity;
+		std::unique_ptr<Cell[]> m_cells;
+	};
+}
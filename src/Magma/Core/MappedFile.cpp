@@ -0,0 +1,89 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+Magma::MappedFile::MappedFile(const std::string & path)
+{
+	m_data = nullptr;
+	m_size = 0;
+
+#ifdef _WIN32
+	m_mapping = nullptr;
+	m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("Failed to map file '" + path + "': couldn't open file");
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size))
+	{
+		CloseHandle(m_file);
+		throw std::runtime_error("Failed to map file '" + path + "': couldn't get file size");
+	}
+	m_size = (size_t)size.QuadPart;
+
+	// Empty files can't be mapped
+	if (m_size == 0)
+		return;
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping != nullptr)
+		m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_data == nullptr)
+	{
+		if (m_mapping != nullptr)
+			CloseHandle(m_mapping);
+		CloseHandle(m_file);
+		throw std::runtime_error("Failed to map file '" + path + "': couldn't map file into memory");
+	}
+#else
+	m_file = open(path.c_str(), O_RDONLY);
+	if (m_file < 0)
+		throw std::runtime_error("Failed to map file '" + path + "': couldn't open file");
+
+	struct stat info;
+	if (fstat(m_file, &info) != 0)
+	{
+		close(m_file);
+		throw std::runtime_error("Failed to map file '" + path + "': couldn't get file size");
+	}
+	m_size = (size_t)info.st_size;
+
+	// Empty files can't be mapped
+	if (m_size == 0)
+		return;
+
+	auto data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+	if (data == MAP_FAILED)
+	{
+		close(m_file);
+		throw std::runtime_error("Failed to map file '" + path + "': couldn't map file into memory");
+	}
+	m_data = data;
+#endif
+}
+
+Magma::MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+	CloseHandle(m_file);
+#else
+	if (m_data != nullptr)
+		munmap((void*)m_data, m_size);
+	close(m_file);
+#endif
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+namespace Magma
+{
+	/// <summary>
+	///		Read only memory mapped file.
+	///		The operating system pages the contents in on demand, so data can be used straight from the file without being read or parsed.
+	/// </summary>
+	class MappedFile final
+	{
+	public:
+		/// <summary>
+		///		Maps a file into memory
+		/// </summary>
+		/// <param name="path">File path</param>
+		MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/// <summary>
+		///		Gets a pointer to the file contents
+		/// </summary>
+		inline const void* GetData() const { return m_data; }
+
+		/// <summary>
+		///		Gets the file size in bytes
+		/// </summary>
+		inline size_t GetSize() const { return m_size; }
+
+	private:
+		const void* m_data;
+		size_t m_size;
+
+#ifdef _WIN32
+		void* m_file;
+		void* m_mapping;
+#else
+		int m_file;
+#endif
+	};
+}
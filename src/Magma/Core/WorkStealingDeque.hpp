@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace Magma
+{
+	/// <summary>
+	///		Bounded lock-free work stealing deque of pointers (Chase-Lev deque, with the memory orderings of Le et al. 2013).
+	///		The owner thread pushes and pops at the bottom, like a stack, while any other thread can steal from the top.
+	///		The owner only contends with thieves for the last element.
+	/// </summary>
+	template <typename T>
+	class WorkStealingDeque final
+	{
+	public:
+		/// <summary>
+		///		Creates a new deque
+		/// </summary>
+		/// <param name="capacity">Maximum number of elements in the deque (power of two)</param>
+		WorkStealingDeque(size_t capacity)
+		{
+			if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+				throw std::runtime_error("Failed to create WorkStealingDeque: capacity must be a power of two");
+
+			m_capacity = (int64_t)capacity;
+			m_elements.reset(new std::atomic<T*>[capacity]);
+			for (size_t i = 0; i < capacity; ++i)
+				m_elements[i].store(nullptr, std::memory_order_relaxed);
+			m_top.store(0, std::memory_order_relaxed);
+			m_bottom.store(0, std::memory_order_relaxed);
+		}
+
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+		/// <summary>
+		///		Pushes an element at the bottom (must only be called from the owner thread)
+		/// </summary>
+		/// <returns>False if the deque is full</returns>
+		bool Push(T* element)
+		{
+			auto bottom = m_bottom.load(std::memory_order_relaxed);
+			auto top = m_top.load(std::memory_order_acquire);
+			if (bottom - top >= m_capacity)
+				return false;
+
+			m_elements[bottom & (m_capacity - 1)].store(element, std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary>
+		///		Pops the element at the bottom, the last one pushed (must only be called from the owner thread)
+		/// </summary>
+		/// <returns>Element, or nullptr if the deque is empty</returns>
+		T* Pop()
+		{
+			auto bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			auto top = m_top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			auto element = m_elements[bottom & (m_capacity - 1)].load(std::memory_order_relaxed);
+			if (top == bottom)
+			{
+				// Last element, race the thieves for it
+				if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					element = nullptr;
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return element;
+		}
+
+		/// <summary>
+		///		Steals the element at the top, the oldest one pushed (can be called from any thread)
+		/// </summary>
+		/// <returns>Element, or nullptr if the deque is empty or another thread took the element first</returns>
+		T* Steal()
+		{
+			auto top = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			auto bottom = m_bottom.load(std::memory_order_acquire);
+			if (top >= bottom)
+				return nullptr;
+
+			auto element = m_elements[top & (m_capacity - 1)].load(std::memory_order_relaxed);
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+			return element;
+		}
+
+		/// <summary>
+		///		Gets the approximate number of elements in the deque
+		/// </summary>
+		inline size_t GetSize() const
+		{
+			auto size = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+			return size > 0 ? (size_t)size : 0;
+		}
+
+		/// <summary>
+		///		Gets the deque capacity
+		/// </summary>
+		inline size_t GetCapacity() const { return (size_t)m_capacity; }
+
+	private:
+		// The top is written by thieves, so it is kept on its own cache line, away from the owner's bottom
+		alignas(64) std::atomic<int64_t> m_top;
+		alignas(64) std::atomic<int64_t> m_bottom;
+		int64_t m_capacity;
+		std::unique_ptr<std::atomic<T*>[]> m_elements;
+	};
+}
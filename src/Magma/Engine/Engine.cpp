@@ -1,13 +1,25 @@
 #include "Engine.hpp"
 
-#include "../Input/Window.hpp"
+#include "../Core/JobSystem.hpp"
+#include "../Input/WindowManager.hpp"
 #include "../Graphics/GLContext.hpp"
+#include "../Graphics/GPUProfiler.hpp"
+#include "../Graphics/RecordingContext.hpp"
+#include "../Graphics/FrameThrottle.hpp"
+#include "../Graphics/Mesh.hpp"
+#include "../Graphics/RenderGraph.hpp"
+#include "../Graphics/SceneRenderer.hpp"
 #include "../Graphics/TerminalRenderer.hpp"
 #include "../Graphics/TextRenderer.hpp"
+#include "../Graphics/TextureStreamer.hpp"
+#include "../Scene/TransformSystem.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <chrono>
 #include <fstream>
+#include <string>
+#include <vector>
 
 using namespace Magma;
 
@@ -15,12 +27,92 @@ int main(int argc, char** argv)
 {
 	Engine engine;
 
-	auto window = Input::Window(1400, 800, "Window");
+	// Command line options:
+	//	--headless			Renders offscreen without a visible window (no input, no display server or GPU needed)
+	//	--frames=N			Stops after rendering N frames and prints frame timings
+	//	--screenshot=PATH	Writes the last frame rendered into a binary PPM image (for image diff tests)
+	//	--stats				Counts the context calls made each frame and prints the last frame's counters on exit
+	//	--trace=PATH		Writes every context call made into a binary trace file (implies --stats)
+	//	--record-input=PATH	Writes the window's input events into a binary log
+	//	--replay-input=PATH	Plays an input log in place of the window's input, and stops when it ends (for repeatable benchmark runs)
+	//	--vsync=MODE		Sets vertical synchronization (off, on or adaptive)
+	//	--fps-limit=N		Limits the frame rate to N frames per second
+	//	--mesh=PATH			Draws a grid of instances of a cooked mesh through the scene renderer (culled, with a level of detail chosen per instance)
+	bool headless = false;
+	bool stats = false;
+	size_t frameLimit = 0;
+	std::string screenshotPath;
+	std::string tracePath;
+	std::string recordInputPath;
+	std::string replayInputPath;
+	std::string vsync;
+	double fpsLimit = 0.0;
+	std::string meshPath;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--headless")
+			headless = true;
+		else if (arg.compare(0, 9, "--frames=") == 0)
+			frameLimit = std::stoul(arg.substr(9));
+		else if (arg.compare(0, 13, "--screenshot=") == 0)
+			screenshotPath = arg.substr(13);
+		else if (arg == "--stats")
+			stats = true;
+		else if (arg.compare(0, 8, "--trace=") == 0)
+		{
+			stats = true;
+			tracePath = arg.substr(8);
+		}
+		else if (arg.compare(0, 15, "--record-input=") == 0)
+			recordInputPath = arg.substr(15);
+		else if (arg.compare(0, 15, "--replay-input=") == 0)
+			replayInputPath = arg.substr(15);
+		else if (arg.compare(0, 8, "--vsync=") == 0)
+			vsync = arg.substr(8);
+		else if (arg.compare(0, 12, "--fps-limit=") == 0)
+			fpsLimit = std::stod(arg.substr(12));
+		else if (arg.compare(0, 7, "--mesh=") == 0)
+			meshPath = arg.substr(7);
+	}
+
+	Input::WindowManager windowManager;
+	auto& window = windowManager.OpenWindow(1400, 800, "Window", headless ? Input::WindowMode::Headless : Input::WindowMode::Windowed);
 	auto running = true;
+	size_t frameCount = 0, gpuSampleCount = 0;
+	uint64_t gpuResultsFrame = 0;
+	double cpuMilliseconds = 0.0, gpuMilliseconds = 0.0;
 
 	window.OnClose.AddListener([&]() { running = false; });
+	if (vsync == "off")
+		window.SetVSync(Input::VSyncMode::Off);
+	else if (vsync == "on")
+		window.SetVSync(Input::VSyncMode::On);
+	else if (vsync == "adaptive")
+		window.SetVSync(Input::VSyncMode::Adaptive);
+	window.GetFramePacer().SetFrameRateLimit(fpsLimit);
+	if (!recordInputPath.empty())
+		window.StartInputRecording(recordInputPath);
+	if (!replayInputPath.empty())
+		window.StartInputReplay(replayInputPath);
+
+	Graphics::GLContext* glContext = new Graphics::GLContext();
+	Graphics::RecordingContext* recordingContext = nullptr;
+	Graphics::Context* context = glContext;
+	if (stats)
+	{
+		recordingContext = new Graphics::RecordingContext(*glContext);
+		if (!tracePath.empty())
+			recordingContext->StartTrace(tracePath);
+		context = recordingContext;
+	}
 
-	Graphics::Context* context = new Graphics::GLContext();
+	Graphics::TextureStreamer* textureStreamer = new Graphics::TextureStreamer(*context, 32 * 1024 * 1024, 4 * 1024 * 1024);
+	Graphics::GPUProfiler* gpuProfiler = new Graphics::GPUProfiler(*context);
+	Graphics::FrameThrottle* frameThrottle = new Graphics::FrameThrottle(*context, 2);
+	Graphics::RenderTargetPool* renderTargetPool = new Graphics::RenderTargetPool(*context);
+	Graphics::RenderGraph* renderGraph = new Graphics::RenderGraph(*context, *renderTargetPool);
+	renderGraph->SetProfiler(gpuProfiler);
 	//Graphics::TerminalRenderer* renderer = new Graphics::TerminalRenderer(*context);
 
 	/*window.OnKeyDown.AddListener([&](auto key, auto mods)
@@ -30,12 +122,30 @@ int main(int argc, char** argv)
 
 	renderer->RenderInput("test");*/
 
-	Graphics::TextRenderer* consolasTextRenderer = new Graphics::TextRenderer(*context);
-	Graphics::TextRenderer* otherTextRenderer = new Graphics::TextRenderer(*context);
+	// Text renderers use the build's render context type, which calls the GL context directly on static dispatch builds,
+	// so while context calls are recorded they go through the Context interface instead, for the recording context to see their draws
+	Graphics::BasicTextRenderer<Graphics::Context>* recordedTextRenderers[2] = { nullptr, nullptr };
+	Graphics::TextRenderer* textRenderers[2] = { nullptr, nullptr };
+	auto loadText = [](auto& renderers)
+	{
+		renderers[0]->Load("../../../../resources/Consolas.ttf", 80);
+		renderers[1]->Load("../../../../resources/Pacific Again.ttf", 60);
+	};
+
 	try
 	{
-		consolasTextRenderer->Load("../../../../resources/Consolas.ttf", 80);
-		otherTextRenderer->Load("../../../../resources/Pacific Again.ttf", 60);
+		if (recordingContext != nullptr)
+		{
+			recordedTextRenderers[0] = new Graphics::BasicTextRenderer<Graphics::Context>(*context);
+			recordedTextRenderers[1] = new Graphics::BasicTextRenderer<Graphics::Context>(*context);
+			loadText(recordedTextRenderers);
+		}
+		else
+		{
+			textRenderers[0] = new Graphics::TextRenderer(*glContext);
+			textRenderers[1] = new Graphics::TextRenderer(*glContext);
+			loadText(textRenderers);
+		}
 	}
 	catch (std::runtime_error& err)
 	{
@@ -44,6 +154,13 @@ int main(int argc, char** argv)
 		return -1;
 	}
 
+	JobSystem* jobSystem = new JobSystem();
+	Scene::TransformSystem* transforms = new Scene::TransformSystem();
+	auto consolasTextTransform = transforms->Create();
+	auto otherTextTransform = transforms->Create();
+	transforms->SetLocalPosition(consolasTextTransform, glm::vec3(0.0f, 400.0f, 0.0f));
+	transforms->SetLocalPosition(otherTextTransform, glm::vec3(900.0f, 200.0f, 0.0f));
+
 	auto program = context->CreateProgram();
 
 	{
@@ -96,36 +213,266 @@ int main(int argc, char** argv)
 		context->SetVertexAttributePointer(vao, vbo, 0, 3, Graphics::AttributeType::Float, false, 0, nullptr);
 	}
 
+	// Mesh instances are laid out on a grid in front of the camera, wide enough for some of them to be outside of the frustum
+	// and deep enough for the far ones to use coarser levels of detail
+	const float sceneFov = glm::radians(60.0f);
+	Graphics::Mesh* mesh = nullptr;
+	Graphics::SceneRenderer* sceneRenderer = nullptr;
+	Graphics::RenderFrame sceneFrame;
+	if (!meshPath.empty())
+	{
+		try
+		{
+			mesh = new Graphics::Mesh(*context, meshPath);
+		}
+		catch (std::runtime_error& err)
+		{
+			fprintf(stderr, "Caught runtime error exception while trying to load mesh:\n%s", err.what());
+			return -1;
+		}
+
+		auto meshProgram = context->CreateProgram();
+
+		{
+			auto shader = context->CreateShader(Graphics::ShaderType::Vertex, R"glsl(
+			#version 430 core
+
+			layout (location = 0) in vec3 vertexPosition;
+			layout (location = 1) in vec4 vertexNormal;
+
+			layout (location = 0) uniform mat4 mvp;
+			layout (location = 1) uniform vec3 positionOffset;
+			layout (location = 2) uniform vec3 positionScale;
+
+			out vec3 normal;
+
+			void main()
+			{
+				normal = vertexNormal.xyz;
+				gl_Position = mvp * vec4(positionOffset + vertexPosition * positionScale, 1.0);
+			}
+			)glsl");
+
+			context->AttachShader(meshProgram, shader);
+		}
+
+		{
+			auto shader = context->CreateShader(Graphics::ShaderType::Fragment, R"glsl(
+			#version 430 core
+
+			in vec3 normal;
+
+			out vec4 fragColor;
+
+			void main()
+			{
+				float light = max(dot(normalize(normal), normalize(vec3(0.3, 1.0, 0.5))), 0.0);
+				fragColor = vec4(vec3(0.2 + 0.8 * light), 1.0);
+			}
+			)glsl");
+
+			context->AttachShader(meshProgram, shader);
+		}
+
+		context->LinkProgram(meshProgram);
+
+		// Positions are quantized relative to the mesh bounds, which are the same for every instance
+		context->ActivateProgram(meshProgram);
+		context->SetUniform3f(1, mesh->GetPositionOffset());
+		context->SetUniform3f(2, mesh->GetPositionScale());
+		context->DeactivateProgram(meshProgram);
+
+		sceneRenderer = new Graphics::SceneRenderer(*context);
+		sceneRenderer->GetLodStage().SetProjection((float)window.GetHeight(), sceneFov);
+
+		auto& lods = mesh->GetLods();
+		auto extents = mesh->GetPositionScale() * 0.5f;
+		auto spacing = glm::length(mesh->GetPositionScale()) * 1.5f;
+		for (int z = 0; z < 32; ++z)
+			for (int x = -16; x < 16; ++x)
+			{
+				Graphics::RenderItem item = {};
+				item.program = meshProgram;
+				item.vao = mesh->GetVertexArray();
+				item.mode = Graphics::DrawMode::Triangles;
+				item.indexType = mesh->GetIndexType();
+				item.first = lods[0].first;
+				item.count = lods[0].count;
+				item.lods = lods.data();
+				item.lodCount = lods.size();
+				item.lod = 0;
+				item.transform = glm::translate(glm::mat4(1.0f), glm::vec3(x * spacing, 0.0f, -z * spacing));
+				item.boundsCenter = glm::vec3(item.transform * glm::vec4(mesh->GetPositionOffset() + extents, 1.0f));
+				item.boundsExtents = extents;
+				item.occluder = false;
+				sceneFrame.items.push_back(item);
+			}
+
+		sceneFrame.cameraPosition = glm::vec3(0.0f, spacing, spacing * 2.0f);
+		sceneFrame.viewProjection = glm::perspective(sceneFov, (float)window.GetWidth() / window.GetHeight(), spacing * 0.05f, spacing * 64.0f) *
+									glm::lookAt(sceneFrame.cameraPosition, glm::vec3(0.0f, 0.0f, -spacing * 8.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+
 	while (running)
 	{
-		window.PollEvents();
+		auto frameStart = std::chrono::high_resolution_clock::now();
 
-		context->Clear(Graphics::BufferBit::Color);
+		if (recordingContext != nullptr)
+			recordingContext->BeginFrame();
+		// Throttle before polling, so the input used by the frame is sampled after waiting for the GPU instead of before
+		frameThrottle->BeginFrame();
+		windowManager.PollEvents();
+		gpuProfiler->BeginFrame();
 
-		glm::mat4 proj = glm::ortho(0.0f, 1400.0f, 0.0f, 800.0f);
-		
+		{
+			Graphics::GPUTimerScope timer(*gpuProfiler, "Texture Streaming");
+			textureStreamer->Update();
+		}
+
+		// Transforms on a level only depend on the previous levels, so each level is split between the workers
+		transforms->BeginUpdate();
+		for (size_t level = 0; level < transforms->GetLevelCount(); ++level)
+			jobSystem->ParallelFor(transforms->GetLevelSize(level), [&](size_t first, size_t last)
+			{
+				transforms->UpdateLevel(level, first, last - first);
+			}, 1024);
+		transforms->EndUpdate();
 
-		context->ActivateProgram(program);
-		context->SetUniform4x4f(0, proj);
-		context->DrawVertexArray(vao, Graphics::DrawMode::Triangles, 0, 3);
-		context->DeactivateProgram(program);
+		glm::mat4 proj = glm::ortho(0.0f, 1400.0f, 0.0f, 800.0f);
 
-		glm::mat4 transform = glm::mat4(1.0f);
-		transform *= proj;
+		// Headless windows have no default framebuffer, so render into an offscreen target instead
+		const Graphics::RenderTarget* offscreen = nullptr;
+		int backbuffer;
+		if (window.IsHeadless())
+		{
+			Graphics::RenderTargetDesc desc;
+			desc.width = window.GetWidth();
+			desc.height = window.GetHeight();
+			offscreen = renderTargetPool->Acquire(desc);
+			backbuffer = renderGraph->ImportTarget("Backbuffer", *offscreen);
+		}
+		else backbuffer = renderGraph->ImportBackbuffer("Backbuffer", window.GetWidth(), window.GetHeight());
 
-		consolasTextRenderer->Render("/test -f test.txt", glm::translate(proj, glm::vec3(0.0f, 400.0f, 0.0f)), glm::vec3(1.0f, 1.0f, 1.0f));
+		renderGraph->AddPass("Triangle", [&](Graphics::RenderPassBuilder& builder)
+		{
+			builder.WriteTarget(backbuffer, Graphics::BufferBit::Color);
+		}, [&](Graphics::Context& context, const Graphics::RenderPassResources& resources)
+		{
+			context.ActivateProgram(program);
+			context.SetUniform4x4f(0, proj);
+			context.DrawVertexArray(vao, Graphics::DrawMode::Triangles, 0, 3);
+			context.DeactivateProgram(program);
+		});
+
+		if (sceneRenderer != nullptr)
+			renderGraph->AddPass("Scene", [&](Graphics::RenderPassBuilder& builder)
+			{
+				builder.WriteTarget(backbuffer, Graphics::BufferBit::Color);
+			}, [&](Graphics::Context& context, const Graphics::RenderPassResources& resources)
+			{
+				sceneRenderer->Render(&sceneFrame);
+			});
+
+		renderGraph->AddPass("Text", [&](Graphics::RenderPassBuilder& builder)
+		{
+			builder.WriteTarget(backbuffer, Graphics::BufferBit::Color);
+		}, [&](Graphics::Context& context, const Graphics::RenderPassResources& resources)
+		{
+			auto renderText = [&](auto& renderers)
+			{
+				renderers[0]->Render("/test -f test.txt", proj * transforms->GetWorldMatrix(consolasTextTransform), glm::vec3(1.0f, 1.0f, 1.0f));
+				renderers[1]->Render("Sample Text", proj * transforms->GetWorldMatrix(otherTextTransform), glm::vec3(0.0f, 1.0f, 1.0f));
+			};
+
+			if (recordingContext != nullptr)
+				renderText(recordedTextRenderers);
+			else renderText(textRenderers);
+		});
+
+		renderGraph->Execute();
+
+		++frameCount;
+		if (frameLimit != 0 && frameCount == frameLimit)
+			running = false;
+		if (window.IsInputReplayFinished())
+			running = false;
+
+		if (!running && !screenshotPath.empty())
+		{
+			std::vector<unsigned char> pixels(window.GetWidth() * window.GetHeight() * 3);
+			context->BindFramebuffer(Graphics::FramebufferTarget::Read, offscreen != nullptr ? offscreen->framebuffer : 0);
+			context->ReadPixels(0, 0, window.GetWidth(), window.GetHeight(), Graphics::PixelFormat::RGB, Graphics::PixelType::UByte, pixels.data());
+			context->BindFramebuffer(Graphics::FramebufferTarget::Read, 0);
+
+			// Rows are read bottom to top, PPM stores them top to bottom
+			std::ofstream ppm(screenshotPath, std::ios::binary);
+			ppm << "P6\n" << window.GetWidth() << " " << window.GetHeight() << "\n255\n";
+			for (size_t y = window.GetHeight(); y > 0; --y)
+				ppm.write((const char*)&pixels[(y - 1) * window.GetWidth() * 3], window.GetWidth() * 3);
+		}
 
-		otherTextRenderer->Render("Sample Text", glm::translate(proj, glm::vec3(900.0f, 200.0f, 0.0f)), glm::vec3(0.0f, 1.0f, 1.0f));
+		renderTargetPool->EndFrame();
 
+		gpuProfiler->EndFrame();
 		window.SwapBuffers();
+		frameThrottle->EndFrame();
+		if (recordingContext != nullptr)
+			recordingContext->EndFrame();
+
+		cpuMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
+		// GPU times are read back a few frames late and not every frame, so only new results are sampled
+		if (gpuProfiler->GetResultsFrame() != gpuResultsFrame)
+		{
+			gpuResultsFrame = gpuProfiler->GetResultsFrame();
+			gpuMilliseconds += gpuProfiler->GetFrameMilliseconds();
+			++gpuSampleCount;
+		}
+	}
+
+	if (frameLimit != 0)
+	{
+		printf("Rendered %zu frames: %.3f ms CPU, %.3f ms GPU per frame on average\n", frameCount, cpuMilliseconds / frameCount, gpuSampleCount != 0 ? gpuMilliseconds / gpuSampleCount : 0.0);
+		printf("Present to present: %.3f ms smoothed, %.3f ms jitter\n", window.GetFramePacer().GetSmoothedFrameMilliseconds(), window.GetFramePacer().GetJitterMilliseconds());
+		if (sceneRenderer != nullptr)
+		{
+			auto& culling = sceneRenderer->GetCullingStage();
+			auto& lod = sceneRenderer->GetLodStage();
+			printf("Scene: %zu of %zu items visible (%zu outside the frustum, %zu occluded), %zu of %zu indices drawn after LOD selection\n",
+				   sceneFrame.visibleItems.size(), sceneFrame.items.size(), culling.GetFrustumCulledCount(), culling.GetOcclusionCulledCount(),
+				   lod.GetDrawnCount(), lod.GetFullDetailCount());
+		}
+	}
+
+	if (recordingContext != nullptr)
+	{
+		auto& frameStatistics = recordingContext->GetFrameStatistics();
+		printf("Last frame: %zu draw calls, %zu vertices, %zu program switches, %zu texture binds, %zu uniform uploads, %zu framebuffer binds, %zu buffer bytes, %zu texture bytes\n",
+			   frameStatistics.drawCalls, frameStatistics.vertices, frameStatistics.programSwitches, frameStatistics.textureBinds,
+			   frameStatistics.uniformUploads, frameStatistics.framebufferBinds, frameStatistics.bufferBytes, frameStatistics.textureBytes);
+		for (size_t i = 0; i < (size_t)Graphics::ContextCall::Count; ++i)
+			if (frameStatistics.calls[i] != 0)
+				printf("\t%s: %zu\n", Graphics::GetContextCallName((Graphics::ContextCall)i), frameStatistics.calls[i]);
 	}
 
 	Init(engine);
 
-	delete consolasTextRenderer;
-	delete otherTextRenderer;
+	for (size_t i = 0; i < 2; ++i)
+	{
+		delete recordedTextRenderers[i];
+		delete textRenderers[i];
+	}
 	//delete renderer;
-	delete context;
+	delete sceneRenderer;
+	delete mesh;
+	delete renderGraph;
+	delete renderTargetPool;
+	delete frameThrottle;
+	delete gpuProfiler;
+	delete textureStreamer;
+	delete transforms;
+	delete jobSystem;
+	delete recordingContext;
+	delete glContext;
 }
 
 Magma::Engine::Engine()
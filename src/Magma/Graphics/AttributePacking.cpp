@@ -0,0 +1,114 @@
+#include "AttributePacking.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+uint8_t Magma::Graphics::PackUnorm8(float value)
+{
+	return (uint8_t)std::round(std::min(std::max(value, 0.0f), 1.0f) * 255.0f);
+}
+
+int8_t Magma::Graphics::PackSnorm8(float value)
+{
+	return (int8_t)std::round(std::min(std::max(value, -1.0f), 1.0f) * 127.0f);
+}
+
+uint16_t Magma::Graphics::PackUnorm16(float value)
+{
+	return (uint16_t)std::round(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f);
+}
+
+int16_t Magma::Graphics::PackSnorm16(float value)
+{
+	return (int16_t)std::round(std::min(std::max(value, -1.0f), 1.0f) * 32767.0f);
+}
+
+uint16_t Magma::Graphics::PackHalf(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	uint16_t sign = (bits >> 16) & 0x8000;
+	uint32_t exponent = (bits >> 23) & 0xFF;
+	uint32_t mantissa = bits & 0x7FFFFF;
+
+	// NaN and infinity
+	if (exponent == 0xFF)
+		return sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0);
+
+	int halfExponent = (int)exponent - 127 + 15;
+	if (halfExponent >= 31)
+		return sign | 0x7C00;
+
+	if (halfExponent <= 0)
+	{
+		// Too small even for a denormal
+		if (halfExponent < -10)
+			return sign;
+
+		// Denormal: shift the mantissa (with its implicit leading one) into place, rounding to nearest even
+		mantissa |= 0x800000;
+		auto shift = (uint32_t)(14 - halfExponent);
+		auto half = mantissa >> shift;
+		auto remainder = mantissa & ((1u << shift) - 1);
+		auto halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1) != 0))
+			++half;
+		return sign | (uint16_t)half;
+	}
+
+	// Normal: round the mantissa to nearest even, a carry correctly bumps the exponent (up to infinity)
+	uint32_t half = ((uint32_t)halfExponent << 10) | (mantissa >> 13);
+	auto remainder = mantissa & 0x1FFF;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0))
+		++half;
+	return sign | (uint16_t)half;
+}
+
+float Magma::Graphics::UnpackHalf(uint16_t value)
+{
+	uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+	uint32_t exponent = (value >> 10) & 0x1F;
+	uint32_t mantissa = value & 0x3FF;
+
+	uint32_t bits;
+	if (exponent == 0x1F)
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	else if (exponent != 0)
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	else if (mantissa != 0)
+	{
+		// Denormal: normalize the mantissa
+		exponent = 127 - 15 + 1;
+		while ((mantissa & 0x400) == 0)
+		{
+			mantissa <<= 1;
+			--exponent;
+		}
+		bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+	}
+	else bits = sign;
+
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+uint32_t Magma::Graphics::PackSnorm2_10_10_10(const glm::vec4 & value)
+{
+	auto x = (int32_t)std::round(std::min(std::max(value.x, -1.0f), 1.0f) * 511.0f);
+	auto y = (int32_t)std::round(std::min(std::max(value.y, -1.0f), 1.0f) * 511.0f);
+	auto z = (int32_t)std::round(std::min(std::max(value.z, -1.0f), 1.0f) * 511.0f);
+	auto w = (int32_t)std::round(std::min(std::max(value.w, -1.0f), 1.0f));
+	return ((uint32_t)x & 0x3FF) | (((uint32_t)y & 0x3FF) << 10) | (((uint32_t)z & 0x3FF) << 20) | (((uint32_t)w & 0x3) << 30);
+}
+
+uint32_t Magma::Graphics::PackUnorm2_10_10_10(const glm::vec4 & value)
+{
+	auto x = (uint32_t)std::round(std::min(std::max(value.x, 0.0f), 1.0f) * 1023.0f);
+	auto y = (uint32_t)std::round(std::min(std::max(value.y, 0.0f), 1.0f) * 1023.0f);
+	auto z = (uint32_t)std::round(std::min(std::max(value.z, 0.0f), 1.0f) * 1023.0f);
+	auto w = (uint32_t)std::round(std::min(std::max(value.w, 0.0f), 1.0f) * 3.0f);
+	return x | (y << 10) | (z << 20) | (w << 30);
+}
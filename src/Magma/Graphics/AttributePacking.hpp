@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Packs a float into an 8 bit unsigned normalized integer (AttributeType::UByte, normalized)
+		/// </summary>
+		/// <param name="value">Value in [0, 1] (clamped)</param>
+		uint8_t PackUnorm8(float value);
+
+		/// <summary>
+		///		Packs a float into an 8 bit signed normalized integer (AttributeType::Byte, normalized)
+		/// </summary>
+		/// <param name="value">Value in [-1, 1] (clamped)</param>
+		int8_t PackSnorm8(float value);
+
+		/// <summary>
+		///		Packs a float into a 16 bit unsigned normalized integer (AttributeType::UShort, normalized)
+		/// </summary>
+		/// <param name="value">Value in [0, 1] (clamped)</param>
+		uint16_t PackUnorm16(float value);
+
+		/// <summary>
+		///		Packs a float into a 16 bit signed normalized integer (AttributeType::Short, normalized)
+		/// </summary>
+		/// <param name="value">Value in [-1, 1] (clamped)</param>
+		int16_t PackSnorm16(float value);
+
+		/// <summary>
+		///		Converts a float into a half precision float (AttributeType::Half), rounding to the nearest value.
+		///		Values too large for half floats become infinities.
+		/// </summary>
+		uint16_t PackHalf(float value);
+
+		/// <summary>
+		///		Converts a half precision float back into a float
+		/// </summary>
+		float UnpackHalf(uint16_t value);
+
+		/// <summary>
+		///		Packs a vector into signed normalized 10 bit x, y, z and 2 bit w components (AttributeType::Int2_10_10_10, normalized).
+		///		Ideal for normals and tangents (w holds the bitangent sign).
+		/// </summary>
+		/// <param name="value">Components in [-1, 1] (clamped)</param>
+		uint32_t PackSnorm2_10_10_10(const glm::vec4& value);
+
+		/// <summary>
+		///		Packs a vector into unsigned normalized 10 bit x, y, z and 2 bit w components (AttributeType::UInt2_10_10_10, normalized)
+		/// </summary>
+		/// <param name="value">Components in [0, 1] (clamped)</param>
+		uint32_t PackUnorm2_10_10_10(const glm::vec4& value);
+	}
+}
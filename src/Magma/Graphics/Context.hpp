@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstdint>
 
 namespace Magma
 {
@@ -28,6 +29,13 @@ namespace Magma
 
 			Int,
 			Float,
+			UByte,
+			Byte,
+			UShort,
+			Short,
+			Half,
+			Int2_10_10_10,
+			UInt2_10_10_10,
 
 			Count
 		};
@@ -50,6 +58,19 @@ namespace Magma
 			Count
 		};
 
+		/// <summary>
+		///		Index buffer element types
+		/// </summary>
+		enum class IndexType
+		{
+			Invalid = -1,
+
+			UShort,
+			UInt,
+
+			Count
+		};
+
 		/// <summary>
 		///		Pixel data format
 		/// </summary>
@@ -168,6 +189,64 @@ namespace Magma
 		inline FramebufferTarget operator|(FramebufferTarget l, FramebufferTarget r) { return (FramebufferTarget)((int)l | (int)r); }
 		inline FramebufferTarget operator&(FramebufferTarget l, FramebufferTarget r) { return (FramebufferTarget)((int)l & (int)r); }
 
+		/// <summary>
+		///		Memory barrier bits (each bit orders incoherent shader writes before a kind of read)
+		/// </summary>
+		enum class BarrierBit
+		{
+			None            = 0x00,
+			VertexAttribute = 0x01,
+			Uniform         = 0x02,
+			TextureFetch    = 0x04,
+			ShaderStorage   = 0x08,
+			Framebuffer     = 0x10,
+			TextureUpdate   = 0x20,
+			BufferUpdate    = 0x40,
+			PixelBuffer     = 0x80,
+			All             = 0xFF,
+		};
+		inline BarrierBit operator|(BarrierBit l, BarrierBit r) { return (BarrierBit)((int)l | (int)r); }
+		inline BarrierBit operator&(BarrierBit l, BarrierBit r) { return (BarrierBit)((int)l & (int)r); }
+		inline BarrierBit& operator|=(BarrierBit& l, BarrierBit r) { return l = (l | r); }
+
+		/// <summary>
+		///		Sized internal formats for texture storage and renderbuffers
+		/// </summary>
+		enum class TargetFormat
+		{
+			Invalid = -1,
+
+			R8,
+			RG8,
+			RGBA8,
+			R16F,
+			RG16F,
+			RGBA16F,
+			R32F,
+			RG32F,
+			RGBA32F,
+
+			Depth16,
+			Depth24,
+			Depth32F,
+			Depth24Stencil8,
+
+			Count
+		};
+
+		/// <summary>
+		///		Fence wait results
+		/// </summary>
+		enum class FenceStatus
+		{
+			Invalid = -1,
+
+			Signaled,
+			TimeoutExpired,
+
+			Count
+		};
+
 		/// <summary>
 		///		Rendering context (provides a layer of abstraction between the low level rendering calls and the Renderer)
 		/// </summary>
@@ -262,8 +341,8 @@ namespace Magma
 			/// <param name="vao">Vertex array object</param>
 			/// <param name="vbo">Vertex buffer object</param>
 			/// <param name="index">Vertex attribute index</param>
-			/// <param name="size">Vertex attribute size</param>
-			/// <param name="type">Vertex attribute type</param>
+			/// <param name="size">Vertex attribute size (must be 4 for the packed 2_10_10_10 types)</param>
+			/// <param name="type">Vertex attribute type (Int attributes are read as integers, the other types are converted to floats)</param>
 			/// <param name="normalized">Is the data in the buffer normalized?</param>
 			/// <param name="stride">Vertex attribute data stride</param>
 			/// <param name="offset">Vertex attribute data offset</param>
@@ -281,6 +360,21 @@ namespace Magma
 			/// <param name="vao">Vertex array object ID</param>
 			virtual void DestroyVertexArray(int vao) = 0;
 
+			/// <summary>
+			///		Creates a static index buffer
+			/// </summary>
+			/// <param name="vao">Vertex array object ID where the buffer will be attached (a vertex array has a single index buffer)</param>
+			/// <param name="data">Index buffer data</param>
+			/// <param name="size">Index buffer data size</param>
+			/// <returns>Index buffer object ID</returns>
+			virtual int CreateIndexBuffer(int vao, const void* data, size_t size) = 0;
+
+			/// <summary>
+			///		Destroys an index buffer object
+			/// </summary>
+			/// <param name="ibo">Index buffer object ID</param>
+			virtual void DestroyIndexBuffer(int ibo) = 0;
+
 			/// <summary>
 			///		Draws a vertex array
 			/// </summary>
@@ -290,6 +384,16 @@ namespace Magma
 			/// <param name="count">Vertex count</param>
 			virtual void DrawVertexArray(int vao, DrawMode mode, int first, size_t count) = 0;
 
+			/// <summary>
+			///		Draws a vertex array using its index buffer
+			/// </summary>
+			/// <param name="vao">Vertex array object ID</param>
+			/// <param name="mode">Draw mode</param>
+			/// <param name="type">Index type</param>
+			/// <param name="first">First index</param>
+			/// <param name="count">Index count</param>
+			virtual void DrawIndexedVertexArray(int vao, DrawMode mode, IndexType type, size_t first, size_t count) = 0;
+
 			/// <summary>
 			///		Activates a shader program
 			/// </summary>
@@ -467,6 +571,12 @@ namespace Magma
 			/// <returns>Framebuffer ID</returns>
 			virtual int CreateFramebuffer() = 0;
 
+			/// <summary>
+			///		Destroys a framebuffer
+			/// </summary>
+			/// <param name="framebuffer">Framebuffer ID</param>
+			virtual void DestroyFramebuffer(int framebuffer) = 0;
+
 			/// <summary>
 			///		Binds a framebuffer (sets it as active)
 			/// </summary>
@@ -483,6 +593,37 @@ namespace Magma
 			/// <param name="level">Texture LOD level</param>
 			virtual void FramebufferTexture2D(FramebufferTarget target, FramebufferAttachment attachment, int texture, int level) = 0;
 
+			/// <summary>
+			///		Attaches a renderbuffer to a framebuffer
+			/// </summary>
+			/// <param name="target">Framebuffer target (read, draw or both)</param>
+			/// <param name="attachment">Framebutter attachment point</param>
+			/// <param name="renderbuffer">Renderbuffer ID to attach</param>
+			virtual void FramebufferRenderbuffer(FramebufferTarget target, FramebufferAttachment attachment, int renderbuffer) = 0;
+
+			/// <summary>
+			///		Checks if the framebuffer bound to a target is complete (can be drawn to or read from)
+			/// </summary>
+			/// <param name="target">Framebuffer target (read, draw or both)</param>
+			/// <returns>True if the framebuffer is complete, otherwise false</returns>
+			virtual bool IsFramebufferComplete(FramebufferTarget target) = 0;
+
+			/// <summary>
+			///		Creates a renderbuffer (an image which can only be used as a framebuffer attachment)
+			/// </summary>
+			/// <param name="format">Renderbuffer format</param>
+			/// <param name="width">Renderbuffer width</param>
+			/// <param name="height">Renderbuffer height</param>
+			/// <param name="samples">Sample count (1 for no multisampling)</param>
+			/// <returns>Renderbuffer ID</returns>
+			virtual int CreateRenderbuffer(TargetFormat format, size_t width, size_t height, size_t samples) = 0;
+
+			/// <summary>
+			///		Destroys a renderbuffer
+			/// </summary>
+			/// <param name="renderbuffer">Renderbuffer ID</param>
+			virtual void DestroyRenderbuffer(int renderbuffer) = 0;
+
 			/// <summary>
 			///		Sets the framebuffer attachments which will be drawn
 			/// </summary>
@@ -505,6 +646,18 @@ namespace Magma
 			/// <param name="filter">Filter to use</param>
 			virtual void BlitFramebuffer(int srcX0, int srcY0, int srcX1, int srcY1, int dstX0, int dstY0, int dstX1, int dstY1, BufferBit mask, Filter filter) = 0;
 
+			/// <summary>
+			///		Reads a block of pixels from the framebuffer bound to FramebufferTarget::Read
+			/// </summary>
+			/// <param name="x">Block left X coordinate</param>
+			/// <param name="y">Block lower Y coordinate</param>
+			/// <param name="width">Block width</param>
+			/// <param name="height">Block height</param>
+			/// <param name="format">Pixel data format written to the destination</param>
+			/// <param name="type">Pixel data type written to the destination</param>
+			/// <param name="data">Destination pointer</param>
+			virtual void ReadPixels(int x, int y, size_t width, size_t height, PixelFormat format, PixelType type, void* data) = 0;
+
 			/// <summary>
 			///		Creates an empty 2D texture
 			/// </summary>
@@ -543,6 +696,15 @@ namespace Magma
 			/// <param name="data">Data pointer</param>
 			virtual void TextureData2D(int level, PixelFormat internalFormat, size_t width, size_t height, PixelFormat format, PixelType type, void* data) = 0;
 
+			/// <summary>
+			///		Allocates immutable storage for the current active 2D texture (its data can then be set with TextureSubData2D)
+			/// </summary>
+			/// <param name="levels">Texture LOD level count</param>
+			/// <param name="format">Texture internal format</param>
+			/// <param name="width">Texture width</param>
+			/// <param name="height">Texture height</param>
+			virtual void TextureStorage2D(size_t levels, TargetFormat format, size_t width, size_t height) = 0;
+
 			/// <summary>
 			///		Sets the minifying filter used by the current active texture
 			/// </summary>
@@ -573,11 +735,117 @@ namespace Magma
 			/// <param name="mask">Buffer bit mask</param>
 			virtual void Clear(BufferBit mask) = 0;
 
+			/// <summary>
+			///		Inserts a memory barrier, making incoherent shader writes issued so far visible to the selected kinds of reads
+			/// </summary>
+			/// <param name="barriers">Barrier bit mask</param>
+			virtual void InsertBarrier(BarrierBit barriers) = 0;
+
 			/// <summary>
 			///		Sets the texture unpack alignment
 			/// </summary>
 			/// <param name="alignment">Unpack alignment</param>
 			virtual void SetUnpackAlignment(int alignment) = 0;
+
+			/// <summary>
+			///		Sets a region of the current active 2D texture data (the texture must already have storage for the level).
+			///		If a pixel buffer is bound, data is interpreted as a byte offset into that pixel buffer.
+			/// </summary>
+			/// <param name="level">Texture LOD level</param>
+			/// <param name="x">Region left X coordinate</param>
+			/// <param name="y">Region lower Y coordinate</param>
+			/// <param name="width">Region width</param>
+			/// <param name="height">Region height</param>
+			/// <param name="format">Texture data pixel format (the format used in the data sent to the function)</param>
+			/// <param name="type">Pixel data type used</param>
+			/// <param name="data">Data pointer (or pixel buffer offset)</param>
+			virtual void TextureSubData2D(int level, size_t x, size_t y, size_t width, size_t height, PixelFormat format, PixelType type, const void* data) = 0;
+
+			/// <summary>
+			///		Creates a pixel buffer which stays mapped into client memory for its whole lifetime
+			/// </summary>
+			/// <param name="size">Pixel buffer size in bytes</param>
+			/// <returns>Pixel buffer ID</returns>
+			virtual int CreatePixelBuffer(size_t size) = 0;
+
+			/// <summary>
+			///		Destroys a pixel buffer
+			/// </summary>
+			/// <param name="buffer">Pixel buffer ID</param>
+			virtual void DestroyPixelBuffer(int buffer) = 0;
+
+			/// <summary>
+			///		Gets the client memory pointer a pixel buffer is mapped to.
+			///		Writes through this pointer are visible to the context and may be done from any thread.
+			/// </summary>
+			/// <param name="buffer">Pixel buffer ID</param>
+			/// <returns>Mapped memory pointer</returns>
+			virtual void* GetPixelBufferPointer(int buffer) = 0;
+
+			/// <summary>
+			///		Binds a pixel buffer as the source of texture data uploads
+			/// </summary>
+			/// <param name="buffer">Pixel buffer ID (0 unbinds it, making texture data pointers refer to client memory again)</param>
+			virtual void BindPixelBuffer(int buffer) = 0;
+
+			/// <summary>
+			///		Inserts a fence after all the commands issued so far
+			/// </summary>
+			/// <returns>Fence ID</returns>
+			virtual int CreateFence() = 0;
+
+			/// <summary>
+			///		Checks if all the commands issued before a fence have completed (doesn't block)
+			/// </summary>
+			/// <param name="fence">Fence ID</param>
+			/// <returns>True if the fence was signaled, otherwise false</returns>
+			virtual bool IsFenceSignaled(int fence) = 0;
+
+			/// <summary>
+			///		Blocks until all the commands issued before a fence have completed or the timeout expires
+			/// </summary>
+			/// <param name="fence">Fence ID</param>
+			/// <param name="timeout">Timeout in nanoseconds</param>
+			/// <returns>Wait result</returns>
+			virtual FenceStatus WaitFence(int fence, uint64_t timeout) = 0;
+
+			/// <summary>
+			///		Destroys a fence
+			/// </summary>
+			/// <param name="fence">Fence ID</param>
+			virtual void DestroyFence(int fence) = 0;
+
+			/// <summary>
+			///		Creates a timer query
+			/// </summary>
+			/// <returns>Timer query ID</returns>
+			virtual int CreateTimerQuery() = 0;
+
+			/// <summary>
+			///		Destroys a timer query
+			/// </summary>
+			/// <param name="query">Timer query ID</param>
+			virtual void DestroyTimerQuery(int query) = 0;
+
+			/// <summary>
+			///		Records into a timer query the context time at which all the commands issued so far have completed (doesn't block)
+			/// </summary>
+			/// <param name="query">Timer query ID</param>
+			virtual void QueryTimestamp(int query) = 0;
+
+			/// <summary>
+			///		Checks if a timer query result is already available (doesn't block)
+			/// </summary>
+			/// <param name="query">Timer query ID</param>
+			/// <returns>True if the result is available, otherwise false</returns>
+			virtual bool IsTimerQueryAvailable(int query) = 0;
+
+			/// <summary>
+			///		Gets a timer query result (blocks until it is available)
+			/// </summary>
+			/// <param name="query">Timer query ID</param>
+			/// <returns>Context timestamp in nanoseconds</returns>
+			virtual uint64_t GetTimerQueryResult(int query) = 0;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "CullingStage.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MAGMA_CULLING_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MAGMA_CULLING_SSE
+#endif
+
+#if defined(MAGMA_CULLING_AVX)
+static constexpr size_t BatchWidth = 8;
+#elif defined(MAGMA_CULLING_SSE)
+static constexpr size_t BatchWidth = 4;
+#else
+static constexpr size_t BatchWidth = 1;
+#endif
+
+// Corners closer than this to the camera plane can't be projected
+static constexpr float MinClipW = 1e-5f;
+
+Magma::Graphics::Frustum Magma::Graphics::Frustum::FromMatrix(const glm::mat4 & viewProjection)
+{
+	auto row = [&](int i) { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+
+	Frustum frustum;
+	frustum.planes[0] = row(3) + row(0);
+	frustum.planes[1] = row(3) - row(0);
+	frustum.planes[2] = row(3) + row(1);
+	frustum.planes[3] = row(3) - row(1);
+	frustum.planes[4] = row(3) + row(2);
+	frustum.planes[5] = row(3) - row(2);
+	for (auto& p : frustum.planes)
+		p /= glm::length(glm::vec3(p));
+	return frustum;
+}
+
+Magma::Graphics::CullingStage::CullingStage(size_t occlusionWidth, size_t occlusionHeight)
+{
+	if (occlusionWidth == 0 || occlusionHeight == 0 || (occlusionWidth & (occlusionWidth - 1)) != 0 || (occlusionHeight & (occlusionHeight - 1)) != 0)
+	{
+		std::stringstream ss;
+		ss << "Failed to create CullingStage: the occlusion buffer size must be a power of two (" << occlusionWidth << "x" << occlusionHeight << ")";
+		throw std::runtime_error(ss.str());
+	}
+
+	m_occlusionCulling = false;
+	m_frustumCulledCount = 0;
+	m_occlusionCulledCount = 0;
+	m_width = occlusionWidth;
+	m_height = occlusionHeight;
+
+	for (size_t w = m_width, h = m_height;; w = std::max<size_t>(w / 2, 1), h = std::max<size_t>(h / 2, 1))
+	{
+		m_depthLevels.emplace_back(w * h, 1.0f);
+		if (w == 1 && h == 1)
+			break;
+	}
+}
+
+void Magma::Graphics::CullingStage::Process(RenderFrame & frame)
+{
+	m_frustumCulledCount = 0;
+	m_occlusionCulledCount = 0;
+
+	this->CullFrustum(frame);
+
+	if (m_occlusionCulling)
+	{
+		this->RasterizeOccluders(frame);
+		this->BuildDepthPyramid();
+
+		size_t visibleCount = 0;
+		for (auto i : m_visible)
+			if (!this->IsOccluded(frame.items[i], frame.viewProjection))
+				m_visible[visibleCount++] = i;
+		m_occlusionCulledCount = m_visible.size() - visibleCount;
+		m_visible.resize(visibleCount);
+	}
+
+	// Sort the visible items so items sharing programs and vertex arrays are drawn together
+	m_sortEntries.clear();
+	for (auto i : m_visible)
+		m_sortEntries.push_back(SortEntry { ((uint64_t)(uint32_t)frame.items[i].program << 32) | (uint32_t)frame.items[i].vao, i });
+	std::sort(m_sortEntries.begin(), m_sortEntries.end());
+
+	frame.visibleItems.clear();
+	for (auto& e : m_sortEntries)
+		frame.visibleItems.push_back(e.item);
+}
+
+void Magma::Graphics::CullingStage::CullFrustum(const RenderFrame & frame)
+{
+	auto frustum = Frustum::FromMatrix(frame.viewProjection);
+	auto count = frame.items.size();
+	auto padded = (count + BatchWidth - 1) / BatchWidth * BatchWidth;
+
+	m_centerX.resize(padded);
+	m_centerY.resize(padded);
+	m_centerZ.resize(padded);
+	m_extentX.resize(padded);
+	m_extentY.resize(padded);
+	m_extentZ.resize(padded);
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto& item = frame.items[i];
+		m_centerX[i] = item.boundsCenter.x;
+		m_centerY[i] = item.boundsCenter.y;
+		m_centerZ[i] = item.boundsCenter.z;
+		m_extentX[i] = item.boundsExtents.x;
+		m_extentY[i] = item.boundsExtents.y;
+		m_extentZ[i] = item.boundsExtents.z;
+	}
+
+	// A box is outside of the frustum if it is completely behind any of its planes:
+	// dot(plane.xyz, center) + plane.w + dot(abs(plane.xyz), extents) < 0
+	m_visible.clear();
+	for (size_t i = 0; i < padded; i += BatchWidth)
+	{
+#if defined(MAGMA_CULLING_AVX)
+		auto cx = _mm256_loadu_ps(&m_centerX[i]), cy = _mm256_loadu_ps(&m_centerY[i]), cz = _mm256_loadu_ps(&m_centerZ[i]);
+		auto ex = _mm256_loadu_ps(&m_extentX[i]), ey = _mm256_loadu_ps(&m_extentY[i]), ez = _mm256_loadu_ps(&m_extentZ[i]);
+		auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (auto& p : frustum.planes)
+		{
+			auto d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.x), cx), _mm256_mul_ps(_mm256_set1_ps(p.y), cy)),
+								   _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p.z), cz), _mm256_set1_ps(p.w)));
+			auto r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::abs(p.x)), ex), _mm256_mul_ps(_mm256_set1_ps(std::abs(p.y)), ey)),
+								   _mm256_mul_ps(_mm256_set1_ps(std::abs(p.z)), ez));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(d, r), _mm256_setzero_ps(), _CMP_GE_OQ));
+		}
+		auto mask = _mm256_movemask_ps(inside);
+#elif defined(MAGMA_CULLING_SSE)
+		auto cx = _mm_loadu_ps(&m_centerX[i]), cy = _mm_loadu_ps(&m_centerY[i]), cz = _mm_loadu_ps(&m_centerZ[i]);
+		auto ex = _mm_loadu_ps(&m_extentX[i]), ey = _mm_loadu_ps(&m_extentY[i]), ez = _mm_loadu_ps(&m_extentZ[i]);
+		auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (auto& p : frustum.planes)
+		{
+			auto d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), cx), _mm_mul_ps(_mm_set1_ps(p.y), cy)),
+								_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.z), cz), _mm_set1_ps(p.w)));
+			auto r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(p.x)), ex), _mm_mul_ps(_mm_set1_ps(std::abs(p.y)), ey)),
+								_mm_mul_ps(_mm_set1_ps(std::abs(p.z)), ez));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+		}
+		auto mask = _mm_movemask_ps(inside);
+#else
+		int mask = 1;
+		for (auto& p : frustum.planes)
+		{
+			auto d = p.x * m_centerX[i] + p.y * m_centerY[i] + p.z * m_centerZ[i] + p.w;
+			auto r = std::abs(p.x) * m_extentX[i] + std::abs(p.y) * m_extentY[i] + std::abs(p.z) * m_extentZ[i];
+			if (d + r < 0.0f)
+				mask = 0;
+		}
+#endif
+
+		for (size_t j = 0; j < BatchWidth && i + j < count; ++j)
+			if (mask & (1 << j))
+				m_visible.push_back(i + j);
+	}
+
+	m_frustumCulledCount = count - m_visible.size();
+}
+
+void Magma::Graphics::CullingStage::ProjectBox(const RenderItem & item, const glm::mat4 & viewProjection, glm::vec4 * corners) const
+{
+	// Corner i has its x, y and z on the positive side if bits 0, 1 and 2 are set
+	for (int i = 0; i < 8; ++i)
+	{
+		glm::vec3 sign((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f);
+		corners[i] = viewProjection * glm::vec4(item.boundsCenter + item.boundsExtents * sign, 1.0f);
+	}
+}
+
+void Magma::Graphics::CullingStage::RasterizeOccluders(const RenderFrame & frame)
+{
+	// Box faces project to convex quads, which are rasterized whole so no texels are lost along their diagonals
+	static const int faces[6][4] =
+	{
+		{ 0, 2, 6, 4 }, // -X
+		{ 1, 3, 7, 5 }, // +X
+		{ 0, 1, 5, 4 }, // -Y
+		{ 2, 3, 7, 6 }, // +Y
+		{ 0, 1, 3, 2 }, // -Z
+		{ 4, 5, 7, 6 }, // +Z
+	};
+
+	auto& depth = m_depthLevels[0];
+	std::fill(depth.begin(), depth.end(), 1.0f);
+
+	for (auto i : m_visible)
+	{
+		auto& item = frame.items[i];
+		if (!item.occluder)
+			continue;
+
+		// Occluders crossing the camera plane are skipped rather than clipped
+		glm::vec4 corners[8];
+		this->ProjectBox(item, frame.viewProjection, corners);
+		bool clipped = false;
+		glm::vec3 screen[8];
+		for (int c = 0; c < 8; ++c)
+		{
+			if (corners[c].w < MinClipW)
+			{
+				clipped = true;
+				break;
+			}
+			auto ndc = glm::vec3(corners[c]) / corners[c].w;
+			screen[c] = glm::vec3((ndc.x * 0.5f + 0.5f) * m_width, (ndc.y * 0.5f + 0.5f) * m_height, ndc.z);
+		}
+		if (clipped)
+			continue;
+
+		for (auto& f : faces)
+		{
+			const glm::vec3* quad[4] = { &screen[f[0]], &screen[f[1]], &screen[f[2]], &screen[f[3]] };
+
+			float area = 0.0f;
+			for (int v = 0; v < 4; ++v)
+				area += quad[v]->x * quad[(v + 1) % 4]->y - quad[(v + 1) % 4]->x * quad[v]->y;
+			if (std::abs(area) < 1e-6f)
+				continue;
+			auto orientation = area > 0.0f ? 1.0f : -1.0f;
+
+			// Every texel covered by the face gets its farthest depth, so the depth buffer never hides something in front of an occluder
+			auto faceDepth = quad[0]->z;
+			glm::vec2 min(*quad[0]), max(*quad[0]);
+			for (int v = 1; v < 4; ++v)
+			{
+				faceDepth = std::max(faceDepth, quad[v]->z);
+				min = glm::min(min, glm::vec2(*quad[v]));
+				max = glm::max(max, glm::vec2(*quad[v]));
+			}
+
+			auto minX = std::max(0, (int)std::floor(min.x));
+			auto maxX = std::min((int)m_width - 1, (int)std::ceil(max.x));
+			auto minY = std::max(0, (int)std::floor(min.y));
+			auto maxY = std::min((int)m_height - 1, (int)std::ceil(max.y));
+
+			for (int y = minY; y <= maxY; ++y)
+				for (int x = minX; x <= maxX; ++x)
+				{
+					// Only texels completely covered by the face are written, so the edge functions are tested at the texel corner closest to each edge
+					bool covered = true;
+					for (int v = 0; v < 4 && covered; ++v)
+					{
+						auto& p0 = *quad[v];
+						auto& p1 = *quad[(v + 1) % 4];
+						auto dx = p1.x - p0.x, dy = p1.y - p0.y;
+						auto w = orientation * (dx * (y + 0.5f - p0.y) - dy * (x + 0.5f - p0.x));
+						covered = w - 0.5f * (std::abs(dx) + std::abs(dy)) >= 0.0f;
+					}
+
+					auto& texel = depth[y * m_width + x];
+					if (covered && faceDepth < texel)
+						texel = faceDepth;
+				}
+		}
+	}
+}
+
+void Magma::Graphics::CullingStage::BuildDepthPyramid()
+{
+	size_t width = m_width, height = m_height;
+	for (size_t level = 1; level < m_depthLevels.size(); ++level)
+	{
+		auto& src = m_depthLevels[level - 1];
+		auto& dst = m_depthLevels[level];
+		auto dstWidth = std::max<size_t>(width / 2, 1), dstHeight = std::max<size_t>(height / 2, 1);
+
+		for (size_t y = 0; y < dstHeight; ++y)
+			for (size_t x = 0; x < dstWidth; ++x)
+			{
+				auto x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+				auto y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+				dst[y * dstWidth + x] = std::max(std::max(src[y0 * width + x0], src[y0 * width + x1]), std::max(src[y1 * width + x0], src[y1 * width + x1]));
+			}
+
+		width = dstWidth;
+		height = dstHeight;
+	}
+}
+
+bool Magma::Graphics::CullingStage::IsOccluded(const RenderItem & item, const glm::mat4 & viewProjection) const
+{
+	glm::vec4 corners[8];
+	this->ProjectBox(item, viewProjection, corners);
+
+	glm::vec2 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
+	float minDepth = std::numeric_limits<float>::max();
+	for (auto& c : corners)
+	{
+		// Items crossing the camera plane are always visible
+		if (c.w < MinClipW)
+			return false;
+
+		auto ndc = glm::vec3(c) / c.w;
+		auto screen = glm::vec2((ndc.x * 0.5f + 0.5f) * m_width, (ndc.y * 0.5f + 0.5f) * m_height);
+		min = glm::min(min, screen);
+		max = glm::max(max, screen);
+		minDepth = std::min(minDepth, ndc.z);
+	}
+
+	auto x0 = (size_t)glm::clamp((int)std::floor(min.x), 0, (int)m_width - 1);
+	auto x1 = (size_t)glm::clamp((int)std::floor(max.x), 0, (int)m_width - 1);
+	auto y0 = (size_t)glm::clamp((int)std::floor(min.y), 0, (int)m_height - 1);
+	auto y1 = (size_t)glm::clamp((int)std::floor(max.y), 0, (int)m_height - 1);
+
+	// Pick the finest pyramid level where the bounds cover at most 4x4 texels
+	size_t level = 0;
+	while (level + 1 < m_depthLevels.size() && ((x1 >> level) - (x0 >> level) > 3 || (y1 >> level) - (y0 >> level) > 3))
+		++level;
+
+	auto levelWidth = std::max<size_t>(m_width >> level, 1);
+	auto& depth = m_depthLevels[level];
+	for (auto y = y0 >> level; y <= (y1 >> level); ++y)
+		for (auto x = x0 >> level; x <= (x1 >> level); ++x)
+			if (minDepth <= depth[std::min(y, std::max<size_t>(m_height >> level, 1) - 1) * levelWidth + std::min(x, levelWidth - 1)])
+				return false;
+
+	return true;
+}
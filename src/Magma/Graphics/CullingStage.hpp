@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Renderer.hpp"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Camera frustum, as six normalized planes (left, right, bottom, top, near, far) pointing inwards
+		/// </summary>
+		struct Frustum
+		{
+			/// <summary>
+			///		Plane normals (xyz) and distances (w)
+			/// </summary>
+			glm::vec4 planes[6];
+
+			/// <summary>
+			///		Extracts the frustum planes from a view projection matrix
+			/// </summary>
+			static Frustum FromMatrix(const glm::mat4& viewProjection);
+		};
+
+		/// <summary>
+		///		Culls the items of a render frame which are outside of the camera frustum, and optionally the ones hidden behind occluders,
+		///		then sorts the remaining ones by program and vertex array.
+		///		Bounding boxes are tested against the frustum in SIMD batches (8 boxes at a time with AVX, 4 with SSE).
+		///		Occlusion culling rasterizes the occluders' bounding boxes into a small CPU depth buffer and tests the items against its
+		///		hierarchical max depth pyramid.
+		/// </summary>
+		class CullingStage final
+		{
+		public:
+			/// <summary>
+			///		Creates a new culling stage
+			/// </summary>
+			/// <param name="occlusionWidth">Occlusion depth buffer width (power of two)</param>
+			/// <param name="occlusionHeight">Occlusion depth buffer height (power of two)</param>
+			CullingStage(size_t occlusionWidth = 256, size_t occlusionHeight = 128);
+			~CullingStage() = default;
+
+			/// <summary>
+			///		Enables or disables occlusion culling (disabled by default)
+			/// </summary>
+			inline void SetOcclusionCulling(bool enabled) { m_occlusionCulling = enabled; }
+
+			/// <summary>
+			///		Is occlusion culling enabled?
+			/// </summary>
+			inline bool IsOcclusionCullingEnabled() const { return m_occlusionCulling; }
+
+			/// <summary>
+			///		Fills the frame's visible items
+			/// </summary>
+			/// <param name="frame">Render frame</param>
+			void Process(RenderFrame& frame);
+
+			/// <summary>
+			///		Gets the number of items outside of the frustum on the last frame processed
+			/// </summary>
+			inline size_t GetFrustumCulledCount() const { return m_frustumCulledCount; }
+
+			/// <summary>
+			///		Gets the number of items hidden by occluders on the last frame processed
+			/// </summary>
+			inline size_t GetOcclusionCulledCount() const { return m_occlusionCulledCount; }
+
+		private:
+			struct SortEntry
+			{
+				uint64_t key;
+				size_t item;
+
+				inline bool operator<(const SortEntry& rhs) const { return key != rhs.key ? key < rhs.key : item < rhs.item; }
+			};
+
+			void CullFrustum(const RenderFrame& frame);
+			void RasterizeOccluders(const RenderFrame& frame);
+			void BuildDepthPyramid();
+			bool IsOccluded(const RenderItem& item, const glm::mat4& viewProjection) const;
+			void ProjectBox(const RenderItem& item, const glm::mat4& viewProjection, glm::vec4* corners) const;
+
+			bool m_occlusionCulling;
+			size_t m_frustumCulledCount;
+			size_t m_occlusionCulledCount;
+
+			// Bounding boxes in structure of arrays layout, padded to the SIMD width
+			std::vector<float> m_centerX, m_centerY, m_centerZ;
+			std::vector<float> m_extentX, m_extentY, m_extentZ;
+			std::vector<size_t> m_visible;
+
+			// Depth pyramid (level 0 is the full resolution depth buffer, each level stores the max depth of 2x2 texels of the previous one)
+			size_t m_width, m_height;
+			std::vector<std::vector<float>> m_depthLevels;
+
+			std::vector<SortEntry> m_sortEntries;
+		};
+	}
+}
@@ -0,0 +1,54 @@
+#include "FrameThrottle.hpp"
+
+#include <stdexcept>
+
+// Waits are split into slices, so that a lost context can't hang the CPU forever without being noticed
+static constexpr uint64_t WaitSlice = 100000000; // 100 ms
+static constexpr size_t MaxWaitSlices = 50;
+
+Magma::Graphics::FrameThrottle::FrameThrottle(Context & context, size_t maxFramesInFlight)
+	: m_context(context)
+{
+	if (maxFramesInFlight == 0)
+		throw std::runtime_error("Failed to create FrameThrottle: there must be at least one frame in flight");
+
+	m_fences.resize(maxFramesInFlight, 0);
+	m_slot = 0;
+	m_lastWaitTime = std::chrono::nanoseconds(0);
+}
+
+Magma::Graphics::FrameThrottle::~FrameThrottle()
+{
+	for (auto f : m_fences)
+		if (f != 0)
+			m_context.DestroyFence(f);
+}
+
+void Magma::Graphics::FrameThrottle::BeginFrame()
+{
+	auto& fence = m_fences[m_slot];
+	m_lastWaitTime = std::chrono::nanoseconds(0);
+	if (fence == 0)
+		return;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	size_t slices = 0;
+	while (m_context.WaitFence(fence, WaitSlice) == FenceStatus::TimeoutExpired)
+		if (++slices == MaxWaitSlices)
+			throw std::runtime_error("Failed to begin frame on FrameThrottle: timed out waiting for the context to finish a previous frame");
+
+	m_lastWaitTime = std::chrono::high_resolution_clock::now() - start;
+
+	m_context.DestroyFence(fence);
+	fence = 0;
+}
+
+void Magma::Graphics::FrameThrottle::EndFrame()
+{
+	auto& fence = m_fences[m_slot];
+	if (fence != 0)
+		throw std::runtime_error("Failed to end frame on FrameThrottle: BeginFrame wasn't called");
+	fence = m_context.CreateFence();
+	m_slot = (m_slot + 1) % m_fences.size();
+}
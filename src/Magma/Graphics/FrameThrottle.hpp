@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Context.hpp"
+
+#include <chrono>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Limits how many frames the CPU may submit before the context finishes them.
+		///		Resources used by a frame (e.g.: dynamic buffer regions) can be safely reused when the throttle returns to its frame slot.
+		/// </summary>
+		class FrameThrottle final
+		{
+		public:
+			/// <summary>
+			///		Creates a new frame throttle
+			/// </summary>
+			/// <param name="context">Context to synchronize with</param>
+			/// <param name="maxFramesInFlight">Maximum number of frames submitted but not yet completed by the context</param>
+			FrameThrottle(Context& context, size_t maxFramesInFlight = 2);
+			~FrameThrottle();
+
+			/// <summary>
+			///		Blocks until the frame which last used the current frame slot has completed (call before submitting a frame)
+			/// </summary>
+			void BeginFrame();
+
+			/// <summary>
+			///		Marks the end of the commands of the current frame and advances to the next frame slot (call after submitting a frame)
+			/// </summary>
+			void EndFrame();
+
+			/// <summary>
+			///		Gets the current frame slot index (in the range [0, maxFramesInFlight[)
+			/// </summary>
+			inline size_t GetFrameSlot() const { return m_slot; }
+
+			inline size_t GetMaxFramesInFlight() const { return m_fences.size(); }
+
+			/// <summary>
+			///		Gets how long the last BeginFrame call blocked waiting for the context
+			/// </summary>
+			inline std::chrono::nanoseconds GetLastWaitTime() const { return m_lastWaitTime; }
+
+		private:
+			Context& m_context;
+
+			std::vector<int> m_fences;
+			size_t m_slot;
+			std::chrono::nanoseconds m_lastWaitTime;
+		};
+	}
+}
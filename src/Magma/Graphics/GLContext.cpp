@@ -18,11 +18,37 @@ MessageCallback(GLenum source,
 }
 
 
+static GLenum TargetFormatToGL(Magma::Graphics::TargetFormat format)
+{
+	switch (format)
+	{
+		case Magma::Graphics::TargetFormat::R8: return GL_R8;
+		case Magma::Graphics::TargetFormat::RG8: return GL_RG8;
+		case Magma::Graphics::TargetFormat::RGBA8: return GL_RGBA8;
+		case Magma::Graphics::TargetFormat::R16F: return GL_R16F;
+		case Magma::Graphics::TargetFormat::RG16F: return GL_RG16F;
+		case Magma::Graphics::TargetFormat::RGBA16F: return GL_RGBA16F;
+		case Magma::Graphics::TargetFormat::R32F: return GL_R32F;
+		case Magma::Graphics::TargetFormat::RG32F: return GL_RG32F;
+		case Magma::Graphics::TargetFormat::RGBA32F: return GL_RGBA32F;
+		case Magma::Graphics::TargetFormat::Depth16: return GL_DEPTH_COMPONENT16;
+		case Magma::Graphics::TargetFormat::Depth24: return GL_DEPTH_COMPONENT24;
+		case Magma::Graphics::TargetFormat::Depth32F: return GL_DEPTH_COMPONENT32F;
+		case Magma::Graphics::TargetFormat::Depth24Stencil8: return GL_DEPTH24_STENCIL8;
+		default: throw std::runtime_error("Failed to convert target format to GL: invalid format");
+	}
+}
+
 Magma::Graphics::GLContext::GLContext()
 {
 	// Init GLEW
 	{
 		auto err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+		// Headless (surfaceless EGL) contexts have no GLX display, but the GL entry points are loaded anyway
+		if (err == GLEW_ERROR_NO_GLX_DISPLAY)
+			err = GLEW_OK;
+#endif
 		if (err != GLEW_OK)
 		{
 			std::stringstream ss;
@@ -186,6 +212,31 @@ void Magma::Graphics::GLContext::SetVertexAttributePointer(int vao, int vbo, int
 		case AttributeType::Float:
 			glVertexAttribPointer(index, size, GL_FLOAT, normalized, stride, offset);
 			break;
+		case AttributeType::UByte:
+			glVertexAttribPointer(index, size, GL_UNSIGNED_BYTE, normalized, stride, offset);
+			break;
+		case AttributeType::Byte:
+			glVertexAttribPointer(index, size, GL_BYTE, normalized, stride, offset);
+			break;
+		case AttributeType::UShort:
+			glVertexAttribPointer(index, size, GL_UNSIGNED_SHORT, normalized, stride, offset);
+			break;
+		case AttributeType::Short:
+			glVertexAttribPointer(index, size, GL_SHORT, normalized, stride, offset);
+			break;
+		case AttributeType::Half:
+			glVertexAttribPointer(index, size, GL_HALF_FLOAT, normalized, stride, offset);
+			break;
+		case AttributeType::Int2_10_10_10:
+			if (size != 4)
+				throw std::runtime_error("Failed to set vertex attribute pointer on GLContext, packed 2_10_10_10 attributes must have 4 components");
+			glVertexAttribPointer(index, size, GL_INT_2_10_10_10_REV, normalized, stride, offset);
+			break;
+		case AttributeType::UInt2_10_10_10:
+			if (size != 4)
+				throw std::runtime_error("Failed to set vertex attribute pointer on GLContext, packed 2_10_10_10 attributes must have 4 components");
+			glVertexAttribPointer(index, size, GL_UNSIGNED_INT_2_10_10_10_REV, normalized, stride, offset);
+			break;
 		default:
 			throw std::runtime_error("Failed to set vertex attribute pointer on GLContext, invalid attribute type");
 			break;
@@ -205,6 +256,25 @@ void Magma::Graphics::GLContext::DestroyVertexArray(int vao)
 	m_data.erase(vao);
 }
 
+int Magma::Graphics::GLContext::CreateIndexBuffer(int vao, const void * data, size_t size)
+{
+	// The element array binding is part of the vertex array state
+	GLuint ibo;
+	glBindVertexArray(m_data.at(vao));
+	glCreateBuffers(1, &ibo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+	glBindVertexArray(0);
+	m_data[m_nextID] = ibo;
+	return m_nextID++;
+}
+
+void Magma::Graphics::GLContext::DestroyIndexBuffer(int ibo)
+{
+	glDeleteBuffers(1, &m_data.at(ibo));
+	m_data.erase(ibo);
+}
+
 void Magma::Graphics::GLContext::DrawVertexArray(int vao, DrawMode mode, int first, size_t count)
 {
 	glBindVertexArray(m_data.at(vao));
@@ -222,6 +292,35 @@ void Magma::Graphics::GLContext::DrawVertexArray(int vao, DrawMode mode, int fir
 	glBindVertexArray(0);
 }
 
+void Magma::Graphics::GLContext::DrawIndexedVertexArray(int vao, DrawMode mode, IndexType type, size_t first, size_t count)
+{
+	GLenum glMode, glType;
+	size_t indexSize;
+
+	switch (mode)
+	{
+		case DrawMode::Points: glMode = GL_POINTS; break;
+		case DrawMode::Lines: glMode = GL_LINES; break;
+		case DrawMode::LineStrip: glMode = GL_LINE_STRIP; break;
+		case DrawMode::LineLoop: glMode = GL_LINE_LOOP; break;
+		case DrawMode::Triangles: glMode = GL_TRIANGLES; break;
+		case DrawMode::TriangleStrip: glMode = GL_TRIANGLE_STRIP; break;
+		case DrawMode::TriangleFan: glMode = GL_TRIANGLE_FAN; break;
+		default: throw std::runtime_error("Failed to draw indexed vertex array: invalid mode"); break;
+	}
+
+	switch (type)
+	{
+		case IndexType::UShort: glType = GL_UNSIGNED_SHORT; indexSize = 2; break;
+		case IndexType::UInt: glType = GL_UNSIGNED_INT; indexSize = 4; break;
+		default: throw std::runtime_error("Failed to draw indexed vertex array: invalid index type"); break;
+	}
+
+	glBindVertexArray(m_data.at(vao));
+	glDrawElements(glMode, count, glType, (const void*)(first * indexSize));
+	glBindVertexArray(0);
+}
+
 void Magma::Graphics::GLContext::ActivateProgram(int program)
 {
 	m_activeProgram = program;
@@ -349,6 +448,12 @@ int Magma::Graphics::GLContext::CreateFramebuffer()
 	return m_nextID++;
 }
 
+void Magma::Graphics::GLContext::DestroyFramebuffer(int framebuffer)
+{
+	glDeleteFramebuffers(1, &m_data.at(framebuffer));
+	m_data.erase(framebuffer);
+}
+
 void Magma::Graphics::GLContext::BindFramebuffer(FramebufferTarget target, int framebuffer)
 {
 	int fb = (framebuffer == 0) ? 0 : m_data.at(framebuffer);
@@ -402,6 +507,73 @@ void Magma::Graphics::GLContext::FramebufferTexture2D(FramebufferTarget target,
 	glFramebufferTexture2D(glTarget, glAttachment, GL_TEXTURE_2D, m_data.at(texture), level);
 }
 
+void Magma::Graphics::GLContext::FramebufferRenderbuffer(FramebufferTarget target, FramebufferAttachment attachment, int renderbuffer)
+{
+	GLenum glTarget;
+	GLenum glAttachment;
+
+	switch (target)
+	{
+		case FramebufferTarget::Draw: glTarget = GL_DRAW_FRAMEBUFFER; break;
+		case FramebufferTarget::Read: glTarget = GL_READ_FRAMEBUFFER; break;
+		case FramebufferTarget::Both: glTarget = GL_FRAMEBUFFER; break;
+		default:
+			throw std::runtime_error("Failed to add renderbuffer to framebuffer: invalid framebuffer target");
+			break;
+	}
+
+	switch (attachment)
+	{
+		case FramebufferAttachment::Color0: glAttachment = GL_COLOR_ATTACHMENT0; break;
+		case FramebufferAttachment::Color1: glAttachment = GL_COLOR_ATTACHMENT1; break;
+		case FramebufferAttachment::Color2: glAttachment = GL_COLOR_ATTACHMENT2; break;
+		case FramebufferAttachment::Color3: glAttachment = GL_COLOR_ATTACHMENT3; break;
+		case FramebufferAttachment::Color4: glAttachment = GL_COLOR_ATTACHMENT4; break;
+		case FramebufferAttachment::Color5: glAttachment = GL_COLOR_ATTACHMENT5; break;
+		case FramebufferAttachment::Color6: glAttachment = GL_COLOR_ATTACHMENT6; break;
+		case FramebufferAttachment::Color7: glAttachment = GL_COLOR_ATTACHMENT7; break;
+		case FramebufferAttachment::Depth: glAttachment = GL_DEPTH_ATTACHMENT; break;
+		case FramebufferAttachment::Stencil: glAttachment = GL_STENCIL_ATTACHMENT; break;
+		case FramebufferAttachment::DepthStencil: glAttachment = GL_DEPTH_STENCIL_ATTACHMENT; break;
+		default:
+			throw std::runtime_error("Failed to add renderbuffer to framebuffer: invalid framebuffer attachment");
+			break;
+	}
+
+	glFramebufferRenderbuffer(glTarget, glAttachment, GL_RENDERBUFFER, m_data.at(renderbuffer));
+}
+
+bool Magma::Graphics::GLContext::IsFramebufferComplete(FramebufferTarget target)
+{
+	switch (target)
+	{
+		case FramebufferTarget::Draw: return glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+		case FramebufferTarget::Read: return glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+		case FramebufferTarget::Both: return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+		default: throw std::runtime_error("Failed to check framebuffer completeness: invalid framebuffer target");
+	}
+}
+
+int Magma::Graphics::GLContext::CreateRenderbuffer(TargetFormat format, size_t width, size_t height, size_t samples)
+{
+	auto glFormat = TargetFormatToGL(format);
+
+	GLuint renderbuffer;
+	glCreateRenderbuffers(1, &renderbuffer);
+	if (samples > 1)
+		glNamedRenderbufferStorageMultisample(renderbuffer, samples, glFormat, width, height);
+	else
+		glNamedRenderbufferStorage(renderbuffer, glFormat, width, height);
+	m_data[m_nextID] = renderbuffer;
+	return m_nextID++;
+}
+
+void Magma::Graphics::GLContext::DestroyRenderbuffer(int renderbuffer)
+{
+	glDeleteRenderbuffers(1, &m_data.at(renderbuffer));
+	m_data.erase(renderbuffer);
+}
+
 void Magma::Graphics::GLContext::SetDrawBuffers(size_t count, FramebufferAttachment * attachments)
 {
 	if (count > (size_t)FramebufferAttachment::Count)
@@ -456,6 +628,43 @@ void Magma::Graphics::GLContext::BlitFramebuffer(int srcX0, int srcY0, int srcX1
 	glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, glMask, glFilter);
 }
 
+void Magma::Graphics::GLContext::ReadPixels(int x, int y, size_t width, size_t height, PixelFormat format, PixelType type, void * data)
+{
+	GLenum glFormat;
+	GLenum glType;
+
+	switch (format)
+	{
+		case PixelFormat::R: glFormat = GL_RED; break;
+		case PixelFormat::RG: glFormat = GL_RG; break;
+		case PixelFormat::RGB: glFormat = GL_RGB; break;
+		case PixelFormat::BGR: glFormat = GL_BGR; break;
+		case PixelFormat::RGBA: glFormat = GL_RGBA; break;
+		case PixelFormat::BGRA: glFormat = GL_BGRA; break;
+		case PixelFormat::DepthComponent: glFormat = GL_DEPTH_COMPONENT; break;
+		default: throw std::runtime_error("Failed to read pixels: invalid pixel data format"); break;
+	}
+
+	switch (type)
+	{
+		case PixelType::UByte: glType = GL_UNSIGNED_BYTE; break;
+		case PixelType::UShort: glType = GL_UNSIGNED_SHORT; break;
+		case PixelType::UInt: glType = GL_UNSIGNED_INT; break;
+		case PixelType::Byte: glType = GL_BYTE; break;
+		case PixelType::Short: glType = GL_SHORT; break;
+		case PixelType::Int: glType = GL_INT; break;
+		case PixelType::Float: glType = GL_FLOAT; break;
+		default: throw std::runtime_error("Failed to read pixels: invalid pixel data type"); break;
+	}
+
+	// Rows are read tightly packed, and the previous alignment is restored so other pack operations aren't affected
+	GLint alignment;
+	glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(x, y, width, height, glFormat, glType, data);
+	glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+}
+
 int Magma::Graphics::GLContext::CreateTexture2D()
 {
 	GLuint texture;
@@ -535,6 +744,11 @@ void Magma::Graphics::GLContext::TextureData2D(int level, PixelFormat internalFo
 	err = glGetError();
 }
 
+void Magma::Graphics::GLContext::TextureStorage2D(size_t levels, TargetFormat format, size_t width, size_t height)
+{
+	glTexStorage2D(GL_TEXTURE_2D, levels, TargetFormatToGL(format), width, height);
+}
+
 void Magma::Graphics::GLContext::SetTextureMinFilter(Filter filter)
 {
 	GLenum glFilter;
@@ -613,7 +827,171 @@ void Magma::Graphics::GLContext::Clear(BufferBit mask)
 	glClear(glMask);
 }
 
+void Magma::Graphics::GLContext::InsertBarrier(BarrierBit barriers)
+{
+	GLbitfield glBarriers = 0;
+
+	if ((barriers & BarrierBit::VertexAttribute) != BarrierBit::None)
+		glBarriers |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+	if ((barriers & BarrierBit::Uniform) != BarrierBit::None)
+		glBarriers |= GL_UNIFORM_BARRIER_BIT;
+	if ((barriers & BarrierBit::TextureFetch) != BarrierBit::None)
+		glBarriers |= GL_TEXTURE_FETCH_BARRIER_BIT;
+	if ((barriers & BarrierBit::ShaderStorage) != BarrierBit::None)
+		glBarriers |= GL_SHADER_STORAGE_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+	if ((barriers & BarrierBit::Framebuffer) != BarrierBit::None)
+		glBarriers |= GL_FRAMEBUFFER_BARRIER_BIT;
+	if ((barriers & BarrierBit::TextureUpdate) != BarrierBit::None)
+		glBarriers |= GL_TEXTURE_UPDATE_BARRIER_BIT;
+	if ((barriers & BarrierBit::BufferUpdate) != BarrierBit::None)
+		glBarriers |= GL_BUFFER_UPDATE_BARRIER_BIT;
+	if ((barriers & BarrierBit::PixelBuffer) != BarrierBit::None)
+		glBarriers |= GL_PIXEL_BUFFER_BARRIER_BIT;
+
+	if (glBarriers != 0)
+		glMemoryBarrier(glBarriers);
+}
+
 void Magma::Graphics::GLContext::SetUnpackAlignment(int alignment)
 {
 	glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
 }
+
+
+void Magma::Graphics::GLContext::TextureSubData2D(int level, size_t x, size_t y, size_t width, size_t height, PixelFormat format, PixelType type, const void * data)
+{
+	GLenum glFormat;
+	GLenum glType;
+
+	switch (format)
+	{
+		case PixelFormat::R: glFormat = GL_RED; break;
+		case PixelFormat::RG: glFormat = GL_RG; break;
+		case PixelFormat::RGB: glFormat = GL_RGB; break;
+		case PixelFormat::BGR: glFormat = GL_BGR; break;
+		case PixelFormat::RGBA: glFormat = GL_RGBA; break;
+		case PixelFormat::BGRA: glFormat = GL_BGRA; break;
+		case PixelFormat::DepthComponent: glFormat = GL_DEPTH_COMPONENT; break;
+		default: throw std::runtime_error("Failed to set texture sub data: invalid pixel data format"); break;
+	}
+
+	switch (type)
+	{
+		case PixelType::UByte: glType = GL_UNSIGNED_BYTE; break;
+		case PixelType::UShort: glType = GL_UNSIGNED_SHORT; break;
+		case PixelType::UInt: glType = GL_UNSIGNED_INT; break;
+		case PixelType::Byte: glType = GL_BYTE; break;
+		case PixelType::Short: glType = GL_SHORT; break;
+		case PixelType::Int: glType = GL_INT; break;
+		case PixelType::Float: glType = GL_FLOAT; break;
+		default: throw std::runtime_error("Failed to set texture sub data: invalid pixel data type"); break;
+	}
+
+	glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, glFormat, glType, data);
+}
+
+int Magma::Graphics::GLContext::CreatePixelBuffer(size_t size)
+{
+	GLuint pbo;
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	glCreateBuffers(1, &pbo);
+	glNamedBufferStorage(pbo, size, nullptr, flags);
+	auto ptr = glMapNamedBufferRange(pbo, 0, size, flags);
+	if (ptr == nullptr)
+	{
+		glDeleteBuffers(1, &pbo);
+		throw std::runtime_error("Failed to create pixel buffer on GLContext: couldn't map buffer storage");
+	}
+
+	m_data[m_nextID] = pbo;
+	m_pixelBufferPointers[m_nextID] = ptr;
+	return m_nextID++;
+}
+
+void Magma::Graphics::GLContext::DestroyPixelBuffer(int buffer)
+{
+	glUnmapNamedBuffer(m_data.at(buffer));
+	glDeleteBuffers(1, &m_data.at(buffer));
+	m_pixelBufferPointers.erase(buffer);
+	m_data.erase(buffer);
+}
+
+void * Magma::Graphics::GLContext::GetPixelBufferPointer(int buffer)
+{
+	return m_pixelBufferPointers.at(buffer);
+}
+
+void Magma::Graphics::GLContext::BindPixelBuffer(int buffer)
+{
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, (buffer == 0) ? 0 : m_data.at(buffer));
+}
+
+int Magma::Graphics::GLContext::CreateFence()
+{
+	auto sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	if (sync == nullptr)
+		throw std::runtime_error("Failed to create fence on GLContext");
+	m_fences[m_nextID] = sync;
+	return m_nextID++;
+}
+
+bool Magma::Graphics::GLContext::IsFenceSignaled(int fence)
+{
+	GLint status = GL_UNSIGNALED;
+	glGetSynciv((GLsync)m_fences.at(fence), GL_SYNC_STATUS, sizeof(status), nullptr, &status);
+	return status == GL_SIGNALED;
+}
+
+Magma::Graphics::FenceStatus Magma::Graphics::GLContext::WaitFence(int fence, uint64_t timeout)
+{
+	switch (glClientWaitSync((GLsync)m_fences.at(fence), GL_SYNC_FLUSH_COMMANDS_BIT, timeout))
+	{
+		case GL_ALREADY_SIGNALED:
+		case GL_CONDITION_SATISFIED:
+			return FenceStatus::Signaled;
+		case GL_TIMEOUT_EXPIRED:
+			return FenceStatus::TimeoutExpired;
+		default:
+			throw std::runtime_error("Failed to wait for fence on GLContext: wait failed");
+	}
+}
+
+void Magma::Graphics::GLContext::DestroyFence(int fence)
+{
+	glDeleteSync((GLsync)m_fences.at(fence));
+	m_fences.erase(fence);
+}
+
+int Magma::Graphics::GLContext::CreateTimerQuery()
+{
+	GLuint query;
+	glGenQueries(1, &query);
+	m_data[m_nextID] = query;
+	return m_nextID++;
+}
+
+void Magma::Graphics::GLContext::DestroyTimerQuery(int query)
+{
+	glDeleteQueries(1, &m_data.at(query));
+	m_data.erase(query);
+}
+
+void Magma::Graphics::GLContext::QueryTimestamp(int query)
+{
+	glQueryCounter(m_data.at(query), GL_TIMESTAMP);
+}
+
+bool Magma::Graphics::GLContext::IsTimerQueryAvailable(int query)
+{
+	GLuint available = GL_FALSE;
+	glGetQueryObjectuiv(m_data.at(query), GL_QUERY_RESULT_AVAILABLE, &available);
+	return available == GL_TRUE;
+}
+
+uint64_t Magma::Graphics::GLContext::GetTimerQueryResult(int query)
+{
+	GLuint64 result = 0;
+	glGetQueryObjectui64v(m_data.at(query), GL_QUERY_RESULT, &result);
+	return result;
+}
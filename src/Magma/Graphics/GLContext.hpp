@@ -9,18 +9,15 @@ namespace Magma
 	namespace Graphics
 	{
 		/// <summary>
-		///		OpenGL implementation of Context using GLEW
+		///		OpenGL implementation of Context using GLEW.
+		///		The class is final and its methods are public, so calls made through a GLContext reference are resolved statically.
 		/// </summary>
-		class GLContext : public Context
+		class GLContext final : public Context
 		{
 		public:
 			GLContext();
 			virtual ~GLContext();
 
-		private:
-			std::map<int, unsigned int> m_data;
-			int m_nextID;
-
 			// Inherited via Context
 			virtual int CreateShader(ShaderType type, const char * src) override;
 			virtual int CreateProgram() override;
@@ -36,7 +33,10 @@ namespace Magma
 			virtual void SetVertexAttributePointer(int vao, int vbo, int index, int size, AttributeType type, bool normalized, size_t stride, const void * offset) override;
 			virtual void DestroyVertexBuffer(int vbo) override;
 			virtual void DestroyVertexArray(int vao) override;
+			virtual int CreateIndexBuffer(int vao, const void* data, size_t size) override;
+			virtual void DestroyIndexBuffer(int ibo) override;
 			virtual void DrawVertexArray(int vao, DrawMode mode, int first, size_t count) override;
+			virtual void DrawIndexedVertexArray(int vao, DrawMode mode, IndexType type, size_t first, size_t count) override;
 			virtual void ActivateProgram(int program) override;
 			virtual void DeactivateProgram(int program) override;
 			virtual void SetUniform1i(int index, int value) override;
@@ -61,23 +61,50 @@ namespace Magma
 			virtual void SetUniform4x4fv(int index, size_t count, const glm::mat4 * mat) override;
 			virtual void SetViewport(float x, float y, float width, float height) override;
 			virtual int CreateFramebuffer() override;
+			virtual void DestroyFramebuffer(int framebuffer) override;
 			virtual void BindFramebuffer(FramebufferTarget target, int framebuffer) override;
 			virtual void FramebufferTexture2D(FramebufferTarget target, FramebufferAttachment attachment, int texture, int level) override;
+			virtual void FramebufferRenderbuffer(FramebufferTarget target, FramebufferAttachment attachment, int renderbuffer) override;
+			virtual bool IsFramebufferComplete(FramebufferTarget target) override;
+			virtual int CreateRenderbuffer(TargetFormat format, size_t width, size_t height, size_t samples) override;
+			virtual void DestroyRenderbuffer(int renderbuffer) override;
 			virtual void SetDrawBuffers(size_t count, FramebufferAttachment * attachments) override;
 			virtual void BlitFramebuffer(int srcX0, int srcY0, int srcX1, int srcY1, int dstX0, int dstY0, int dstX1, int dstY1, BufferBit mask, Filter filter) override;
+			virtual void ReadPixels(int x, int y, size_t width, size_t height, PixelFormat format, PixelType type, void* data) override;
 			virtual int CreateTexture2D() override;
 			virtual void DestroyTexture2D(int texture) override;
 			virtual void ActivateTexture2D(int texture, int slot) override;
 			virtual void DeactivateTexture2D(int texture, int slot) override;
 			virtual void TextureData2D(int level, PixelFormat internalFormat, size_t width, size_t height, PixelFormat format, PixelType type, void * data) override;
+			virtual void TextureStorage2D(size_t levels, TargetFormat format, size_t width, size_t height) override;
 			virtual void SetTextureMinFilter(Filter filter) override;
 			virtual void SetTextureMagFilter(Filter filter) override;
 			virtual void SetTextureWrapSMode(WrapMode mode) override;
 			virtual void SetTextureWrapTMode(WrapMode mode) override;
 			virtual void Clear(BufferBit mask) override;
+			virtual void InsertBarrier(BarrierBit barriers) override;
 			virtual void SetUnpackAlignment(int alignment) override;
+			virtual void TextureSubData2D(int level, size_t x, size_t y, size_t width, size_t height, PixelFormat format, PixelType type, const void* data) override;
+			virtual int CreatePixelBuffer(size_t size) override;
+			virtual void DestroyPixelBuffer(int buffer) override;
+			virtual void* GetPixelBufferPointer(int buffer) override;
+			virtual void BindPixelBuffer(int buffer) override;
+			virtual int CreateFence() override;
+			virtual bool IsFenceSignaled(int fence) override;
+			virtual FenceStatus WaitFence(int fence, uint64_t timeout) override;
+			virtual void DestroyFence(int fence) override;
+			virtual int CreateTimerQuery() override;
+			virtual void DestroyTimerQuery(int query) override;
+			virtual void QueryTimestamp(int query) override;
+			virtual bool IsTimerQueryAvailable(int query) override;
+			virtual uint64_t GetTimerQueryResult(int query) override;
 
+		private:
+			std::map<int, unsigned int> m_data;
+			int m_nextID;
 			int m_activeProgram;	
+			std::map<int, void*> m_pixelBufferPointers;
+			std::map<int, void*> m_fences;
 		};
 	}
 }
\ No newline at end of file
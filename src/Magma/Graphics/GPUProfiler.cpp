@@ -0,0 +1,127 @@
+#include "GPUProfiler.hpp"
+
+#include <stdexcept>
+
+Magma::Graphics::GPUProfiler::GPUProfiler(Context & context, size_t latency)
+	: m_context(context)
+{
+	if (latency == 0)
+		throw std::runtime_error("Failed to create GPUProfiler: latency must be at least one frame");
+
+	m_frames.resize(latency + 1);
+	for (auto& f : m_frames)
+	{
+		f.number = 0;
+		f.usedQueries = 0;
+	}
+
+	m_currentFrame = 0;
+	m_frameNumber = 0;
+	m_recording = false;
+	m_frameMilliseconds = 0.0;
+	m_resultsFrame = 0;
+	m_droppedFrames = 0;
+}
+
+Magma::Graphics::GPUProfiler::~GPUProfiler()
+{
+	for (auto& f : m_frames)
+		for (auto q : f.queries)
+			m_context.DestroyTimerQuery(q);
+}
+
+void Magma::Graphics::GPUProfiler::BeginFrame()
+{
+	if (m_recording)
+		throw std::runtime_error("Failed to begin GPUProfiler frame: the last frame wasn't ended");
+
+	m_currentFrame = (m_currentFrame + 1) % m_frames.size();
+	auto& frame = m_frames[m_currentFrame];
+
+	// This slot still holds the frame recorded latency frames ago, read it back before reusing its queries
+	if (frame.number != 0)
+		this->Resolve(frame);
+
+	frame.number = ++m_frameNumber;
+	frame.usedQueries = 0;
+	frame.passes.clear();
+	m_recording = true;
+
+	m_context.QueryTimestamp(frame.queries[this->NextQuery()]);
+	this->NextQuery(); // Reserved for the frame end timestamp
+}
+
+void Magma::Graphics::GPUProfiler::EndFrame()
+{
+	if (!m_recording)
+		throw std::runtime_error("Failed to end GPUProfiler frame: no frame is being recorded");
+	if (!m_passStack.empty())
+		throw std::runtime_error("Failed to end GPUProfiler frame: there are passes which weren't ended");
+
+	auto& frame = m_frames[m_currentFrame];
+	m_context.QueryTimestamp(frame.queries[1]);
+	m_recording = false;
+}
+
+void Magma::Graphics::GPUProfiler::BeginPass(const std::string & name)
+{
+	if (!m_recording)
+		throw std::runtime_error("Failed to begin GPUProfiler pass: no frame is being recorded");
+
+	auto& frame = m_frames[m_currentFrame];
+	Pass pass;
+	pass.name = name;
+	pass.depth = m_passStack.size();
+	pass.begin = this->NextQuery();
+	pass.end = this->NextQuery();
+	m_context.QueryTimestamp(frame.queries[pass.begin]);
+
+	m_passStack.push_back(frame.passes.size());
+	frame.passes.push_back(std::move(pass));
+}
+
+void Magma::Graphics::GPUProfiler::EndPass()
+{
+	if (m_passStack.empty())
+		throw std::runtime_error("Failed to end GPUProfiler pass: no pass is being timed");
+
+	auto& frame = m_frames[m_currentFrame];
+	m_context.QueryTimestamp(frame.queries[frame.passes[m_passStack.back()].end]);
+	m_passStack.pop_back();
+}
+
+size_t Magma::Graphics::GPUProfiler::NextQuery()
+{
+	auto& frame = m_frames[m_currentFrame];
+	if (frame.usedQueries == frame.queries.size())
+		frame.queries.push_back(m_context.CreateTimerQuery());
+	return frame.usedQueries++;
+}
+
+void Magma::Graphics::GPUProfiler::Resolve(Frame & frame)
+{
+	// Queries complete in order, so if the last one is available all of them are
+	if (!m_context.IsTimerQueryAvailable(frame.queries[1]))
+	{
+		++m_droppedFrames;
+		return;
+	}
+
+	auto frameBegin = m_context.GetTimerQueryResult(frame.queries[0]);
+	auto frameEnd = m_context.GetTimerQueryResult(frame.queries[1]);
+	m_frameMilliseconds = (frameEnd - frameBegin) / 1000000.0;
+
+	m_results.resize(frame.passes.size());
+	for (size_t i = 0; i < frame.passes.size(); ++i)
+	{
+		auto& pass = frame.passes[i];
+		auto begin = m_context.GetTimerQueryResult(frame.queries[pass.begin]);
+		auto end = m_context.GetTimerQueryResult(frame.queries[pass.end]);
+
+		m_results[i].name = pass.name;
+		m_results[i].depth = pass.depth;
+		m_results[i].milliseconds = (end - begin) / 1000000.0;
+	}
+
+	m_resultsFrame = frame.number;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Context.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		GPU time spent on a named pass
+		/// </summary>
+		struct GPUPassTiming
+		{
+			/// <summary>
+			///		Pass name
+			/// </summary>
+			std::string name;
+
+			/// <summary>
+			///		Pass nesting depth (0 for top level passes)
+			/// </summary>
+			size_t depth;
+
+			/// <summary>
+			///		GPU time spent on the pass in milliseconds
+			/// </summary>
+			double milliseconds;
+		};
+
+		/// <summary>
+		///		Measures the GPU time spent on named passes using timestamp queries.
+		///		Queries are kept in a ring of frames, so results are only read back a few frames later and never stall the context.
+		/// </summary>
+		class GPUProfiler final
+		{
+		public:
+			/// <summary>
+			///		Creates a new GPU profiler
+			/// </summary>
+			/// <param name="context">Context to profile</param>
+			/// <param name="latency">Number of frames between recording a frame and reading back its results</param>
+			GPUProfiler(Context& context, size_t latency = 4);
+			~GPUProfiler();
+
+			/// <summary>
+			///		Starts recording a new frame and reads back the results of the frame recorded latency frames ago
+			/// </summary>
+			void BeginFrame();
+
+			/// <summary>
+			///		Stops recording the current frame
+			/// </summary>
+			void EndFrame();
+
+			/// <summary>
+			///		Starts timing a pass (passes may be nested)
+			/// </summary>
+			/// <param name="name">Pass name</param>
+			void BeginPass(const std::string& name);
+
+			/// <summary>
+			///		Stops timing the innermost pass
+			/// </summary>
+			void EndPass();
+
+			/// <summary>
+			///		Gets the pass timings of the last frame read back, in the order the passes were started
+			/// </summary>
+			inline const std::vector<GPUPassTiming>& GetResults() const { return m_results; }
+
+			/// <summary>
+			///		Gets the GPU time spent on the whole last frame read back in milliseconds
+			/// </summary>
+			inline double GetFrameMilliseconds() const { return m_frameMilliseconds; }
+
+			/// <summary>
+			///		Gets the number of the last frame read back (frames are numbered from 1, 0 means no frame was read back yet)
+			/// </summary>
+			inline uint64_t GetResultsFrame() const { return m_resultsFrame; }
+
+			/// <summary>
+			///		Gets the number of frames whose results weren't available in time and were discarded
+			/// </summary>
+			inline uint64_t GetDroppedFrameCount() const { return m_droppedFrames; }
+
+		private:
+			struct Pass
+			{
+				std::string name;
+				size_t depth;
+				size_t begin;
+				size_t end;
+			};
+
+			struct Frame
+			{
+				uint64_t number;
+				std::vector<int> queries;
+				size_t usedQueries;
+				std::vector<Pass> passes;
+			};
+
+			size_t NextQuery();
+			void Resolve(Frame& frame);
+
+			Context& m_context;
+
+			std::vector<Frame> m_frames;
+			size_t m_currentFrame;
+			uint64_t m_frameNumber;
+			bool m_recording;
+			std::vector<size_t> m_passStack;
+
+			std::vector<GPUPassTiming> m_results;
+			double m_frameMilliseconds;
+			uint64_t m_resultsFrame;
+			uint64_t m_droppedFrames;
+		};
+
+		/// <summary>
+		///		Times a pass on a GPUProfiler during its lifetime
+		/// </summary>
+		class GPUTimerScope final
+		{
+		public:
+			inline GPUTimerScope(GPUProfiler& profiler, const std::string& name) : m_profiler(profiler) { m_profiler.BeginPass(name); }
+			inline ~GPUTimerScope() { m_profiler.EndPass(); }
+
+			GPUTimerScope(const GPUTimerScope&) = delete;
+			GPUTimerScope& operator=(const GPUTimerScope&) = delete;
+
+		private:
+			GPUProfiler& m_profiler;
+		};
+	}
+}
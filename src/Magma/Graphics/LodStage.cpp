@@ -0,0 +1,59 @@
+#include "LodStage.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Magma::Graphics::LodStage::LodStage(float threshold, float hysteresis)
+{
+	m_threshold = threshold;
+	m_hysteresis = hysteresis;
+	m_drawnCount = 0;
+	m_fullDetailCount = 0;
+	this->SetProjection(800.0f, glm::radians(60.0f));
+}
+
+void Magma::Graphics::LodStage::SetProjection(float viewportHeight, float verticalFov)
+{
+	// Pixels covered by one world unit at a distance of one world unit
+	m_projectionScale = viewportHeight / (2.0f * std::tan(verticalFov * 0.5f));
+}
+
+void Magma::Graphics::LodStage::Process(RenderFrame & frame)
+{
+	m_drawnCount = 0;
+	m_fullDetailCount = 0;
+
+	for (auto i : frame.visibleItems)
+	{
+		auto& item = frame.items[i];
+		if (item.lods == nullptr || item.lodCount == 0)
+		{
+			m_drawnCount += item.count;
+			m_fullDetailCount += item.count;
+			continue;
+		}
+
+		// Errors are in model space, so they are scaled by the largest scale of the model transform
+		auto scale = std::max(glm::length(glm::vec3(item.transform[0])), std::max(glm::length(glm::vec3(item.transform[1])), glm::length(glm::vec3(item.transform[2]))));
+		auto distance = glm::length(item.boundsCenter - frame.cameraPosition) - glm::length(item.boundsExtents);
+
+		size_t lod = 0;
+		if (distance > 0.0f)
+		{
+			auto pixelsPerUnit = scale * m_projectionScale / distance;
+			auto projectedError = [&](size_t l) { return item.lods[l].error * pixelsPerUnit; };
+
+			// Errors grow with each level, so move towards more detail while the current level is too coarse,
+			// then towards less detail while the next level is comfortably under the threshold
+			lod = std::min(item.lod, item.lodCount - 1);
+			while (lod > 0 && projectedError(lod) > m_threshold)
+				--lod;
+			while (lod + 1 < item.lodCount && projectedError(lod + 1) <= m_threshold * (1.0f - m_hysteresis))
+				++lod;
+		}
+
+		item.lod = lod;
+		m_drawnCount += item.lods[lod].count;
+		m_fullDetailCount += item.lods[0].count;
+	}
+}
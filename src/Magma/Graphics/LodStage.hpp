@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Renderer.hpp"
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Chooses the level of detail drawn for each visible item of a render frame.
+		///		Each level's error is projected onto the screen from the distance between the camera and the item's bounds, and the least
+		///		detailed level whose projected error is under a threshold (in pixels) is chosen.
+		///		Moving to a less detailed level needs its error to be under the threshold by a margin, so items near a switching
+		///		distance don't alternate between levels every frame.
+		/// </summary>
+		class LodStage final
+		{
+		public:
+			/// <summary>
+			///		Creates a new LOD stage
+			/// </summary>
+			/// <param name="threshold">Maximum projected error, in pixels</param>
+			/// <param name="hysteresis">Fraction of the threshold a less detailed level's error must be under to switch to it</param>
+			LodStage(float threshold = 1.0f, float hysteresis = 0.25f);
+			~LodStage() = default;
+
+			/// <summary>
+			///		Sets the camera projection used to project errors onto the screen
+			/// </summary>
+			/// <param name="viewportHeight">Viewport height, in pixels</param>
+			/// <param name="verticalFov">Vertical field of view, in radians</param>
+			void SetProjection(float viewportHeight, float verticalFov);
+
+			/// <summary>
+			///		Sets the maximum projected error, in pixels
+			/// </summary>
+			inline void SetThreshold(float threshold) { m_threshold = threshold; }
+
+			/// <summary>
+			///		Chooses the level of detail of the frame's visible items
+			/// </summary>
+			/// <param name="frame">Render frame (already culled)</param>
+			void Process(RenderFrame& frame);
+
+			/// <summary>
+			///		Gets the number of vertices (or indices) drawn by the visible items on the last frame processed
+			/// </summary>
+			inline size_t GetDrawnCount() const { return m_drawnCount; }
+
+			/// <summary>
+			///		Gets the number of vertices (or indices) the visible items would have drawn at full detail on the last frame processed
+			/// </summary>
+			inline size_t GetFullDetailCount() const { return m_fullDetailCount; }
+
+		private:
+			float m_threshold;
+			float m_hysteresis;
+			float m_projectionScale;
+
+			size_t m_drawnCount;
+			size_t m_fullDetailCount;
+		};
+	}
+}
@@ -0,0 +1,99 @@
+#include "Mesh.hpp"
+
+#include "../Core/MappedFile.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+Magma::Graphics::Mesh::Mesh(Context & context, const std::string & path)
+	: m_context(context)
+{
+	MappedFile file(path);
+	auto data = (const unsigned char*)file.GetData();
+
+	MeshFileHeader header;
+	if (file.GetSize() < sizeof(header))
+		throw std::runtime_error("Failed to load Mesh: '" + path + "' is too small to be a cooked mesh");
+	std::memcpy(&header, data, sizeof(header));
+
+	if (header.magic != MeshFileMagic)
+		throw std::runtime_error("Failed to load Mesh: '" + path + "' isn't a cooked mesh");
+	if (header.version != MeshFileVersion)
+		throw std::runtime_error("Failed to load Mesh: '" + path + "' was cooked with an unsupported format version");
+	if (header.attributeCount > MaxMeshAttributes)
+		throw std::runtime_error("Failed to load Mesh: '" + path + "' has too many vertex attributes");
+	if (header.lodCount == 0 || header.lodCount > MaxMeshLods)
+		throw std::runtime_error("Failed to load Mesh: '" + path + "' has an invalid number of levels of detail");
+
+	m_indexType = (IndexType)header.indexType;
+	size_t indexSize;
+	switch (m_indexType)
+	{
+		case IndexType::UShort: indexSize = 2; break;
+		case IndexType::UInt: indexSize = 4; break;
+		default: throw std::runtime_error("Failed to load Mesh: '" + path + "' has an invalid index type");
+	}
+
+	auto vertexDataSize = (uint64_t)header.vertexCount * header.vertexStride;
+	auto indexDataSize = (uint64_t)header.indexCount * indexSize;
+	auto submeshDataSize = (uint64_t)header.submeshCount * header.lodCount * sizeof(MeshFileSubmesh);
+	auto lodDataSize = (uint64_t)header.lodCount * sizeof(MeshFileLod);
+	if (header.vertexDataOffset + vertexDataSize > file.GetSize() ||
+		header.indexDataOffset + indexDataSize > file.GetSize() ||
+		header.submeshDataOffset + submeshDataSize > file.GetSize() ||
+		header.lodDataOffset + lodDataSize > file.GetSize())
+		throw std::runtime_error("Failed to load Mesh: '" + path + "' is truncated");
+
+	m_submeshCount = header.submeshCount;
+	m_submeshes.resize((size_t)header.submeshCount * header.lodCount);
+	if (!m_submeshes.empty())
+		std::memcpy(m_submeshes.data(), data + header.submeshDataOffset, (size_t)submeshDataSize);
+	for (auto& s : m_submeshes)
+		if ((uint64_t)s.firstIndex + s.indexCount > header.indexCount)
+			throw std::runtime_error("Failed to load Mesh: '" + path + "' has a submesh out of the index buffer");
+
+	for (uint32_t i = 0; i < header.lodCount; ++i)
+	{
+		MeshFileLod lod;
+		std::memcpy(&lod, data + header.lodDataOffset + i * sizeof(MeshFileLod), sizeof(lod));
+		if ((uint64_t)lod.firstIndex + lod.indexCount > header.indexCount)
+			throw std::runtime_error("Failed to load Mesh: '" + path + "' has a level of detail out of the index buffer");
+		m_lods.push_back(RenderLod { (int)lod.firstIndex, lod.indexCount, lod.error });
+	}
+	m_positionOffset = glm::vec3(header.positionOffset[0], header.positionOffset[1], header.positionOffset[2]);
+	m_positionScale = glm::vec3(header.positionScale[0], header.positionScale[1], header.positionScale[2]);
+	m_uvOffset = glm::vec2(header.uvOffset[0], header.uvOffset[1]);
+	m_uvScale = glm::vec2(header.uvScale[0], header.uvScale[1]);
+
+	// Upload the vertex and index data straight from the mapped file
+	m_vao = m_context.CreateVertexArray();
+	m_vbo = m_context.CreateStaticVertexBuffer(m_vao, (void*)(data + header.vertexDataOffset), (size_t)vertexDataSize);
+	for (uint32_t i = 0; i < header.attributeCount; ++i)
+	{
+		auto& a = header.attributes[i];
+		m_context.SetVertexAttributePointer(m_vao, m_vbo, a.attribute, a.components, (AttributeType)a.type, a.normalized != 0, header.vertexStride, (const void*)(uintptr_t)a.offset);
+	}
+	m_ibo = m_context.CreateIndexBuffer(m_vao, data + header.indexDataOffset, (size_t)indexDataSize);
+}
+
+Magma::Graphics::Mesh::~Mesh()
+{
+	m_context.DestroyIndexBuffer(m_ibo);
+	m_context.DestroyVertexBuffer(m_vbo);
+	m_context.DestroyVertexArray(m_vao);
+}
+
+void Magma::Graphics::Mesh::Draw(size_t lod) const
+{
+	// The submeshes of a level of detail are contiguous, so they are drawn at once
+	auto& l = m_lods.at(lod);
+	m_context.DrawIndexedVertexArray(m_vao, DrawMode::Triangles, m_indexType, l.first, l.count);
+}
+
+void Magma::Graphics::Mesh::DrawSubmesh(size_t submesh, size_t lod) const
+{
+	if (submesh >= m_submeshCount)
+		throw std::runtime_error("Failed to draw Mesh submesh: submesh index out of range");
+	auto& s = m_submeshes.at(lod * m_submeshCount + submesh);
+	m_context.DrawIndexedVertexArray(m_vao, DrawMode::Triangles, m_indexType, s.firstIndex, s.indexCount);
+}
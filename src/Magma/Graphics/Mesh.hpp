@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Context.hpp"
+#include "MeshFormat.hpp"
+#include "Renderer.hpp"
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		GPU mesh loaded from a cooked mesh file (see MeshFormat.hpp, written by the MeshCooker tool).
+		///		The file is memory mapped and its vertex and index data are uploaded as they are.
+		/// </summary>
+		class Mesh final
+		{
+		public:
+			/// <summary>
+			///		Loads a cooked mesh
+			/// </summary>
+			/// <param name="context">Context where the mesh is uploaded</param>
+			/// <param name="path">Cooked mesh file path</param>
+			Mesh(Context& context, const std::string& path);
+			~Mesh();
+
+			/// <summary>
+			///		Draws every submesh
+			/// </summary>
+			/// <param name="lod">Level of detail drawn</param>
+			void Draw(size_t lod = 0) const;
+
+			/// <summary>
+			///		Draws a single submesh
+			/// </summary>
+			/// <param name="submesh">Submesh index</param>
+			/// <param name="lod">Level of detail drawn</param>
+			void DrawSubmesh(size_t submesh, size_t lod = 0) const;
+
+			/// <summary>
+			///		Gets the number of submeshes (on each level of detail)
+			/// </summary>
+			inline size_t GetSubmeshCount() const { return m_submeshCount; }
+
+			/// <summary>
+			///		Gets the material index of a submesh
+			/// </summary>
+			inline unsigned int GetSubmeshMaterial(size_t submesh) const { return m_submeshes[submesh].material; }
+
+			/// <summary>
+			///		Gets the number of levels of detail
+			/// </summary>
+			inline size_t GetLodCount() const { return m_lods.size(); }
+
+			/// <summary>
+			///		Gets the levels of detail covering the whole mesh (index ranges and errors, to be used by render items)
+			/// </summary>
+			inline const std::vector<RenderLod>& GetLods() const { return m_lods; }
+
+			/// <summary>
+			///		Gets the index type
+			/// </summary>
+			inline IndexType GetIndexType() const { return m_indexType; }
+
+			/// <summary>
+			///		Gets the vertex array ID
+			/// </summary>
+			inline int GetVertexArray() const { return m_vao; }
+
+			/// <summary>
+			///		Gets the offset added to the quantized positions (the minimum corner of the mesh bounds)
+			/// </summary>
+			inline const glm::vec3& GetPositionOffset() const { return m_positionOffset; }
+
+			/// <summary>
+			///		Gets the scale applied to the quantized positions (the size of the mesh bounds)
+			/// </summary>
+			inline const glm::vec3& GetPositionScale() const { return m_positionScale; }
+
+			/// <summary>
+			///		Gets the offset added to the quantized texture coordinates
+			/// </summary>
+			inline const glm::vec2& GetUVOffset() const { return m_uvOffset; }
+
+			/// <summary>
+			///		Gets the scale applied to the quantized texture coordinates
+			/// </summary>
+			inline const glm::vec2& GetUVScale() const { return m_uvScale; }
+
+		private:
+			Context& m_context;
+
+			int m_vao, m_vbo, m_ibo;
+			IndexType m_indexType;
+			size_t m_submeshCount;
+			std::vector<MeshFileSubmesh> m_submeshes;
+			std::vector<RenderLod> m_lods;
+
+			glm::vec3 m_positionOffset;
+			glm::vec3 m_positionScale;
+			glm::vec2 m_uvOffset;
+			glm::vec2 m_uvScale;
+		};
+	}
+}
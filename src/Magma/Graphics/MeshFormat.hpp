@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Magic number at the start of cooked mesh files ("MGMS")
+		/// </summary>
+		constexpr uint32_t MeshFileMagic = 0x534D474D;
+
+		/// <summary>
+		///		Cooked mesh file format version
+		/// </summary>
+		constexpr uint32_t MeshFileVersion = 2;
+
+		/// <summary>
+		///		Maximum number of vertex attributes in a cooked mesh
+		/// </summary>
+		constexpr uint32_t MaxMeshAttributes = 8;
+
+		/// <summary>
+		///		Maximum number of levels of detail in a cooked mesh
+		/// </summary>
+		constexpr uint32_t MaxMeshLods = 8;
+
+		/// <summary>
+		///		Cooked mesh vertex attributes (their values are the shader attribute locations)
+		/// </summary>
+		enum class MeshAttribute
+		{
+			Invalid = -1,
+
+			Position,
+			Normal,
+			Tangent,
+			UV,
+			Color,
+
+			Count
+		};
+
+		/// <summary>
+		///		Describes a vertex attribute in a cooked mesh file
+		/// </summary>
+		struct MeshFileAttribute
+		{
+			int32_t attribute;		// MeshAttribute
+			int32_t type;			// AttributeType
+			uint32_t components;
+			uint32_t normalized;
+			uint32_t offset;		// Offset from the start of the vertex
+		};
+
+		/// <summary>
+		///		Range of indices drawn with a single material in a cooked mesh file
+		/// </summary>
+		struct MeshFileSubmesh
+		{
+			uint32_t firstIndex;
+			uint32_t indexCount;
+			uint32_t material;
+			uint32_t reserved;
+		};
+
+		/// <summary>
+		///		Level of detail in a cooked mesh file (every level shares the vertex buffer and has its own range of the index buffer)
+		/// </summary>
+		struct MeshFileLod
+		{
+			uint32_t firstIndex;
+			uint32_t indexCount;
+			float error;			// Maximum distance between this level's surface and the full detail one, in mesh units
+			uint32_t reserved;
+		};
+
+		/// <summary>
+		///		Cooked mesh file header.
+		///		Cooked meshes are little endian, and their vertex and index data are laid out exactly as they are uploaded to the GPU,
+		///		so they can be memory mapped and uploaded without any parsing.
+		///		Positions and texture coordinates are quantized to 16 bit unsigned normalized integers, which shaders
+		///		scale back with value = offset + quantized * scale.
+		/// </summary>
+		struct MeshFileHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+
+			uint32_t vertexCount;
+			uint32_t vertexStride;
+			uint32_t indexCount;
+			int32_t indexType;		// IndexType
+			uint32_t attributeCount;
+			uint32_t submeshCount;		// Per level of detail
+			uint32_t lodCount;
+			uint32_t reserved;
+			MeshFileAttribute attributes[MaxMeshAttributes];
+
+			float positionOffset[3];
+			float positionScale[3];
+			float uvOffset[2];
+			float uvScale[2];
+
+			// Offsets from the start of the file (16 byte aligned)
+			uint64_t vertexDataOffset;
+			uint64_t indexDataOffset;
+			uint64_t submeshDataOffset;	// Submeshes of the first level of detail, then the second one's, etc
+			uint64_t lodDataOffset;
+		};
+
+		static_assert(sizeof(MeshFileAttribute) == 20, "MeshFileAttribute must have no padding");
+		static_assert(sizeof(MeshFileSubmesh) == 16, "MeshFileSubmesh must have no padding");
+		static_assert(sizeof(MeshFileLod) == 16, "MeshFileLod must have no padding");
+		static_assert(sizeof(MeshFileHeader) == 272, "MeshFileHeader must have no padding");
+	}
+}
@@ -0,0 +1,895 @@
+#include "RecordingContext.hpp"
+
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+static const char* ContextCallNames[] =
+{
+	"CreateShader",
+	"CreateProgram",
+	"LinkProgram",
+	"AttachShader",
+	"DestroyShader",
+	"DestroyProgram",
+	"DetachShader",
+	"CreateStaticVertexBuffer",
+	"CreateDynamicVertexBuffer",
+	"SetDynamicVertexBufferData",
+	"CreateVertexArray",
+	"SetVertexAttributePointer",
+	"DestroyVertexBuffer",
+	"DestroyVertexArray",
+	"CreateIndexBuffer",
+	"DestroyIndexBuffer",
+	"DrawVertexArray",
+	"DrawIndexedVertexArray",
+	"ActivateProgram",
+	"DeactivateProgram",
+	"SetUniform1i",
+	"SetUniform1f",
+	"SetUniform2i",
+	"SetUniform2f",
+	"SetUniform3i",
+	"SetUniform3f",
+	"SetUniform4i",
+	"SetUniform4f",
+	"SetUniform3x3f",
+	"SetUniform4x4f",
+	"SetUniform1iv",
+	"SetUniform1fv",
+	"SetUniform2iv",
+	"SetUniform2fv",
+	"SetUniform3iv",
+	"SetUniform3fv",
+	"SetUniform4iv",
+	"SetUniform4fv",
+	"SetUniform3x3fv",
+	"SetUniform4x4fv",
+	"SetViewport",
+	"CreateFramebuffer",
+	"DestroyFramebuffer",
+	"BindFramebuffer",
+	"FramebufferTexture2D",
+	"FramebufferRenderbuffer",
+	"IsFramebufferComplete",
+	"CreateRenderbuffer",
+	"DestroyRenderbuffer",
+	"SetDrawBuffers",
+	"BlitFramebuffer",
+	"ReadPixels",
+	"CreateTexture2D",
+	"DestroyTexture2D",
+	"ActivateTexture2D",
+	"DeactivateTexture2D",
+	"TextureData2D",
+	"TextureStorage2D",
+	"SetTextureMinFilter",
+	"SetTextureMagFilter",
+	"SetTextureWrapSMode",
+	"SetTextureWrapTMode",
+	"Clear",
+	"InsertBarrier",
+	"SetUnpackAlignment",
+	"TextureSubData2D",
+	"CreatePixelBuffer",
+	"DestroyPixelBuffer",
+	"GetPixelBufferPointer",
+	"BindPixelBuffer",
+	"CreateFence",
+	"IsFenceSignaled",
+	"WaitFence",
+	"DestroyFence",
+	"CreateTimerQuery",
+	"DestroyTimerQuery",
+	"QueryTimestamp",
+	"IsTimerQueryAvailable",
+	"GetTimerQueryResult",
+	"EndFrame",
+};
+
+static_assert(sizeof(ContextCallNames) / sizeof(*ContextCallNames) == (size_t)Magma::Graphics::ContextCall::Count, "Every context call must have a name");
+
+const char * Magma::Graphics::GetContextCallName(ContextCall call)
+{
+	if (call <= ContextCall::Invalid || call >= ContextCall::Count)
+		return "Invalid";
+	return ContextCallNames[(size_t)call];
+}
+
+Magma::Graphics::RecordingContext::RecordingContext(Context & context)
+	: m_context(context)
+{
+	std::memset(&m_currentStatistics, 0, sizeof(m_currentStatistics));
+	std::memset(&m_frameStatistics, 0, sizeof(m_frameStatistics));
+	m_activeProgram = 0;
+	m_unpackAlignment = 4;
+	m_boundPixelBuffer = 0;
+}
+
+Magma::Graphics::RecordingContext::~RecordingContext()
+{
+	this->StopTrace();
+}
+
+void Magma::Graphics::RecordingContext::BeginFrame()
+{
+	std::memset(&m_currentStatistics, 0, sizeof(m_currentStatistics));
+}
+
+void Magma::Graphics::RecordingContext::EndFrame()
+{
+	this->Record(ContextCall::EndFrame);
+	m_frameStatistics = m_currentStatistics;
+	std::memset(&m_currentStatistics, 0, sizeof(m_currentStatistics));
+}
+
+void Magma::Graphics::RecordingContext::StartTrace(const std::string & path)
+{
+	this->StopTrace();
+
+	m_trace.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+	if (!m_trace.is_open())
+		throw std::runtime_error("Failed to start trace on RecordingContext: couldn't open file '" + path + "'");
+
+	m_tracedPayloads.clear();
+	this->WriteBytes(&ContextTraceMagic, sizeof(ContextTraceMagic));
+	this->WriteBytes(&ContextTraceVersion, sizeof(ContextTraceVersion));
+}
+
+void Magma::Graphics::RecordingContext::StopTrace()
+{
+	if (m_trace.is_open())
+		m_trace.close();
+}
+
+template <typename ... TArgs>
+void Magma::Graphics::RecordingContext::Record(ContextCall call, const TArgs& ... args)
+{
+	++m_currentStatistics.calls[(size_t)call];
+
+	if (!m_trace.is_open())
+		return;
+
+	uint16_t id = (uint16_t)call;
+	this->WriteBytes(&id, sizeof(id));
+	int expand[] = { 0, (this->Write(args), 0)... };
+	(void)expand;
+}
+
+void Magma::Graphics::RecordingContext::WriteBytes(const void * data, size_t size)
+{
+	m_trace.write((const char*)data, size);
+}
+
+void Magma::Graphics::RecordingContext::WriteUnsigned(uint64_t value)
+{
+	this->WriteBytes(&value, sizeof(value));
+}
+
+void Magma::Graphics::RecordingContext::Write(const char * string)
+{
+	auto length = std::strlen(string);
+	this->WriteUnsigned(length);
+	this->WriteBytes(string, length);
+}
+
+void Magma::Graphics::RecordingContext::Write(const Data & data)
+{
+	// Payloads are written as their size and key, followed by their contents the first time they are seen.
+	// The key is the payload's hash, or the next free one if another payload with different contents already has it
+	if (data.pointer == nullptr || data.size == 0)
+	{
+		this->WriteUnsigned(0);
+		return;
+	}
+
+	// FNV-1a
+	uint64_t hash = 0xCBF29CE484222325;
+	auto bytes = (const unsigned char*)data.pointer;
+	for (size_t i = 0; i < data.size; ++i)
+		hash = (hash ^ bytes[i]) * 0x100000001B3;
+	hash ^= data.size;
+
+	auto key = hash;
+	bool stored = false;
+	for (;; ++key)
+	{
+		auto it = m_tracedPayloads.find(key);
+		if (it == m_tracedPayloads.end())
+		{
+			stored = true;
+			break;
+		}
+		if (this->IsTracedPayload(it->second.offset, it->second.size, data))
+			break;
+	}
+
+	this->WriteUnsigned(data.size);
+	this->WriteUnsigned(key);
+	this->Write(stored);
+	if (stored)
+	{
+		m_tracedPayloads[key] = TracedPayload { (uint64_t)m_trace.tellp(), data.size };
+		this->WriteBytes(data.pointer, data.size);
+	}
+}
+
+bool Magma::Graphics::RecordingContext::IsTracedPayload(uint64_t offset, size_t size, const Data & data)
+{
+	if (size != data.size)
+		return false;
+
+	// Reading moves the shared file position, so writing resumes from the end afterwards
+	auto end = m_trace.tellp();
+	m_payloadScratch.resize(size);
+	m_trace.seekg(offset);
+	m_trace.read((char*)m_payloadScratch.data(), size);
+	m_trace.seekp(end);
+	if (!m_trace)
+		throw std::runtime_error("Failed to write trace on RecordingContext: couldn't read back a stored payload");
+	return std::memcmp(m_payloadScratch.data(), data.pointer, size) == 0;
+}
+
+void Magma::Graphics::RecordingContext::Write(const PixelData & data)
+{
+	// When a pixel buffer is bound the pointer is an offset into it, so the payload is read from its mapped memory
+	if (m_boundPixelBuffer != 0)
+	{
+		auto offset = (uint64_t)(uintptr_t)data.pointer;
+		auto mapped = (const char*)m_context.GetPixelBufferPointer(m_boundPixelBuffer);
+		this->Write(true);
+		this->WriteUnsigned(offset);
+		this->Write(Data { mapped + offset, data.size });
+	}
+	else
+	{
+		this->Write(false);
+		this->Write(Data { data.pointer, data.size });
+	}
+}
+
+void Magma::Graphics::RecordingContext::Write(bool value)
+{
+	uint8_t v = value ? 1 : 0;
+	this->WriteBytes(&v, sizeof(v));
+}
+
+void Magma::Graphics::RecordingContext::Write(int value)
+{
+	int32_t v = value;
+	this->WriteBytes(&v, sizeof(v));
+}
+
+void Magma::Graphics::RecordingContext::Write(unsigned int value)
+{
+	this->WriteUnsigned(value);
+}
+
+void Magma::Graphics::RecordingContext::Write(unsigned long value)
+{
+	this->WriteUnsigned(value);
+}
+
+void Magma::Graphics::RecordingContext::Write(unsigned long long value)
+{
+	this->WriteUnsigned(value);
+}
+
+void Magma::Graphics::RecordingContext::Write(float value)
+{
+	this->WriteBytes(&value, sizeof(value));
+}
+
+void Magma::Graphics::RecordingContext::Write(const glm::ivec2 & vec)
+{
+	this->WriteBytes(&vec[0], sizeof(int32_t) * 2);
+}
+
+void Magma::Graphics::RecordingContext::Write(const glm::vec2 & vec)
+{
+	this->WriteBytes(&vec[0], sizeof(float) * 2);
+}
+
+void Magma::Graphics::RecordingContext::Write(const glm::ivec3 & vec)
+{
+	this->WriteBytes(&vec[0], sizeof(int32_t) * 3);
+}
+
+void Magma::Graphics::RecordingContext::Write(const glm::vec3 & vec)
+{
+	this->WriteBytes(&vec[0], sizeof(float) * 3);
+}
+
+void Magma::Graphics::RecordingContext::Write(const glm::ivec4 & vec)
+{
+	this->WriteBytes(&vec[0], sizeof(int32_t) * 4);
+}
+
+void Magma::Graphics::RecordingContext::Write(const glm::vec4 & vec)
+{
+	this->WriteBytes(&vec[0], sizeof(float) * 4);
+}
+
+void Magma::Graphics::RecordingContext::Write(const glm::mat3 & mat)
+{
+	this->WriteBytes(&mat[0][0], sizeof(float) * 9);
+}
+
+void Magma::Graphics::RecordingContext::Write(const glm::mat4 & mat)
+{
+	this->WriteBytes(&mat[0][0], sizeof(float) * 16);
+}
+
+size_t Magma::Graphics::RecordingContext::GetPixelDataSize(size_t width, size_t height, PixelFormat format, PixelType type, int alignment) const
+{
+	size_t components, bytes;
+
+	switch (format)
+	{
+		case PixelFormat::R: components = 1; break;
+		case PixelFormat::RG: components = 2; break;
+		case PixelFormat::RGB: components = 3; break;
+		case PixelFormat::BGR: components = 3; break;
+		case PixelFormat::RGBA: components = 4; break;
+		case PixelFormat::BGRA: components = 4; break;
+		case PixelFormat::DepthComponent: components = 1; break;
+		default: return 0;
+	}
+
+	switch (type)
+	{
+		case PixelType::UByte: bytes = 1; break;
+		case PixelType::Byte: bytes = 1; break;
+		case PixelType::UShort: bytes = 2; break;
+		case PixelType::Short: bytes = 2; break;
+		case PixelType::UInt: bytes = 4; break;
+		case PixelType::Int: bytes = 4; break;
+		case PixelType::Float: bytes = 4; break;
+		default: return 0;
+	}
+
+	if (width == 0 || height == 0)
+		return 0;
+
+	// Every row but the last is padded to the alignment
+	size_t row = width * components * bytes;
+	size_t paddedRow = (row + alignment - 1) / alignment * alignment;
+	return paddedRow * (height - 1) + row;
+}
+
+int Magma::Graphics::RecordingContext::CreateShader(ShaderType type, const char * src)
+{
+	auto shader = m_context.CreateShader(type, src);
+	this->Record(ContextCall::CreateShader, type, src, shader);
+	return shader;
+}
+
+int Magma::Graphics::RecordingContext::CreateProgram()
+{
+	auto program = m_context.CreateProgram();
+	this->Record(ContextCall::CreateProgram, program);
+	return program;
+}
+
+void Magma::Graphics::RecordingContext::LinkProgram(int program)
+{
+	m_context.LinkProgram(program);
+	this->Record(ContextCall::LinkProgram, program);
+}
+
+void Magma::Graphics::RecordingContext::AttachShader(int program, int shader)
+{
+	m_context.AttachShader(program, shader);
+	this->Record(ContextCall::AttachShader, program, shader);
+}
+
+void Magma::Graphics::RecordingContext::DestroyShader(int shader)
+{
+	m_context.DestroyShader(shader);
+	this->Record(ContextCall::DestroyShader, shader);
+}
+
+void Magma::Graphics::RecordingContext::DestroyProgram(int program)
+{
+	m_context.DestroyProgram(program);
+	this->Record(ContextCall::DestroyProgram, program);
+}
+
+void Magma::Graphics::RecordingContext::DetachShader(int program, int shader)
+{
+	m_context.DetachShader(program, shader);
+	this->Record(ContextCall::DetachShader, program, shader);
+}
+
+int Magma::Graphics::RecordingContext::CreateStaticVertexBuffer(int vao, void * data, size_t size)
+{
+	auto vbo = m_context.CreateStaticVertexBuffer(vao, data, size);
+	m_currentStatistics.bufferBytes += size;
+	this->Record(ContextCall::CreateStaticVertexBuffer, vao, Data { data, size }, size, vbo);
+	return vbo;
+}
+
+int Magma::Graphics::RecordingContext::CreateDynamicVertexBuffer(int vao, void * data, size_t size)
+{
+	auto vbo = m_context.CreateDynamicVertexBuffer(vao, data, size);
+	if (data != nullptr)
+		m_currentStatistics.bufferBytes += size;
+	this->Record(ContextCall::CreateDynamicVertexBuffer, vao, Data { data, size }, size, vbo);
+	return vbo;
+}
+
+void Magma::Graphics::RecordingContext::SetDynamicVertexBufferData(int vao, int vbo, void * data, size_t size)
+{
+	m_context.SetDynamicVertexBufferData(vao, vbo, data, size);
+	m_currentStatistics.bufferBytes += size;
+	this->Record(ContextCall::SetDynamicVertexBufferData, vao, vbo, Data { data, size }, size);
+}
+
+int Magma::Graphics::RecordingContext::CreateVertexArray()
+{
+	auto vao = m_context.CreateVertexArray();
+	this->Record(ContextCall::CreateVertexArray, vao);
+	return vao;
+}
+
+void Magma::Graphics::RecordingContext::SetVertexAttributePointer(int vao, int vbo, int index, int size, AttributeType type, bool normalized, size_t stride, const void * offset)
+{
+	m_context.SetVertexAttributePointer(vao, vbo, index, size, type, normalized, stride, offset);
+	this->Record(ContextCall::SetVertexAttributePointer, vao, vbo, index, size, type, normalized, stride, (uint64_t)(uintptr_t)offset);
+}
+
+void Magma::Graphics::RecordingContext::DestroyVertexBuffer(int vbo)
+{
+	m_context.DestroyVertexBuffer(vbo);
+	this->Record(ContextCall::DestroyVertexBuffer, vbo);
+}
+
+void Magma::Graphics::RecordingContext::DestroyVertexArray(int vao)
+{
+	m_context.DestroyVertexArray(vao);
+	this->Record(ContextCall::DestroyVertexArray, vao);
+}
+
+int Magma::Graphics::RecordingContext::CreateIndexBuffer(int vao, const void * data, size_t size)
+{
+	auto ibo = m_context.CreateIndexBuffer(vao, data, size);
+	m_currentStatistics.bufferBytes += size;
+	this->Record(ContextCall::CreateIndexBuffer, vao, Data { data, size }, size, ibo);
+	return ibo;
+}
+
+void Magma::Graphics::RecordingContext::DestroyIndexBuffer(int ibo)
+{
+	m_context.DestroyIndexBuffer(ibo);
+	this->Record(ContextCall::DestroyIndexBuffer, ibo);
+}
+
+void Magma::Graphics::RecordingContext::DrawVertexArray(int vao, DrawMode mode, int first, size_t count)
+{
+	m_context.DrawVertexArray(vao, mode, first, count);
+	++m_currentStatistics.drawCalls;
+	m_currentStatistics.vertices += count;
+	this->Record(ContextCall::DrawVertexArray, vao, mode, first, count);
+}
+
+void Magma::Graphics::RecordingContext::DrawIndexedVertexArray(int vao, DrawMode mode, IndexType type, size_t first, size_t count)
+{
+	m_context.DrawIndexedVertexArray(vao, mode, type, first, count);
+	++m_currentStatistics.drawCalls;
+	m_currentStatistics.vertices += count;
+	this->Record(ContextCall::DrawIndexedVertexArray, vao, mode, type, first, count);
+}
+
+void Magma::Graphics::RecordingContext::ActivateProgram(int program)
+{
+	m_context.ActivateProgram(program);
+	if (program != m_activeProgram)
+		++m_currentStatistics.programSwitches;
+	m_activeProgram = program;
+	this->Record(ContextCall::ActivateProgram, program);
+}
+
+void Magma::Graphics::RecordingContext::DeactivateProgram(int program)
+{
+	m_context.DeactivateProgram(program);
+	m_activeProgram = 0;
+	this->Record(ContextCall::DeactivateProgram, program);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform1i(int index, int value)
+{
+	m_context.SetUniform1i(index, value);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform1i, index, value);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform1f(int index, float value)
+{
+	m_context.SetUniform1f(index, value);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform1f, index, value);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform2i(int index, const glm::ivec2 & vec)
+{
+	m_context.SetUniform2i(index, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform2i, index, vec);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform2f(int index, const glm::vec2 & vec)
+{
+	m_context.SetUniform2f(index, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform2f, index, vec);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform3i(int index, const glm::ivec3 & vec)
+{
+	m_context.SetUniform3i(index, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform3i, index, vec);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform3f(int index, const glm::vec3 & vec)
+{
+	m_context.SetUniform3f(index, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform3f, index, vec);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform4i(int index, const glm::ivec4 & vec)
+{
+	m_context.SetUniform4i(index, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform4i, index, vec);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform4f(int index, const glm::vec4 & vec)
+{
+	m_context.SetUniform4f(index, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform4f, index, vec);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform3x3f(int index, const glm::mat3 & mat)
+{
+	m_context.SetUniform3x3f(index, mat);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform3x3f, index, mat);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform4x4f(int index, const glm::mat4 & mat)
+{
+	m_context.SetUniform4x4f(index, mat);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform4x4f, index, mat);
+}
+
+void Magma::Graphics::RecordingContext::SetUniform1iv(int index, size_t count, int * value)
+{
+	m_context.SetUniform1iv(index, count, value);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform1iv, index, count, Data { value, sizeof(int) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetUniform1fv(int index, size_t count, float * value)
+{
+	m_context.SetUniform1fv(index, count, value);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform1fv, index, count, Data { value, sizeof(float) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetUniform2iv(int index, size_t count, const glm::ivec2 * vec)
+{
+	m_context.SetUniform2iv(index, count, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform2iv, index, count, Data { vec, sizeof(glm::ivec2) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetUniform2fv(int index, size_t count, const glm::vec2 * vec)
+{
+	m_context.SetUniform2fv(index, count, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform2fv, index, count, Data { vec, sizeof(glm::vec2) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetUniform3iv(int index, size_t count, const glm::ivec3 * vec)
+{
+	m_context.SetUniform3iv(index, count, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform3iv, index, count, Data { vec, sizeof(glm::ivec3) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetUniform3fv(int index, size_t count, const glm::vec3 * vec)
+{
+	m_context.SetUniform3fv(index, count, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform3fv, index, count, Data { vec, sizeof(glm::vec3) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetUniform4iv(int index, size_t count, const glm::ivec4 * vec)
+{
+	m_context.SetUniform4iv(index, count, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform4iv, index, count, Data { vec, sizeof(glm::ivec4) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetUniform4fv(int index, size_t count, const glm::vec4 * vec)
+{
+	m_context.SetUniform4fv(index, count, vec);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform4fv, index, count, Data { vec, sizeof(glm::vec4) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetUniform3x3fv(int index, size_t count, const glm::mat3 * mat)
+{
+	m_context.SetUniform3x3fv(index, count, mat);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform3x3fv, index, count, Data { mat, sizeof(glm::mat3) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetUniform4x4fv(int index, size_t count, const glm::mat4 * mat)
+{
+	m_context.SetUniform4x4fv(index, count, mat);
+	++m_currentStatistics.uniformUploads;
+	this->Record(ContextCall::SetUniform4x4fv, index, count, Data { mat, sizeof(glm::mat4) * count });
+}
+
+void Magma::Graphics::RecordingContext::SetViewport(float x, float y, float width, float height)
+{
+	m_context.SetViewport(x, y, width, height);
+	this->Record(ContextCall::SetViewport, x, y, width, height);
+}
+
+int Magma::Graphics::RecordingContext::CreateFramebuffer()
+{
+	auto framebuffer = m_context.CreateFramebuffer();
+	this->Record(ContextCall::CreateFramebuffer, framebuffer);
+	return framebuffer;
+}
+
+void Magma::Graphics::RecordingContext::DestroyFramebuffer(int framebuffer)
+{
+	m_context.DestroyFramebuffer(framebuffer);
+	this->Record(ContextCall::DestroyFramebuffer, framebuffer);
+}
+
+void Magma::Graphics::RecordingContext::BindFramebuffer(FramebufferTarget target, int framebuffer)
+{
+	m_context.BindFramebuffer(target, framebuffer);
+	++m_currentStatistics.framebufferBinds;
+	this->Record(ContextCall::BindFramebuffer, target, framebuffer);
+}
+
+void Magma::Graphics::RecordingContext::FramebufferTexture2D(FramebufferTarget target, FramebufferAttachment attachment, int texture, int level)
+{
+	m_context.FramebufferTexture2D(target, attachment, texture, level);
+	this->Record(ContextCall::FramebufferTexture2D, target, attachment, texture, level);
+}
+
+void Magma::Graphics::RecordingContext::FramebufferRenderbuffer(FramebufferTarget target, FramebufferAttachment attachment, int renderbuffer)
+{
+	m_context.FramebufferRenderbuffer(target, attachment, renderbuffer);
+	this->Record(ContextCall::FramebufferRenderbuffer, target, attachment, renderbuffer);
+}
+
+bool Magma::Graphics::RecordingContext::IsFramebufferComplete(FramebufferTarget target)
+{
+	auto complete = m_context.IsFramebufferComplete(target);
+	this->Record(ContextCall::IsFramebufferComplete, target);
+	return complete;
+}
+
+int Magma::Graphics::RecordingContext::CreateRenderbuffer(TargetFormat format, size_t width, size_t height, size_t samples)
+{
+	auto renderbuffer = m_context.CreateRenderbuffer(format, width, height, samples);
+	this->Record(ContextCall::CreateRenderbuffer, format, width, height, samples, renderbuffer);
+	return renderbuffer;
+}
+
+void Magma::Graphics::RecordingContext::DestroyRenderbuffer(int renderbuffer)
+{
+	m_context.DestroyRenderbuffer(renderbuffer);
+	this->Record(ContextCall::DestroyRenderbuffer, renderbuffer);
+}
+
+void Magma::Graphics::RecordingContext::SetDrawBuffers(size_t count, FramebufferAttachment * attachments)
+{
+	m_context.SetDrawBuffers(count, attachments);
+	this->Record(ContextCall::SetDrawBuffers, count);
+	if (m_trace.is_open())
+		for (size_t i = 0; i < count; ++i)
+			this->Write(attachments[i]);
+}
+
+void Magma::Graphics::RecordingContext::BlitFramebuffer(int srcX0, int srcY0, int srcX1, int srcY1, int dstX0, int dstY0, int dstX1, int dstY1, BufferBit mask, Filter filter)
+{
+	m_context.BlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+	this->Record(ContextCall::BlitFramebuffer, srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+}
+
+void Magma::Graphics::RecordingContext::ReadPixels(int x, int y, size_t width, size_t height, PixelFormat format, PixelType type, void * data)
+{
+	m_context.ReadPixels(x, y, width, height, format, type, data);
+	this->Record(ContextCall::ReadPixels, x, y, width, height, format, type, this->GetPixelDataSize(width, height, format, type, 1));
+}
+
+int Magma::Graphics::RecordingContext::CreateTexture2D()
+{
+	auto texture = m_context.CreateTexture2D();
+	this->Record(ContextCall::CreateTexture2D, texture);
+	return texture;
+}
+
+void Magma::Graphics::RecordingContext::DestroyTexture2D(int texture)
+{
+	m_context.DestroyTexture2D(texture);
+	this->Record(ContextCall::DestroyTexture2D, texture);
+}
+
+void Magma::Graphics::RecordingContext::ActivateTexture2D(int texture, int slot)
+{
+	m_context.ActivateTexture2D(texture, slot);
+	++m_currentStatistics.textureBinds;
+	this->Record(ContextCall::ActivateTexture2D, texture, slot);
+}
+
+void Magma::Graphics::RecordingContext::DeactivateTexture2D(int texture, int slot)
+{
+	m_context.DeactivateTexture2D(texture, slot);
+	this->Record(ContextCall::DeactivateTexture2D, texture, slot);
+}
+
+void Magma::Graphics::RecordingContext::TextureData2D(int level, PixelFormat internalFormat, size_t width, size_t height, PixelFormat format, PixelType type, void * data)
+{
+	m_context.TextureData2D(level, internalFormat, width, height, format, type, data);
+	auto size = (data != nullptr || m_boundPixelBuffer != 0) ? this->GetPixelDataSize(width, height, format, type, m_unpackAlignment) : 0;
+	m_currentStatistics.textureBytes += size;
+	this->Record(ContextCall::TextureData2D, level, internalFormat, width, height, format, type, PixelData { data, size });
+}
+
+void Magma::Graphics::RecordingContext::TextureStorage2D(size_t levels, TargetFormat format, size_t width, size_t height)
+{
+	m_context.TextureStorage2D(levels, format, width, height);
+	this->Record(ContextCall::TextureStorage2D, levels, format, width, height);
+}
+
+void Magma::Graphics::RecordingContext::SetTextureMinFilter(Filter filter)
+{
+	m_context.SetTextureMinFilter(filter);
+	this->Record(ContextCall::SetTextureMinFilter, filter);
+}
+
+void Magma::Graphics::RecordingContext::SetTextureMagFilter(Filter filter)
+{
+	m_context.SetTextureMagFilter(filter);
+	this->Record(ContextCall::SetTextureMagFilter, filter);
+}
+
+void Magma::Graphics::RecordingContext::SetTextureWrapSMode(WrapMode mode)
+{
+	m_context.SetTextureWrapSMode(mode);
+	this->Record(ContextCall::SetTextureWrapSMode, mode);
+}
+
+void Magma::Graphics::RecordingContext::SetTextureWrapTMode(WrapMode mode)
+{
+	m_context.SetTextureWrapTMode(mode);
+	this->Record(ContextCall::SetTextureWrapTMode, mode);
+}
+
+void Magma::Graphics::RecordingContext::Clear(BufferBit mask)
+{
+	m_context.Clear(mask);
+	this->Record(ContextCall::Clear, mask);
+}
+
+void Magma::Graphics::RecordingContext::InsertBarrier(BarrierBit barriers)
+{
+	m_context.InsertBarrier(barriers);
+	this->Record(ContextCall::InsertBarrier, barriers);
+}
+
+void Magma::Graphics::RecordingContext::SetUnpackAlignment(int alignment)
+{
+	m_context.SetUnpackAlignment(alignment);
+	m_unpackAlignment = alignment;
+	this->Record(ContextCall::SetUnpackAlignment, alignment);
+}
+
+void Magma::Graphics::RecordingContext::TextureSubData2D(int level, size_t x, size_t y, size_t width, size_t height, PixelFormat format, PixelType type, const void * data)
+{
+	m_context.TextureSubData2D(level, x, y, width, height, format, type, data);
+	auto size = this->GetPixelDataSize(width, height, format, type, m_unpackAlignment);
+	m_currentStatistics.textureBytes += size;
+	this->Record(ContextCall::TextureSubData2D, level, x, y, width, height, format, type, PixelData { data, size });
+}
+
+int Magma::Graphics::RecordingContext::CreatePixelBuffer(size_t size)
+{
+	auto buffer = m_context.CreatePixelBuffer(size);
+	this->Record(ContextCall::CreatePixelBuffer, size, buffer);
+	return buffer;
+}
+
+void Magma::Graphics::RecordingContext::DestroyPixelBuffer(int buffer)
+{
+	m_context.DestroyPixelBuffer(buffer);
+	this->Record(ContextCall::DestroyPixelBuffer, buffer);
+}
+
+void * Magma::Graphics::RecordingContext::GetPixelBufferPointer(int buffer)
+{
+	auto pointer = m_context.GetPixelBufferPointer(buffer);
+	this->Record(ContextCall::GetPixelBufferPointer, buffer);
+	return pointer;
+}
+
+void Magma::Graphics::RecordingContext::BindPixelBuffer(int buffer)
+{
+	m_context.BindPixelBuffer(buffer);
+	m_boundPixelBuffer = buffer;
+	this->Record(ContextCall::BindPixelBuffer, buffer);
+}
+
+int Magma::Graphics::RecordingContext::CreateFence()
+{
+	auto fence = m_context.CreateFence();
+	this->Record(ContextCall::CreateFence, fence);
+	return fence;
+}
+
+bool Magma::Graphics::RecordingContext::IsFenceSignaled(int fence)
+{
+	auto signaled = m_context.IsFenceSignaled(fence);
+	this->Record(ContextCall::IsFenceSignaled, fence);
+	return signaled;
+}
+
+Magma::Graphics::FenceStatus Magma::Graphics::RecordingContext::WaitFence(int fence, uint64_t timeout)
+{
+	auto status = m_context.WaitFence(fence, timeout);
+	this->Record(ContextCall::WaitFence, fence, timeout);
+	return status;
+}
+
+void Magma::Graphics::RecordingContext::DestroyFence(int fence)
+{
+	m_context.DestroyFence(fence);
+	this->Record(ContextCall::DestroyFence, fence);
+}
+
+int Magma::Graphics::RecordingContext::CreateTimerQuery()
+{
+	auto query = m_context.CreateTimerQuery();
+	this->Record(ContextCall::CreateTimerQuery, query);
+	return query;
+}
+
+void Magma::Graphics::RecordingContext::DestroyTimerQuery(int query)
+{
+	m_context.DestroyTimerQuery(query);
+	this->Record(ContextCall::DestroyTimerQuery, query);
+}
+
+void Magma::Graphics::RecordingContext::QueryTimestamp(int query)
+{
+	m_context.QueryTimestamp(query);
+	this->Record(ContextCall::QueryTimestamp, query);
+}
+
+bool Magma::Graphics::RecordingContext::IsTimerQueryAvailable(int query)
+{
+	auto available = m_context.IsTimerQueryAvailable(query);
+	this->Record(ContextCall::IsTimerQueryAvailable, query);
+	return available;
+}
+
+uint64_t Magma::Graphics::RecordingContext::GetTimerQueryResult(int query)
+{
+	auto result = m_context.GetTimerQueryResult(query);
+	this->Record(ContextCall::GetTimerQueryResult, query);
+	return result;
+}
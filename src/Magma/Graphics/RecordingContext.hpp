@@ -0,0 +1,383 @@
+#pragma once
+
+#include "Context.hpp"
+
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Magic number at the start of context trace files ("MGTR")
+		/// </summary>
+		constexpr uint32_t ContextTraceMagic = 0x5254474D;
+
+		/// <summary>
+		///		Context trace file format version
+		/// </summary>
+		constexpr uint32_t ContextTraceVersion = 3;
+
+		/// <summary>
+		///		Context calls (used to index call counters and to tag trace records)
+		/// </summary>
+		enum class ContextCall
+		{
+			Invalid = -1,
+
+			CreateShader,
+			CreateProgram,
+			LinkProgram,
+			AttachShader,
+			DestroyShader,
+			DestroyProgram,
+			DetachShader,
+			CreateStaticVertexBuffer,
+			CreateDynamicVertexBuffer,
+			SetDynamicVertexBufferData,
+			CreateVertexArray,
+			SetVertexAttributePointer,
+			DestroyVertexBuffer,
+			DestroyVertexArray,
+			CreateIndexBuffer,
+			DestroyIndexBuffer,
+			DrawVertexArray,
+			DrawIndexedVertexArray,
+			ActivateProgram,
+			DeactivateProgram,
+			SetUniform1i,
+			SetUniform1f,
+			SetUniform2i,
+			SetUniform2f,
+			SetUniform3i,
+			SetUniform3f,
+			SetUniform4i,
+			SetUniform4f,
+			SetUniform3x3f,
+			SetUniform4x4f,
+			SetUniform1iv,
+			SetUniform1fv,
+			SetUniform2iv,
+			SetUniform2fv,
+			SetUniform3iv,
+			SetUniform3fv,
+			SetUniform4iv,
+			SetUniform4fv,
+			SetUniform3x3fv,
+			SetUniform4x4fv,
+			SetViewport,
+			CreateFramebuffer,
+			DestroyFramebuffer,
+			BindFramebuffer,
+			FramebufferTexture2D,
+			FramebufferRenderbuffer,
+			IsFramebufferComplete,
+			CreateRenderbuffer,
+			DestroyRenderbuffer,
+			SetDrawBuffers,
+			BlitFramebuffer,
+			ReadPixels,
+			CreateTexture2D,
+			DestroyTexture2D,
+			ActivateTexture2D,
+			DeactivateTexture2D,
+			TextureData2D,
+			TextureStorage2D,
+			SetTextureMinFilter,
+			SetTextureMagFilter,
+			SetTextureWrapSMode,
+			SetTextureWrapTMode,
+			Clear,
+			InsertBarrier,
+			SetUnpackAlignment,
+			TextureSubData2D,
+			CreatePixelBuffer,
+			DestroyPixelBuffer,
+			GetPixelBufferPointer,
+			BindPixelBuffer,
+			CreateFence,
+			IsFenceSignaled,
+			WaitFence,
+			DestroyFence,
+			CreateTimerQuery,
+			DestroyTimerQuery,
+			QueryTimestamp,
+			IsTimerQueryAvailable,
+			GetTimerQueryResult,
+
+			/// <summary>
+			///		Not a context call, marks the end of a frame in traces
+			/// </summary>
+			EndFrame,
+
+			Count
+		};
+
+		/// <summary>
+		///		Gets the name of a context call
+		/// </summary>
+		/// <param name="call">Context call</param>
+		/// <returns>Call name</returns>
+		const char* GetContextCallName(ContextCall call);
+
+		/// <summary>
+		///		Counters of the work submitted to a context
+		/// </summary>
+		struct ContextStatistics
+		{
+			/// <summary>
+			///		Number of times each context call was made
+			/// </summary>
+			size_t calls[(size_t)ContextCall::Count];
+
+			/// <summary>
+			///		Number of draw calls
+			/// </summary>
+			size_t drawCalls;
+
+			/// <summary>
+			///		Number of vertices drawn
+			/// </summary>
+			size_t vertices;
+
+			/// <summary>
+			///		Number of times the active program changed to a different one
+			/// </summary>
+			size_t programSwitches;
+
+			/// <summary>
+			///		Number of textures bound
+			/// </summary>
+			size_t textureBinds;
+
+			/// <summary>
+			///		Number of uniform uploads
+			/// </summary>
+			size_t uniformUploads;
+
+			/// <summary>
+			///		Number of framebuffer binds
+			/// </summary>
+			size_t framebufferBinds;
+
+			/// <summary>
+			///		Number of bytes uploaded into buffers
+			/// </summary>
+			size_t bufferBytes;
+
+			/// <summary>
+			///		Number of bytes uploaded into textures
+			/// </summary>
+			size_t textureBytes;
+
+			/// <summary>
+			///		Gets the number of times a context call was made
+			/// </summary>
+			inline size_t GetCallCount(ContextCall call) const { return calls[(size_t)call]; }
+		};
+
+		/// <summary>
+		///		Context decorator which forwards every call to another context while counting the work submitted each frame.
+		///		It can also write every call into a binary trace file, which can be played back with a TracePlayer.
+		///		Buffer and texture payloads are stored in the trace only the first time their contents are seen
+		///		(payloads with the same hash are compared with the stored contents, so hash collisions are never merged).
+		/// </summary>
+		class RecordingContext final : public Context
+		{
+		public:
+			/// <summary>
+			///		Creates a new recording context
+			/// </summary>
+			/// <param name="context">Context where the calls are forwarded to</param>
+			RecordingContext(Context& context);
+			virtual ~RecordingContext();
+
+			/// <summary>
+			///		Resets the current frame counters
+			/// </summary>
+			void BeginFrame();
+
+			/// <summary>
+			///		Ends the current frame, making its counters available through GetFrameStatistics
+			/// </summary>
+			void EndFrame();
+
+			/// <summary>
+			///		Gets the counters of the last frame ended
+			/// </summary>
+			inline const ContextStatistics& GetFrameStatistics() const { return m_frameStatistics; }
+
+			/// <summary>
+			///		Gets the counters of the frame being recorded
+			/// </summary>
+			inline const ContextStatistics& GetCurrentStatistics() const { return m_currentStatistics; }
+
+			/// <summary>
+			///		Starts writing every call into a binary trace file.
+			///		Only objects created after the trace starts can be played back, so traces should be started before any resources are created.
+			/// </summary>
+			/// <param name="path">Trace file path</param>
+			void StartTrace(const std::string& path);
+
+			/// <summary>
+			///		Stops writing the trace file
+			/// </summary>
+			void StopTrace();
+
+			inline bool IsTracing() const { return m_trace.is_open(); }
+
+			// Inherited via Context
+			virtual int CreateShader(ShaderType type, const char * src) override;
+			virtual int CreateProgram() override;
+			virtual void LinkProgram(int program) override;
+			virtual void AttachShader(int program, int shader) override;
+			virtual void DestroyShader(int shader) override;
+			virtual void DestroyProgram(int program) override;
+			virtual void DetachShader(int program, int shader) override;
+			virtual int CreateStaticVertexBuffer(int vao, void * data, size_t size) override;
+			virtual int CreateDynamicVertexBuffer(int vao, void* data, size_t size) override;
+			virtual void SetDynamicVertexBufferData(int vao, int vbo, void* data, size_t size) override;
+			virtual int CreateVertexArray() override;
+			virtual void SetVertexAttributePointer(int vao, int vbo, int index, int size, AttributeType type, bool normalized, size_t stride, const void * offset) override;
+			virtual void DestroyVertexBuffer(int vbo) override;
+			virtual void DestroyVertexArray(int vao) override;
+			virtual int CreateIndexBuffer(int vao, const void* data, size_t size) override;
+			virtual void DestroyIndexBuffer(int ibo) override;
+			virtual void DrawVertexArray(int vao, DrawMode mode, int first, size_t count) override;
+			virtual void DrawIndexedVertexArray(int vao, DrawMode mode, IndexType type, size_t first, size_t count) override;
+			virtual void ActivateProgram(int program) override;
+			virtual void DeactivateProgram(int program) override;
+			virtual void SetUniform1i(int index, int value) override;
+			virtual void SetUniform1f(int index, float value) override;
+			virtual void SetUniform2i(int index, const glm::ivec2 & vec) override;
+			virtual void SetUniform2f(int index, const glm::vec2 & vec) override;
+			virtual void SetUniform3i(int index, const glm::ivec3 & vec) override;
+			virtual void SetUniform3f(int index, const glm::vec3 & vec) override;
+			virtual void SetUniform4i(int index, const glm::ivec4 & vec) override;
+			virtual void SetUniform4f(int index, const glm::vec4 & vec) override;
+			virtual void SetUniform3x3f(int index, const glm::mat3 & mat) override;
+			virtual void SetUniform4x4f(int index, const glm::mat4 & mat) override;
+			virtual void SetUniform1iv(int index, size_t count, int * value) override;
+			virtual void SetUniform1fv(int index, size_t count, float * value) override;
+			virtual void SetUniform2iv(int index, size_t count, const glm::ivec2 * vec) override;
+			virtual void SetUniform2fv(int index, size_t count, const glm::vec2 * vec) override;
+			virtual void SetUniform3iv(int index, size_t count, const glm::ivec3 * vec) override;
+			virtual void SetUniform3fv(int index, size_t count, const glm::vec3 * vec) override;
+			virtual void SetUniform4iv(int index, size_t count, const glm::ivec4 * vec) override;
+			virtual void SetUniform4fv(int index, size_t count, const glm::vec4 * vec) override;
+			virtual void SetUniform3x3fv(int index, size_t count, const glm::mat3 * mat) override;
+			virtual void SetUniform4x4fv(int index, size_t count, const glm::mat4 * mat) override;
+			virtual void SetViewport(float x, float y, float width, float height) override;
+			virtual int CreateFramebuffer() override;
+			virtual void DestroyFramebuffer(int framebuffer) override;
+			virtual void BindFramebuffer(FramebufferTarget target, int framebuffer) override;
+			virtual void FramebufferTexture2D(FramebufferTarget target, FramebufferAttachment attachment, int texture, int level) override;
+			virtual void FramebufferRenderbuffer(FramebufferTarget target, FramebufferAttachment attachment, int renderbuffer) override;
+			virtual bool IsFramebufferComplete(FramebufferTarget target) override;
+			virtual int CreateRenderbuffer(TargetFormat format, size_t width, size_t height, size_t samples) override;
+			virtual void DestroyRenderbuffer(int renderbuffer) override;
+			virtual void SetDrawBuffers(size_t count, FramebufferAttachment * attachments) override;
+			virtual void BlitFramebuffer(int srcX0, int srcY0, int srcX1, int srcY1, int dstX0, int dstY0, int dstX1, int dstY1, BufferBit mask, Filter filter) override;
+			virtual void ReadPixels(int x, int y, size_t width, size_t height, PixelFormat format, PixelType type, void* data) override;
+			virtual int CreateTexture2D() override;
+			virtual void DestroyTexture2D(int texture) override;
+			virtual void ActivateTexture2D(int texture, int slot) override;
+			virtual void DeactivateTexture2D(int texture, int slot) override;
+			virtual void TextureData2D(int level, PixelFormat internalFormat, size_t width, size_t height, PixelFormat format, PixelType type, void * data) override;
+			virtual void TextureStorage2D(size_t levels, TargetFormat format, size_t width, size_t height) override;
+			virtual void SetTextureMinFilter(Filter filter) override;
+			virtual void SetTextureMagFilter(Filter filter) override;
+			virtual void SetTextureWrapSMode(WrapMode mode) override;
+			virtual void SetTextureWrapTMode(WrapMode mode) override;
+			virtual void Clear(BufferBit mask) override;
+			virtual void InsertBarrier(BarrierBit barriers) override;
+			virtual void SetUnpackAlignment(int alignment) override;
+			virtual void TextureSubData2D(int level, size_t x, size_t y, size_t width, size_t height, PixelFormat format, PixelType type, const void* data) override;
+			virtual int CreatePixelBuffer(size_t size) override;
+			virtual void DestroyPixelBuffer(int buffer) override;
+			virtual void* GetPixelBufferPointer(int buffer) override;
+			virtual void BindPixelBuffer(int buffer) override;
+			virtual int CreateFence() override;
+			virtual bool IsFenceSignaled(int fence) override;
+			virtual FenceStatus WaitFence(int fence, uint64_t timeout) override;
+			virtual void DestroyFence(int fence) override;
+			virtual int CreateTimerQuery() override;
+			virtual void DestroyTimerQuery(int query) override;
+			virtual void QueryTimestamp(int query) override;
+			virtual bool IsTimerQueryAvailable(int query) override;
+			virtual uint64_t GetTimerQueryResult(int query) override;
+
+		private:
+			/// <summary>
+			///		Client memory block passed to a call (the trace stores its contents)
+			/// </summary>
+			struct Data
+			{
+				const void* pointer;
+				size_t size;
+			};
+
+			/// <summary>
+			///		Pixel data passed to a texture upload (an offset into the bound pixel buffer if there is one)
+			/// </summary>
+			struct PixelData
+			{
+				const void* pointer;
+				size_t size;
+			};
+
+			template <typename ... TArgs>
+			void Record(ContextCall call, const TArgs& ... args);
+
+			// Compares a payload with one already stored in the trace
+			bool IsTracedPayload(uint64_t offset, size_t size, const Data& data);
+
+			void WriteBytes(const void* data, size_t size);
+			void WriteUnsigned(uint64_t value);
+			void Write(const char* string);
+			void Write(const Data& data);
+			void Write(const PixelData& data);
+			void Write(bool value);
+			void Write(int value);
+			void Write(unsigned int value);
+			void Write(unsigned long value);
+			void Write(unsigned long long value);
+			void Write(float value);
+			void Write(const glm::ivec2& vec);
+			void Write(const glm::vec2& vec);
+			void Write(const glm::ivec3& vec);
+			void Write(const glm::vec3& vec);
+			void Write(const glm::ivec4& vec);
+			void Write(const glm::vec4& vec);
+			void Write(const glm::mat3& mat);
+			void Write(const glm::mat4& mat);
+			template <typename T, typename = typename std::enable_if<std::is_enum<T>::value>::type> void Write(T value) { this->Write((int)value); }
+
+			size_t GetPixelDataSize(size_t width, size_t height, PixelFormat format, PixelType type, int alignment) const;
+
+			Context& m_context;
+
+			ContextStatistics m_currentStatistics;
+			ContextStatistics m_frameStatistics;
+
+			int m_activeProgram;
+			int m_unpackAlignment;
+			int m_boundPixelBuffer;
+
+			struct TracedPayload
+			{
+				uint64_t offset;
+				size_t size;
+			};
+
+			// The trace is also read from to compare payloads with the stored ones
+			std::fstream m_trace;
+			std::unordered_map<uint64_t, TracedPayload> m_tracedPayloads;
+			std::vector<unsigned char> m_payloadScratch;
+		};
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Context.hpp"
+
+#ifdef MAGMA_STATIC_CONTEXT
+#include "GLContext.hpp"
+#endif
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Context type used by renderers.
+		///		Release builds define MAGMA_STATIC_CONTEXT so renderers call GLContext directly (its methods are final, so the calls aren't virtual),
+		///		other builds go through the Context interface so decorators such as RecordingContext can be used.
+		/// </summary>
+#ifdef MAGMA_STATIC_CONTEXT
+		using RenderContext = GLContext;
+#else
+		using RenderContext = Context;
+#endif
+	}
+}
@@ -0,0 +1,445 @@
+#include "RenderGraph.hpp"
+#include "GPUProfiler.hpp"
+
+#include <limits>
+#include <sstream>
+
+static constexpr size_t NoPass = std::numeric_limits<size_t>::max();
+
+Magma::Graphics::RenderPassBuilder::RenderPassBuilder(RenderGraph & graph, size_t pass)
+	: m_graph(graph), m_pass(pass)
+{
+
+}
+
+int Magma::Graphics::RenderPassBuilder::CreateTarget(const std::string & name, const RenderTargetDesc & desc)
+{
+	auto id = m_graph.AddResource(name, RenderGraph::ResourceType::Target, false);
+	m_graph.m_resources[id - 1].desc = desc;
+	return id;
+}
+
+void Magma::Graphics::RenderPassBuilder::WriteTarget(int resource, BufferBit clear)
+{
+	auto& pass = m_graph.m_passes[m_pass];
+	m_graph.GetResource(resource, RenderGraph::ResourceType::Target);
+	if (pass.target != 0 && pass.target != resource)
+	{
+		std::stringstream ss;
+		ss << "Failed to declare render target write on render pass '" << pass.name << "': the pass already renders into another target";
+		throw std::runtime_error(ss.str());
+	}
+
+	if (pass.target == 0)
+		m_graph.AddWrite(m_pass, resource);
+	pass.target = resource;
+	pass.clear = pass.clear | clear;
+}
+
+void Magma::Graphics::RenderPassBuilder::ReadTexture(int resource)
+{
+	auto& r = m_graph.GetResource(resource, RenderGraph::ResourceType::Target);
+	bool hasTexture;
+	if (r.imported)
+		hasTexture = r.target != nullptr && r.target->colorTexture != 0;
+	else
+		hasTexture = r.desc.samples == 1 && r.desc.colorFormat != TargetFormat::Invalid;
+
+	if (!hasTexture)
+	{
+		std::stringstream ss;
+		ss << "Failed to declare texture read on render pass '" << m_graph.m_passes[m_pass].name << "': render target '" << r.name << "' has no color texture";
+		throw std::runtime_error(ss.str());
+	}
+
+	m_graph.m_passes[m_pass].textureReads.push_back(resource);
+	m_graph.AddRead(resource);
+}
+
+void Magma::Graphics::RenderPassBuilder::WriteBuffer(int resource, bool shaderWrite)
+{
+	m_graph.GetResource(resource, RenderGraph::ResourceType::Buffer);
+	m_graph.m_passes[m_pass].bufferWrites.push_back({ resource, shaderWrite });
+	m_graph.AddWrite(m_pass, resource);
+}
+
+void Magma::Graphics::RenderPassBuilder::ReadBuffer(int resource, BarrierBit usage)
+{
+	m_graph.GetResource(resource, RenderGraph::ResourceType::Buffer);
+	m_graph.m_passes[m_pass].bufferReads.push_back({ resource, usage });
+	m_graph.AddRead(resource);
+}
+
+void Magma::Graphics::RenderPassBuilder::SetSideEffects()
+{
+	m_graph.m_passes[m_pass].sideEffects = true;
+}
+
+Magma::Graphics::RenderPassResources::RenderPassResources(const RenderGraph & graph)
+	: m_graph(graph)
+{
+
+}
+
+const Magma::Graphics::RenderTarget & Magma::Graphics::RenderPassResources::GetTarget(int resource) const
+{
+	auto& r = m_graph.GetResource(resource, RenderGraph::ResourceType::Target);
+	auto target = m_graph.GetTarget(r);
+	if (target == nullptr)
+	{
+		std::stringstream ss;
+		ss << "Failed to get render target '" << r.name << "' from render graph: the target isn't allocated (was it declared by the pass?)";
+		throw std::runtime_error(ss.str());
+	}
+	return *target;
+}
+
+int Magma::Graphics::RenderPassResources::GetBuffer(int resource) const
+{
+	return m_graph.GetResource(resource, RenderGraph::ResourceType::Buffer).buffer;
+}
+
+Magma::Graphics::RenderGraph::RenderGraph(Context & context, RenderTargetPool & pool)
+	: m_context(context), m_pool(pool)
+{
+	m_profiler = nullptr;
+	m_culledPassCount = 0;
+}
+
+int Magma::Graphics::RenderGraph::ImportBackbuffer(const std::string & name, size_t width, size_t height)
+{
+	auto id = this->AddResource(name, ResourceType::Target, true);
+	auto& r = m_resources[id - 1];
+	r.desc.width = width;
+	r.desc.height = height;
+	r.desc.colorFormat = TargetFormat::RGBA8;
+	r.desc.depthFormat = TargetFormat::Invalid;
+	r.desc.samples = 1;
+	r.backbuffer.desc = r.desc;
+	r.backbuffer.framebuffer = 0;
+	r.backbuffer.colorTexture = 0;
+	r.backbuffer.colorRenderbuffer = 0;
+	r.backbuffer.depthRenderbuffer = 0;
+	return id;
+}
+
+int Magma::Graphics::RenderGraph::ImportTarget(const std::string & name, const RenderTarget & target)
+{
+	auto id = this->AddResource(name, ResourceType::Target, true);
+	auto& r = m_resources[id - 1];
+	r.desc = target.desc;
+	r.target = &target;
+	return id;
+}
+
+int Magma::Graphics::RenderGraph::ImportBuffer(const std::string & name, int buffer)
+{
+	auto id = this->AddResource(name, ResourceType::Buffer, true);
+	m_resources[id - 1].buffer = buffer;
+	return id;
+}
+
+void Magma::Graphics::RenderGraph::AddPass(const std::string & name, const SetupFunction & setup, ExecuteFunction execute)
+{
+	Pass pass;
+	pass.name = name;
+	pass.execute = std::move(execute);
+	pass.target = 0;
+	pass.clear = BufferBit::None;
+	pass.sideEffects = false;
+	pass.refCount = 0;
+	pass.culled = false;
+	m_passes.push_back(std::move(pass));
+
+	RenderPassBuilder builder(*this, m_passes.size() - 1);
+	setup(builder);
+}
+
+void Magma::Graphics::RenderGraph::Execute()
+{
+	// A half built graph must not leak into the next frame (the pool reclaims the targets still acquired on its EndFrame)
+	try
+	{
+		this->Cull();
+		this->ComputeLifetimes();
+		this->RunPasses();
+	}
+	catch (...)
+	{
+		this->Reset();
+		throw;
+	}
+
+	this->Reset();
+}
+
+void Magma::Graphics::RenderGraph::RunPasses()
+{
+	RenderPassResources resources(*this);
+	int boundFramebuffer = -1;
+	size_t viewportWidth = 0, viewportHeight = 0;
+
+	for (size_t i = 0; i < m_passes.size(); ++i)
+	{
+		auto& pass = m_passes[i];
+		if (pass.culled)
+			continue;
+
+		// Allocate the transient targets first used by this pass
+		for (auto& r : m_resources)
+			if (!r.imported && r.type == ResourceType::Target && r.firstUse == i)
+			{
+				r.target = m_pool.Acquire(r.desc);
+			}
+
+		// Only issue barriers for the reads which follow incoherent shader writes
+		BarrierBit barriers = BarrierBit::None;
+		for (auto& read : pass.textureReads)
+			if (m_resources[read - 1].pendingShaderWrite)
+				barriers |= BarrierBit::TextureFetch;
+		for (auto& read : pass.bufferReads)
+			if (m_resources[read.resource - 1].pendingShaderWrite)
+				barriers |= read.usage;
+		for (auto& write : pass.bufferWrites)
+			if (!write.shaderWrite && m_resources[write.resource - 1].pendingShaderWrite)
+				barriers |= BarrierBit::BufferUpdate;
+
+		if (barriers != BarrierBit::None)
+		{
+			m_context.InsertBarrier(barriers);
+			for (auto& read : pass.textureReads)
+				m_resources[read - 1].pendingShaderWrite = false;
+			for (auto& read : pass.bufferReads)
+				m_resources[read.resource - 1].pendingShaderWrite = false;
+			for (auto& write : pass.bufferWrites)
+				m_resources[write.resource - 1].pendingShaderWrite = false;
+		}
+
+		// Bind the pass target and clear it, skipping redundant binds and clears
+		if (pass.target != 0)
+		{
+			auto& r = m_resources[pass.target - 1];
+			auto& target = *this->GetTarget(r);
+
+			if (target.framebuffer != boundFramebuffer)
+			{
+				m_context.BindFramebuffer(FramebufferTarget::Both, target.framebuffer);
+				boundFramebuffer = target.framebuffer;
+			}
+
+			if (target.desc.width != viewportWidth || target.desc.height != viewportHeight)
+			{
+				m_context.SetViewport(0.0f, 0.0f, (float)target.desc.width, (float)target.desc.height);
+				viewportWidth = target.desc.width;
+				viewportHeight = target.desc.height;
+			}
+
+			// Only the first pass writing a target clears it, and only the attachments it actually has
+			if (!r.written)
+			{
+				auto present = BufferBit::None;
+				if (target.desc.colorFormat != TargetFormat::Invalid)
+					present = present | BufferBit::Color;
+				if (target.desc.depthFormat != TargetFormat::Invalid)
+					present = present | BufferBit::Depth;
+				if (target.desc.depthFormat == TargetFormat::Depth24Stencil8)
+					present = present | BufferBit::Stencil;
+				if (target.framebuffer == 0)
+					present = BufferBit::Color | BufferBit::Depth | BufferBit::Stencil;
+
+				auto clear = pass.clear & present;
+				if (clear != BufferBit::None)
+					m_context.Clear(clear);
+				r.written = true;
+			}
+		}
+
+		// The timer scope ends the profiler pass even if the pass throws, so the profiler's pass stack stays balanced
+		if (m_profiler != nullptr)
+		{
+			GPUTimerScope timer(*m_profiler, pass.name);
+			pass.execute(m_context, resources);
+		}
+		else pass.execute(m_context, resources);
+
+		for (auto& write : pass.bufferWrites)
+			if (write.shaderWrite)
+				m_resources[write.resource - 1].pendingShaderWrite = true;
+
+		// Recycle the transient targets last used by this pass, so that later passes can alias them
+		for (auto& r : m_resources)
+			if (!r.imported && r.type == ResourceType::Target && r.lastUse == i)
+			{
+				m_pool.Release(r.target);
+				r.target = nullptr;
+			}
+	}
+
+	if (boundFramebuffer > 0)
+		m_context.BindFramebuffer(FramebufferTarget::Both, 0);
+}
+
+int Magma::Graphics::RenderGraph::AddResource(const std::string & name, ResourceType type, bool imported)
+{
+	Resource r;
+	r.name = name;
+	r.type = type;
+	r.imported = imported;
+	r.target = nullptr;
+	r.buffer = 0;
+	r.refCount = 0;
+	r.firstUse = NoPass;
+	r.lastUse = NoPass;
+	r.written = false;
+	r.pendingShaderWrite = false;
+	m_resources.push_back(std::move(r));
+
+	// Imported resources live on after the graph, so their writers must never be culled
+	if (imported)
+		m_resources.back().refCount = 1;
+	return (int)m_resources.size();
+}
+
+Magma::Graphics::RenderGraph::Resource & Magma::Graphics::RenderGraph::GetResource(int resource, ResourceType type)
+{
+	return const_cast<Resource&>(static_cast<const RenderGraph*>(this)->GetResource(resource, type));
+}
+
+const Magma::Graphics::RenderGraph::Resource & Magma::Graphics::RenderGraph::GetResource(int resource, ResourceType type) const
+{
+	if (resource <= 0 || (size_t)resource > m_resources.size())
+	{
+		std::stringstream ss;
+		ss << "Failed to get render graph resource (" << resource << "): invalid resource ID";
+		throw std::runtime_error(ss.str());
+	}
+
+	auto& r = m_resources[resource - 1];
+	if (r.type != type)
+	{
+		std::stringstream ss;
+		ss << "Failed to get render graph resource '" << r.name << "': resource has a different type";
+		throw std::runtime_error(ss.str());
+	}
+
+	return r;
+}
+
+const Magma::Graphics::RenderTarget * Magma::Graphics::RenderGraph::GetTarget(const Resource & resource) const
+{
+	// Imported backbuffers don't point to an external target, they hold their own description
+	if (resource.target == nullptr && resource.imported)
+		return &resource.backbuffer;
+	return resource.target;
+}
+
+void Magma::Graphics::RenderGraph::AddRead(int resource)
+{
+	++m_resources[resource - 1].refCount;
+}
+
+void Magma::Graphics::RenderGraph::AddWrite(size_t pass, int resource)
+{
+	m_resources[resource - 1].writers.push_back(pass);
+	++m_passes[pass].refCount;
+}
+
+void Magma::Graphics::RenderGraph::Cull()
+{
+	// Each unused resource is only queued once, as its writers must only lose one reference for it
+	std::vector<int> unused;
+	std::vector<bool> queued(m_resources.size(), false);
+	auto markUnused = [&](int resource)
+	{
+		if (!queued[resource - 1])
+		{
+			queued[resource - 1] = true;
+			unused.push_back(resource);
+		}
+	};
+
+	auto cullPass = [&](Pass& pass)
+	{
+		pass.culled = true;
+		for (auto& read : pass.textureReads)
+			if (--m_resources[read - 1].refCount == 0)
+				markUnused(read);
+		for (auto& read : pass.bufferReads)
+			if (--m_resources[read.resource - 1].refCount == 0)
+				markUnused(read.resource);
+	};
+
+	for (auto& pass : m_passes)
+	{
+		if (pass.sideEffects)
+			++pass.refCount;
+		if (pass.refCount == 0)
+			cullPass(pass);
+	}
+
+	for (size_t i = 0; i < m_resources.size(); ++i)
+		if (m_resources[i].refCount == 0)
+			markUnused((int)i + 1);
+
+	// Passes whose outputs are all unused are culled, which may leave their inputs unused too
+	while (!unused.empty())
+	{
+		auto& r = m_resources[unused.back() - 1];
+		unused.pop_back();
+
+		for (auto w : r.writers)
+		{
+			auto& pass = m_passes[w];
+			if (!pass.culled && --pass.refCount == 0)
+				cullPass(pass);
+		}
+	}
+
+	m_culledPassCount = 0;
+	for (auto& pass : m_passes)
+		if (pass.culled)
+			++m_culledPassCount;
+}
+
+void Magma::Graphics::RenderGraph::ComputeLifetimes()
+{
+	auto use = [&](int resource, size_t pass)
+	{
+		auto& r = m_resources[resource - 1];
+		if (r.firstUse == NoPass)
+			r.firstUse = pass;
+		r.lastUse = pass;
+	};
+
+	for (size_t i = 0; i < m_passes.size(); ++i)
+	{
+		auto& pass = m_passes[i];
+		if (pass.culled)
+			continue;
+
+		for (auto& read : pass.textureReads)
+		{
+			auto& r = m_resources[read - 1];
+			if (!r.imported && r.firstUse == NoPass)
+			{
+				std::stringstream ss;
+				ss << "Failed to compile render graph: pass '" << pass.name << "' reads render target '" << r.name << "' before any pass writes it";
+				throw std::runtime_error(ss.str());
+			}
+			use(read, i);
+		}
+
+		if (pass.target != 0)
+			use(pass.target, i);
+		for (auto& read : pass.bufferReads)
+			use(read.resource, i);
+		for (auto& write : pass.bufferWrites)
+			use(write.resource, i);
+	}
+}
+
+void Magma::Graphics::RenderGraph::Reset()
+{
+	m_resources.clear();
+	m_passes.clear();
+}
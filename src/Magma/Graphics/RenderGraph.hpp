@@ -0,0 +1,256 @@
+#pragma once
+
+#include "Context.hpp"
+#include "RenderTargetPool.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		class GPUProfiler;
+		class RenderGraph;
+
+		/// <summary>
+		///		Used by render passes to declare which resources they use during setup
+		/// </summary>
+		class RenderPassBuilder final
+		{
+		public:
+			/// <summary>
+			///		Declares a transient render target, created by the graph when first used and recycled after its last use
+			/// </summary>
+			/// <param name="name">Resource name</param>
+			/// <param name="desc">Render target description</param>
+			/// <returns>Resource ID</returns>
+			int CreateTarget(const std::string& name, const RenderTargetDesc& desc);
+
+			/// <summary>
+			///		Declares that the pass renders into a render target (a pass can only render into one target)
+			/// </summary>
+			/// <param name="resource">Render target resource ID</param>
+			/// <param name="clear">Buffers cleared before the pass runs if it is the first pass writing the target (later passes keep its contents)</param>
+			void WriteTarget(int resource, BufferBit clear = BufferBit::None);
+
+			/// <summary>
+			///		Declares that the pass samples a render target color texture
+			/// </summary>
+			/// <param name="resource">Render target resource ID</param>
+			void ReadTexture(int resource);
+
+			/// <summary>
+			///		Declares that the pass writes into a buffer
+			/// </summary>
+			/// <param name="resource">Buffer resource ID</param>
+			/// <param name="shaderWrite">Is the buffer written by shaders (incoherently) instead of being uploaded?</param>
+			void WriteBuffer(int resource, bool shaderWrite);
+
+			/// <summary>
+			///		Declares that the pass reads from a buffer
+			/// </summary>
+			/// <param name="resource">Buffer resource ID</param>
+			/// <param name="usage">How the buffer is read (the barrier needed if it was written by shaders)</param>
+			void ReadBuffer(int resource, BarrierBit usage);
+
+			/// <summary>
+			///		Prevents the pass from being culled even if nothing uses its outputs
+			/// </summary>
+			void SetSideEffects();
+
+		private:
+			friend class RenderGraph;
+
+			RenderPassBuilder(RenderGraph& graph, size_t pass);
+
+			RenderGraph& m_graph;
+			size_t m_pass;
+		};
+
+		/// <summary>
+		///		Gives render passes access to the resources they declared during execution
+		/// </summary>
+		class RenderPassResources final
+		{
+		public:
+			/// <summary>
+			///		Gets the render target bound to a resource
+			/// </summary>
+			/// <param name="resource">Render target resource ID</param>
+			/// <returns>Render target</returns>
+			const RenderTarget& GetTarget(int resource) const;
+
+			/// <summary>
+			///		Gets the buffer ID bound to a resource
+			/// </summary>
+			/// <param name="resource">Buffer resource ID</param>
+			/// <returns>Buffer ID</returns>
+			int GetBuffer(int resource) const;
+
+		private:
+			friend class RenderGraph;
+
+			RenderPassResources(const RenderGraph& graph);
+
+			const RenderGraph& m_graph;
+		};
+
+		/// <summary>
+		///		Render graph: passes declare the resources they read and write, and the graph culls the passes whose results are unused,
+		///		allocates transient render targets only for the passes that use them (aliasing targets whose lifetimes don't overlap),
+		///		and issues only the framebuffer binds, clears and memory barriers which are actually needed between passes.
+		///		The graph is rebuilt every frame: add passes, execute it, and it is reset.
+		/// </summary>
+		class RenderGraph final
+		{
+		public:
+			/// <summary>
+			///		Pass setup function (declares the resources the pass uses)
+			/// </summary>
+			using SetupFunction = std::function<void(RenderPassBuilder&)>;
+
+			/// <summary>
+			///		Pass execution function
+			/// </summary>
+			using ExecuteFunction = std::function<void(Context&, const RenderPassResources&)>;
+
+			/// <summary>
+			///		Creates a new render graph
+			/// </summary>
+			/// <param name="context">Context the passes render with</param>
+			/// <param name="pool">Pool where transient render targets are allocated</param>
+			RenderGraph(Context& context, RenderTargetPool& pool);
+			~RenderGraph() = default;
+
+			/// <summary>
+			///		Sets the profiler used to time each executed pass (nullptr to disable timing)
+			/// </summary>
+			inline void SetProfiler(GPUProfiler* profiler) { m_profiler = profiler; }
+
+			/// <summary>
+			///		Imports the default framebuffer (writes to it are never culled)
+			/// </summary>
+			/// <param name="name">Resource name</param>
+			/// <param name="width">Framebuffer width</param>
+			/// <param name="height">Framebuffer height</param>
+			/// <returns>Resource ID</returns>
+			int ImportBackbuffer(const std::string& name, size_t width, size_t height);
+
+			/// <summary>
+			///		Imports a render target owned by the caller (writes to it are never culled)
+			/// </summary>
+			/// <param name="name">Resource name</param>
+			/// <param name="target">Render target (must stay valid until the graph is executed)</param>
+			/// <returns>Resource ID</returns>
+			int ImportTarget(const std::string& name, const RenderTarget& target);
+
+			/// <summary>
+			///		Imports a buffer owned by the caller (writes to it are never culled)
+			/// </summary>
+			/// <param name="name">Resource name</param>
+			/// <param name="buffer">Buffer ID</param>
+			/// <returns>Resource ID</returns>
+			int ImportBuffer(const std::string& name, int buffer);
+
+			/// <summary>
+			///		Adds a pass to the graph (passes run in the order they are added)
+			/// </summary>
+			/// <param name="name">Pass name</param>
+			/// <param name="setup">Called immediately to declare the resources the pass uses</param>
+			/// <param name="execute">Called during execution if the pass isn't culled</param>
+			void AddPass(const std::string& name, const SetupFunction& setup, ExecuteFunction execute);
+
+			/// <summary>
+			///		Culls, allocates and runs the passes, then resets the graph (even if a pass throws)
+			/// </summary>
+			void Execute();
+
+			/// <summary>
+			///		Gets the number of passes culled on the last execution
+			/// </summary>
+			inline size_t GetCulledPassCount() const { return m_culledPassCount; }
+
+		private:
+			friend class RenderPassBuilder;
+			friend class RenderPassResources;
+
+			enum class ResourceType
+			{
+				Invalid = -1,
+
+				Target,
+				Buffer,
+
+				Count
+			};
+
+			struct Resource
+			{
+				std::string name;
+				ResourceType type;
+				bool imported;
+				RenderTargetDesc desc;
+				const RenderTarget* target;
+				RenderTarget backbuffer;
+				int buffer;
+
+				size_t refCount;
+				std::vector<size_t> writers;
+				size_t firstUse;
+				size_t lastUse;
+
+				bool written;
+				bool pendingShaderWrite;
+			};
+
+			struct BufferRead
+			{
+				int resource;
+				BarrierBit usage;
+			};
+
+			struct BufferWrite
+			{
+				int resource;
+				bool shaderWrite;
+			};
+
+			struct Pass
+			{
+				std::string name;
+				ExecuteFunction execute;
+
+				int target;
+				BufferBit clear;
+				std::vector<int> textureReads;
+				std::vector<BufferRead> bufferReads;
+				std::vector<BufferWrite> bufferWrites;
+				bool sideEffects;
+
+				size_t refCount;
+				bool culled;
+			};
+
+			int AddResource(const std::string& name, ResourceType type, bool imported);
+			Resource& GetResource(int resource, ResourceType type);
+			const Resource& GetResource(int resource, ResourceType type) const;
+			const RenderTarget* GetTarget(const Resource& resource) const;
+			void AddRead(int resource);
+			void AddWrite(size_t pass, int resource);
+			void Cull();
+			void ComputeLifetimes();
+			void RunPasses();
+			void Reset();
+
+			Context& m_context;
+			RenderTargetPool& m_pool;
+			GPUProfiler* m_profiler;
+
+			std::vector<Resource> m_resources;
+			std::vector<Pass> m_passes;
+			size_t m_culledPassCount;
+		};
+	}
+}
@@ -0,0 +1,192 @@
+#include "RenderTargetPool.hpp"
+
+#include <sstream>
+
+Magma::Graphics::RenderTargetPool::RenderTargetPool(Context & context, size_t maxIdleFrames)
+	: m_context(context)
+{
+	m_maxIdleFrames = maxIdleFrames;
+	m_frame = 0;
+	m_createdCount = 0;
+}
+
+Magma::Graphics::RenderTargetPool::~RenderTargetPool()
+{
+	for (auto& p : m_entries)
+		for (auto& e : p.second)
+			this->Destroy(*e);
+}
+
+const Magma::Graphics::RenderTarget * Magma::Graphics::RenderTargetPool::Acquire(const RenderTargetDesc & desc)
+{
+	if (desc.width == 0 || desc.height == 0)
+		throw std::runtime_error("Failed to acquire render target from RenderTargetPool: invalid size");
+	if (desc.colorFormat == TargetFormat::Invalid && desc.depthFormat == TargetFormat::Invalid)
+		throw std::runtime_error("Failed to acquire render target from RenderTargetPool: render target has no attachments");
+	if (desc.samples == 0)
+		throw std::runtime_error("Failed to acquire render target from RenderTargetPool: sample count must be at least 1");
+
+	auto& entries = m_entries[desc];
+	for (auto& e : entries)
+		if (!e->acquired)
+		{
+			e->acquired = true;
+			e->lastUsedFrame = m_frame;
+			return &e->target;
+		}
+
+	auto entry = std::make_unique<Entry>();
+	this->Create(*entry, desc);
+	entry->acquired = true;
+	entry->lastUsedFrame = m_frame;
+	entries.push_back(std::move(entry));
+	return &entries.back()->target;
+}
+
+void Magma::Graphics::RenderTargetPool::Release(const RenderTarget * target)
+{
+	auto it = m_entries.find(target->desc);
+	if (it != m_entries.end())
+		for (auto& e : it->second)
+			if (&e->target == target)
+			{
+				if (!e->acquired)
+					throw std::runtime_error("Failed to release render target into RenderTargetPool: render target isn't acquired");
+				e->acquired = false;
+				return;
+			}
+
+	throw std::runtime_error("Failed to release render target into RenderTargetPool: render target doesn't belong to this pool");
+}
+
+void Magma::Graphics::RenderTargetPool::EndFrame()
+{
+	for (auto p = m_entries.begin(); p != m_entries.end();)
+	{
+		auto& entries = p->second;
+		for (size_t i = 0; i < entries.size();)
+		{
+			auto& e = entries[i];
+			e->acquired = false;
+			if (m_frame - e->lastUsedFrame >= m_maxIdleFrames)
+			{
+				this->Destroy(*e);
+				e = std::move(entries.back());
+				entries.pop_back();
+			}
+			else ++i;
+		}
+
+		if (entries.empty())
+			p = m_entries.erase(p);
+		else ++p;
+	}
+
+	++m_frame;
+}
+
+void Magma::Graphics::RenderTargetPool::Trim()
+{
+	for (auto p = m_entries.begin(); p != m_entries.end();)
+	{
+		auto& entries = p->second;
+		for (size_t i = 0; i < entries.size();)
+		{
+			auto& e = entries[i];
+			if (!e->acquired)
+			{
+				this->Destroy(*e);
+				e = std::move(entries.back());
+				entries.pop_back();
+			}
+			else ++i;
+		}
+
+		if (entries.empty())
+			p = m_entries.erase(p);
+		else ++p;
+	}
+}
+
+size_t Magma::Graphics::RenderTargetPool::GetTargetCount() const
+{
+	size_t count = 0;
+	for (auto& p : m_entries)
+		count += p.second.size();
+	return count;
+}
+
+void Magma::Graphics::RenderTargetPool::Create(Entry & entry, const RenderTargetDesc & desc)
+{
+	auto& target = entry.target;
+	target.desc = desc;
+	target.colorTexture = 0;
+	target.colorRenderbuffer = 0;
+	target.depthRenderbuffer = 0;
+
+	target.framebuffer = m_context.CreateFramebuffer();
+	m_context.BindFramebuffer(FramebufferTarget::Both, target.framebuffer);
+
+	if (desc.colorFormat != TargetFormat::Invalid)
+	{
+		if (desc.samples > 1)
+		{
+			target.colorRenderbuffer = m_context.CreateRenderbuffer(desc.colorFormat, desc.width, desc.height, desc.samples);
+			m_context.FramebufferRenderbuffer(FramebufferTarget::Both, FramebufferAttachment::Color0, target.colorRenderbuffer);
+		}
+		else
+		{
+			target.colorTexture = m_context.CreateTexture2D();
+			m_context.ActivateTexture2D(target.colorTexture, 0);
+			m_context.TextureStorage2D(1, desc.colorFormat, desc.width, desc.height);
+			m_context.SetTextureMinFilter(Filter::Linear);
+			m_context.SetTextureMagFilter(Filter::Linear);
+			m_context.SetTextureWrapSMode(WrapMode::ClampToEdge);
+			m_context.SetTextureWrapTMode(WrapMode::ClampToEdge);
+			m_context.DeactivateTexture2D(target.colorTexture, 0);
+			m_context.FramebufferTexture2D(FramebufferTarget::Both, FramebufferAttachment::Color0, target.colorTexture, 0);
+		}
+
+		FramebufferAttachment drawBuffer = FramebufferAttachment::Color0;
+		m_context.SetDrawBuffers(1, &drawBuffer);
+	}
+	else m_context.SetDrawBuffers(0, nullptr);
+
+	if (desc.depthFormat != TargetFormat::Invalid)
+	{
+		target.depthRenderbuffer = m_context.CreateRenderbuffer(desc.depthFormat, desc.width, desc.height, desc.samples);
+		m_context.FramebufferRenderbuffer(FramebufferTarget::Both,
+										  desc.depthFormat == TargetFormat::Depth24Stencil8 ? FramebufferAttachment::DepthStencil : FramebufferAttachment::Depth,
+										  target.depthRenderbuffer);
+	}
+
+	bool complete = m_context.IsFramebufferComplete(FramebufferTarget::Both);
+	m_context.BindFramebuffer(FramebufferTarget::Both, 0);
+
+	if (!complete)
+	{
+		this->Destroy(entry);
+		std::stringstream ss;
+		ss << "Failed to create render target on RenderTargetPool (" << desc.width << "x" << desc.height << ", " << desc.samples << " samples): framebuffer is incomplete";
+		throw std::runtime_error(ss.str());
+	}
+
+	++m_createdCount;
+}
+
+void Magma::Graphics::RenderTargetPool::Destroy(Entry & entry)
+{
+	auto& target = entry.target;
+	if (target.framebuffer != 0)
+		m_context.DestroyFramebuffer(target.framebuffer);
+	if (target.colorTexture != 0)
+		m_context.DestroyTexture2D(target.colorTexture);
+	if (target.colorRenderbuffer != 0)
+		m_context.DestroyRenderbuffer(target.colorRenderbuffer);
+	if (target.depthRenderbuffer != 0)
+		m_context.DestroyRenderbuffer(target.depthRenderbuffer);
+	target.framebuffer = 0;
+	target.colorTexture = 0;
+	target.colorRenderbuffer = 0;
+	target.depthRenderbuffer = 0;
+}
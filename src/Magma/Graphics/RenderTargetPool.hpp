@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Context.hpp"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Describes a render target
+		/// </summary>
+		struct RenderTargetDesc
+		{
+			/// <summary>
+			///		Render target width
+			/// </summary>
+			size_t width = 0;
+
+			/// <summary>
+			///		Render target height
+			/// </summary>
+			size_t height = 0;
+
+			/// <summary>
+			///		Color attachment format (TargetFormat::Invalid for no color attachment)
+			/// </summary>
+			TargetFormat colorFormat = TargetFormat::RGBA8;
+
+			/// <summary>
+			///		Depth/stencil attachment format (TargetFormat::Invalid for no depth/stencil attachment)
+			/// </summary>
+			TargetFormat depthFormat = TargetFormat::Invalid;
+
+			/// <summary>
+			///		Sample count (1 for no multisampling)
+			/// </summary>
+			size_t samples = 1;
+
+			inline bool operator==(const RenderTargetDesc& rhs) const
+			{
+				return width == rhs.width && height == rhs.height && colorFormat == rhs.colorFormat && depthFormat == rhs.depthFormat && samples == rhs.samples;
+			}
+
+			inline bool operator!=(const RenderTargetDesc& rhs) const { return !(*this == rhs); }
+
+			inline bool operator<(const RenderTargetDesc& rhs) const
+			{
+				if (width != rhs.width) return width < rhs.width;
+				if (height != rhs.height) return height < rhs.height;
+				if (colorFormat != rhs.colorFormat) return colorFormat < rhs.colorFormat;
+				if (depthFormat != rhs.depthFormat) return depthFormat < rhs.depthFormat;
+				return samples < rhs.samples;
+			}
+		};
+
+		/// <summary>
+		///		A framebuffer and its attachments
+		/// </summary>
+		struct RenderTarget
+		{
+			/// <summary>
+			///		Render target description
+			/// </summary>
+			RenderTargetDesc desc;
+
+			/// <summary>
+			///		Framebuffer ID
+			/// </summary>
+			int framebuffer;
+
+			/// <summary>
+			///		Color texture ID (0 if there is no color attachment or the target is multisampled)
+			/// </summary>
+			int colorTexture;
+
+			/// <summary>
+			///		Color renderbuffer ID (only used by multisampled targets, otherwise 0)
+			/// </summary>
+			int colorRenderbuffer;
+
+			/// <summary>
+			///		Depth/stencil renderbuffer ID (0 if there is no depth/stencil attachment)
+			/// </summary>
+			int depthRenderbuffer;
+		};
+
+		/// <summary>
+		///		Hands out transient render targets and recycles them, so that offscreen passes don't allocate context memory every frame.
+		///		A target released during a frame can be handed out again later in the same frame, aliasing targets whose lifetimes don't overlap.
+		/// </summary>
+		class RenderTargetPool final
+		{
+		public:
+			/// <summary>
+			///		Creates a new render target pool
+			/// </summary>
+			/// <param name="context">Context where the render targets are created</param>
+			/// <param name="maxIdleFrames">Number of frames a render target may stay unused before it is destroyed</param>
+			RenderTargetPool(Context& context, size_t maxIdleFrames = 3);
+			~RenderTargetPool();
+
+			/// <summary>
+			///		Acquires a render target matching a description, creating a new one if none is free
+			/// </summary>
+			/// <param name="desc">Render target description</param>
+			/// <returns>Render target (valid until it is released or the frame ends)</returns>
+			const RenderTarget* Acquire(const RenderTargetDesc& desc);
+
+			/// <summary>
+			///		Releases a render target back into the pool (its contents may be overwritten from now on)
+			/// </summary>
+			/// <param name="target">Render target</param>
+			void Release(const RenderTarget* target);
+
+			/// <summary>
+			///		Ends the current frame: releases every target still acquired and destroys the ones which have been idle for too long
+			/// </summary>
+			void EndFrame();
+
+			/// <summary>
+			///		Destroys every render target which isn't currently acquired
+			/// </summary>
+			void Trim();
+
+			/// <summary>
+			///		Gets the number of render targets currently allocated (acquired or free)
+			/// </summary>
+			size_t GetTargetCount() const;
+
+			/// <summary>
+			///		Gets the number of render targets created since the pool was created
+			/// </summary>
+			inline size_t GetCreatedTargetCount() const { return m_createdCount; }
+
+		private:
+			struct Entry
+			{
+				RenderTarget target;
+				bool acquired;
+				uint64_t lastUsedFrame;
+			};
+
+			void Create(Entry& entry, const RenderTargetDesc& desc);
+			void Destroy(Entry& entry);
+
+			Context& m_context;
+			size_t m_maxIdleFrames;
+			uint64_t m_frame;
+			size_t m_createdCount;
+
+			std::map<RenderTargetDesc, std::vector<std::unique_ptr<Entry>>> m_entries;
+		};
+	}
+}
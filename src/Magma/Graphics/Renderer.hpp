@@ -2,6 +2,9 @@
 
 #include "Context.hpp"
 
+#include <glm/glm.hpp>
+#include <vector>
+
 namespace Magma
 {
 	namespace Graphics
@@ -11,9 +14,124 @@ namespace Magma
 
 		};
 
+		/// <summary>
+		///		Level of detail of a render item
+		/// </summary>
+		struct RenderLod
+		{
+			/// <summary>
+			///		First vertex (or index) drawn
+			/// </summary>
+			int first;
+
+			/// <summary>
+			///		Number of vertices (or indices) drawn
+			/// </summary>
+			size_t count;
+
+			/// <summary>
+			///		Maximum distance between this level's surface and the full detail one, in model space
+			/// </summary>
+			float error;
+		};
+
+		/// <summary>
+		///		Object submitted for rendering
+		/// </summary>
+		struct RenderItem
+		{
+			/// <summary>
+			///		Shader program (receives the item's model view projection matrix on uniform location 0)
+			/// </summary>
+			int program;
+
+			/// <summary>
+			///		Vertex array drawn
+			/// </summary>
+			int vao;
+
+			/// <summary>
+			///		Draw mode
+			/// </summary>
+			DrawMode mode;
+
+			/// <summary>
+			///		Index type if the vertex array is drawn with its index buffer (Invalid to draw the vertices directly)
+			/// </summary>
+			IndexType indexType;
+
+			/// <summary>
+			///		First vertex (or index) drawn
+			/// </summary>
+			int first;
+
+			/// <summary>
+			///		Number of vertices (or indices) drawn
+			/// </summary>
+			size_t count;
+
+			/// <summary>
+			///		Levels of detail, from the most detailed to the least (nullptr to always draw first and count).
+			///		The array must stay valid until the frame is rendered.
+			/// </summary>
+			const RenderLod* lods;
+
+			/// <summary>
+			///		Number of levels of detail
+			/// </summary>
+			size_t lodCount;
+
+			/// <summary>
+			///		Level of detail drawn, chosen by the LOD stage.
+			///		The stage starts from the previous level, so items which are kept between frames should keep it to avoid popping back and forth.
+			/// </summary>
+			size_t lod;
+
+			/// <summary>
+			///		Model transform
+			/// </summary>
+			glm::mat4 transform;
+
+			/// <summary>
+			///		World space bounding box center
+			/// </summary>
+			glm::vec3 boundsCenter;
+
+			/// <summary>
+			///		World space bounding box half size (use the radius on every axis for bounding spheres)
+			/// </summary>
+			glm::vec3 boundsExtents;
+
+			/// <summary>
+			///		Is the item large and solid enough to hide the items behind it? (used by occlusion culling)
+			/// </summary>
+			bool occluder;
+		};
+
+		/// <summary>
+		///		Everything submitted for rendering on a frame
+		/// </summary>
 		struct RenderFrame
 		{
+			/// <summary>
+			///		Camera view projection matrix
+			/// </summary>
+			glm::mat4 viewProjection;
+
+			/// <summary>
+			///		Camera world space position
+			/// </summary>
+			glm::vec3 cameraPosition;
+
+			/// <summary>
+			///		Submitted items
+			/// </summary>
+			std::vector<RenderItem> items;
 
+			/// <summary>
+			///		Indices of the visible items in draw order (filled by the culling stage)
+			/// </summary>
+			std::vector<size_t> visibleItems;
 		};
 
 		class Renderer
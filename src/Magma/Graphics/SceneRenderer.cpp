@@ -0,0 +1,43 @@
+#include "SceneRenderer.hpp"
+
+Magma::Graphics::SceneRenderer::SceneRenderer(Context & context)
+	: Renderer(context)
+{
+
+}
+
+void Magma::Graphics::SceneRenderer::Render(RenderFrame * frame)
+{
+	m_cullingStage.Process(*frame);
+	m_lodStage.Process(*frame);
+
+	// Visible items are sorted by program, so the program only changes when a new one is reached
+	int program = 0;
+	for (auto i : frame->visibleItems)
+	{
+		auto& item = frame->items[i];
+		if (item.program != program)
+		{
+			if (program != 0)
+				m_context.DeactivateProgram(program);
+			program = item.program;
+			m_context.ActivateProgram(program);
+		}
+
+		m_context.SetUniform4x4f(0, frame->viewProjection * item.transform);
+		auto first = item.first;
+		auto count = item.count;
+		if (item.lods != nullptr && item.lodCount != 0)
+		{
+			first = item.lods[item.lod].first;
+			count = item.lods[item.lod].count;
+		}
+
+		if (item.indexType != IndexType::Invalid)
+			m_context.DrawIndexedVertexArray(item.vao, item.mode, item.indexType, first, count);
+		else m_context.DrawVertexArray(item.vao, item.mode, first, count);
+	}
+
+	if (program != 0)
+		m_context.DeactivateProgram(program);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Renderer.hpp"
+#include "CullingStage.hpp"
+#include "LodStage.hpp"
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Renders the items of a render frame: culls them, chooses their levels of detail, then draws the visible ones sorted by program and vertex array
+		/// </summary>
+		class SceneRenderer final : public Renderer
+		{
+		public:
+			SceneRenderer(Context& context);
+			virtual ~SceneRenderer() = default;
+
+			/// <summary>
+			///		Gets the culling stage run before the items are drawn
+			/// </summary>
+			inline CullingStage& GetCullingStage() { return m_cullingStage; }
+
+			/// <summary>
+			///		Gets the LOD stage run after culling
+			/// </summary>
+			inline LodStage& GetLodStage() { return m_lodStage; }
+
+			virtual void Render(RenderFrame* frame) override;
+
+		private:
+			CullingStage m_cullingStage;
+			LodStage m_lodStage;
+		};
+	}
+}
@@ -0,0 +1,218 @@
+#include "SpriteBatch.hpp"
+#include "AttributePacking.hpp"
+#include "GLContext.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+template <typename TContext>
+Magma::Graphics::BasicSpriteBatch<TContext>::BasicSpriteBatch(TContext & context, size_t maxSprites, size_t bufferCount)
+	: m_context(context)
+{
+	if (maxSprites == 0 || bufferCount == 0)
+		throw std::runtime_error("Failed to create SpriteBatch: the maximum sprite count and buffer count must be at least 1");
+
+	// Compile sprite shader
+	m_vertShader = m_context.CreateShader(ShaderType::Vertex,
+										  R"glsl(
+	#version 430 core
+
+	layout (location = 0) in vec2 vertexPosition;
+	layout (location = 1) in vec2 vertexUV;
+	layout (location = 2) in vec4 vertexColor;
+	out vec2 fragUV;
+	out vec4 fragColor;
+
+	layout (location = 0) uniform mat4 transform;
+
+	void main()
+	{
+		gl_Position = transform * vec4(vertexPosition, 0.0, 1.0);
+		fragUV = vertexUV;
+		fragColor = vertexColor;
+	}
+	)glsl");
+
+	m_fragShader = m_context.CreateShader(ShaderType::Fragment,
+										  R"glsl(
+	#version 430 core
+
+	in vec2 fragUV;
+	in vec4 fragColor;
+	out vec4 color;
+
+	layout (location = 1) uniform sampler2D sprite;
+
+	void main()
+	{
+		color = texture(sprite, fragUV) * fragColor;
+		if (color.a == 0.0)
+			discard;
+	}
+	)glsl");
+
+	m_program = m_context.CreateProgram();
+	m_context.AttachShader(m_program, m_vertShader);
+	m_context.AttachShader(m_program, m_fragShader);
+	m_context.LinkProgram(m_program);
+
+	// Create the vertex buffers cycled through on each flush
+	for (size_t i = 0; i < bufferCount; ++i)
+	{
+		auto vao = m_context.CreateVertexArray();
+		auto vbo = m_context.CreateDynamicVertexBuffer(vao, nullptr, sizeof(Vertex) * 6 * maxSprites);
+		m_context.SetVertexAttributePointer(vao, vbo, 0, 2, AttributeType::Float, false, sizeof(Vertex), (const void*)offsetof(Vertex, position));
+		m_context.SetVertexAttributePointer(vao, vbo, 1, 2, AttributeType::Float, false, sizeof(Vertex), (const void*)offsetof(Vertex, uv));
+		m_context.SetVertexAttributePointer(vao, vbo, 2, 4, AttributeType::UByte, true, sizeof(Vertex), (const void*)offsetof(Vertex, color));
+		m_vaos.push_back(vao);
+		m_vbos.push_back(vbo);
+	}
+
+	m_nextBuffer = 0;
+	m_maxSprites = maxSprites;
+	m_active = false;
+	m_transform = glm::mat4(1.0f);
+	m_sortMode = SpriteSortMode::Texture;
+	m_drawCallCount = 0;
+	m_sprites.reserve(maxSprites);
+	m_vertices.resize(maxSprites * 6);
+}
+
+template <typename TContext>
+Magma::Graphics::BasicSpriteBatch<TContext>::~BasicSpriteBatch()
+{
+	m_context.DetachShader(m_program, m_vertShader);
+	m_context.DetachShader(m_program, m_fragShader);
+	m_context.DestroyProgram(m_program);
+	m_context.DestroyShader(m_vertShader);
+	m_context.DestroyShader(m_fragShader);
+
+	for (size_t i = 0; i < m_vaos.size(); ++i)
+	{
+		m_context.DestroyVertexBuffer(m_vbos[i]);
+		m_context.DestroyVertexArray(m_vaos[i]);
+	}
+}
+
+template <typename TContext>
+void Magma::Graphics::BasicSpriteBatch<TContext>::Begin(const glm::mat4 & transform, SpriteSortMode sortMode)
+{
+	if (m_active)
+		throw std::runtime_error("Failed to begin SpriteBatch: the batch has already begun");
+	if (sortMode <= SpriteSortMode::Invalid || sortMode >= SpriteSortMode::Count)
+		throw std::runtime_error("Failed to begin SpriteBatch: invalid sort mode");
+
+	m_active = true;
+	m_transform = transform;
+	m_sortMode = sortMode;
+	m_drawCallCount = 0;
+}
+
+template <typename TContext>
+void Magma::Graphics::BasicSpriteBatch<TContext>::Draw(int texture, const glm::vec2 & position, const glm::vec2 & size, const glm::vec4 & uvs, const glm::vec4 & color, float rotation, const glm::vec2 & origin)
+{
+	if (!m_active)
+		throw std::runtime_error("Failed to draw sprite on SpriteBatch: Begin wasn't called");
+
+	if (m_sprites.size() == m_maxSprites)
+		this->Flush();
+
+	Sprite sprite;
+	sprite.texture = texture;
+	sprite.rotation = rotation;
+	sprite.position = position;
+	sprite.size = size;
+	sprite.origin = origin;
+	sprite.uvs = uvs;
+	for (int i = 0; i < 4; ++i)
+		sprite.color[i] = PackUnorm8(color[i]);
+	m_sprites.push_back(sprite);
+}
+
+template <typename TContext>
+void Magma::Graphics::BasicSpriteBatch<TContext>::End()
+{
+	if (!m_active)
+		throw std::runtime_error("Failed to end SpriteBatch: Begin wasn't called");
+
+	this->Flush();
+	m_active = false;
+}
+
+template <typename TContext>
+void Magma::Graphics::BasicSpriteBatch<TContext>::Flush()
+{
+	if (m_sprites.empty())
+		return;
+
+	// Sort by texture, using the submission index as the low bits so the sort is stable
+	m_sortKeys.resize(m_sprites.size());
+	for (size_t i = 0; i < m_sprites.size(); ++i)
+		m_sortKeys[i] = m_sortMode == SpriteSortMode::Texture ? ((uint64_t)(uint32_t)m_sprites[i].texture << 32) | i : i;
+	if (m_sortMode == SpriteSortMode::Texture)
+		std::sort(m_sortKeys.begin(), m_sortKeys.end());
+
+	// Expand the sprites into two triangles each
+	static const glm::vec2 corners[6] =
+	{
+		{ 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f },
+		{ 0.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f },
+	};
+
+	auto vertex = m_vertices.data();
+	for (auto key : m_sortKeys)
+	{
+		auto& sprite = m_sprites[key & 0xFFFFFFFF];
+
+		float c = 1.0f, s = 0.0f;
+		if (sprite.rotation != 0.0f)
+		{
+			c = std::cos(sprite.rotation);
+			s = std::sin(sprite.rotation);
+		}
+
+		for (auto& corner : corners)
+		{
+			auto local = (corner - sprite.origin) * sprite.size;
+			vertex->position = sprite.position + glm::vec2(local.x * c - local.y * s, local.x * s + local.y * c);
+			vertex->uv = glm::vec2(sprite.uvs.x + corner.x * (sprite.uvs.z - sprite.uvs.x), sprite.uvs.y + corner.y * (sprite.uvs.w - sprite.uvs.y));
+			for (int i = 0; i < 4; ++i)
+				vertex->color[i] = sprite.color[i];
+			++vertex;
+		}
+	}
+
+	auto vao = m_vaos[m_nextBuffer];
+	auto vbo = m_vbos[m_nextBuffer];
+	m_nextBuffer = (m_nextBuffer + 1) % m_vaos.size();
+	m_context.SetDynamicVertexBufferData(vao, vbo, m_vertices.data(), sizeof(Vertex) * 6 * m_sprites.size());
+
+	m_context.ActivateProgram(m_program);
+	m_context.SetUniform4x4f(0, m_transform);
+	m_context.SetUniform1i(1, 0); // Set texture slot to be used
+
+	// Draw each run of sprites sharing a texture with a single draw call
+	size_t first = 0;
+	while (first < m_sortKeys.size())
+	{
+		auto texture = m_sprites[m_sortKeys[first] & 0xFFFFFFFF].texture;
+		auto last = first + 1;
+		while (last < m_sortKeys.size() && m_sprites[m_sortKeys[last] & 0xFFFFFFFF].texture == texture)
+			++last;
+
+		m_context.ActivateTexture2D(texture, 0);
+		m_context.DrawVertexArray(vao, DrawMode::Triangles, (int)(first * 6), (last - first) * 6);
+		m_context.DeactivateTexture2D(texture, 0);
+		++m_drawCallCount;
+
+		first = last;
+	}
+
+	m_context.DeactivateProgram(m_program);
+	m_sprites.clear();
+}
+
+template class Magma::Graphics::BasicSpriteBatch<Magma::Graphics::Context>;
+template class Magma::Graphics::BasicSpriteBatch<Magma::Graphics::GLContext>;
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "RenderContext.hpp"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Order in which sprites are drawn
+		/// </summary>
+		enum class SpriteSortMode
+		{
+			Invalid = -1,
+
+			/// <summary>
+			///		Sprites are drawn in submission order (consecutive sprites with the same texture are still drawn together)
+			/// </summary>
+			Deferred,
+
+			/// <summary>
+			///		Sprites are grouped by texture (sprites with the same texture keep their submission order)
+			/// </summary>
+			Texture,
+
+			Count
+		};
+
+		/// <summary>
+		///		Batches textured, tinted and rotated quads into a streaming vertex buffer and draws them with one draw call per texture.
+		///		Sprites sharing an atlas page should use the same texture so they end up in the same draw call.
+		/// </summary>
+		/// <typeparam name="TContext">Context type the batch calls (instantiated for Context and GLContext)</typeparam>
+		template <typename TContext>
+		class BasicSpriteBatch final
+		{
+		public:
+			/// <summary>
+			///		Creates a new sprite batch
+			/// </summary>
+			/// <param name="context">Context used to draw the sprites</param>
+			/// <param name="maxSprites">Maximum number of sprites per draw (larger batches are split)</param>
+			/// <param name="bufferCount">Number of vertex buffers cycled through, so a flush never waits on the GPU reading the previous one</param>
+			BasicSpriteBatch(TContext& context, size_t maxSprites = 32768, size_t bufferCount = 3);
+			~BasicSpriteBatch();
+
+			/// <summary>
+			///		Starts a new batch
+			/// </summary>
+			/// <param name="transform">Transform applied to the sprite positions</param>
+			/// <param name="sortMode">Order in which the sprites are drawn</param>
+			void Begin(const glm::mat4& transform, SpriteSortMode sortMode = SpriteSortMode::Texture);
+
+			/// <summary>
+			///		Adds a sprite to the batch
+			/// </summary>
+			/// <param name="texture">Sprite texture ID</param>
+			/// <param name="position">Sprite position (where its origin is placed)</param>
+			/// <param name="size">Sprite size</param>
+			/// <param name="uvs">Texture coordinates rectangle (min x, min y, max x, max y)</param>
+			/// <param name="color">Sprite tint</param>
+			/// <param name="rotation">Sprite rotation around its origin, in radians</param>
+			/// <param name="origin">Sprite origin, relative to its size ((0, 0) is the bottom left corner, (1, 1) the top right one)</param>
+			void Draw(int texture, const glm::vec2& position, const glm::vec2& size,
+					  const glm::vec4& uvs = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), const glm::vec4& color = glm::vec4(1.0f),
+					  float rotation = 0.0f, const glm::vec2& origin = glm::vec2(0.5f));
+
+			/// <summary>
+			///		Draws every sprite added since Begin was called
+			/// </summary>
+			void End();
+
+			/// <summary>
+			///		Gets the number of draw calls issued by the last batch
+			/// </summary>
+			inline size_t GetDrawCallCount() const { return m_drawCallCount; }
+
+		private:
+			struct Sprite
+			{
+				int texture;
+				float rotation;
+				glm::vec2 position;
+				glm::vec2 size;
+				glm::vec2 origin;
+				glm::vec4 uvs;
+				unsigned char color[4];
+			};
+
+			struct Vertex
+			{
+				glm::vec2 position;
+				glm::vec2 uv;
+				unsigned char color[4];
+			};
+
+			void Flush();
+
+			TContext& m_context;
+
+			int m_program;
+			int m_vertShader;
+			int m_fragShader;
+			std::vector<int> m_vaos;
+			std::vector<int> m_vbos;
+			size_t m_nextBuffer;
+			size_t m_maxSprites;
+
+			bool m_active;
+			glm::mat4 m_transform;
+			SpriteSortMode m_sortMode;
+			std::vector<Sprite> m_sprites;
+			std::vector<uint64_t> m_sortKeys;
+			std::vector<Vertex> m_vertices;
+			size_t m_drawCallCount;
+		};
+
+		/// <summary>
+		///		Sprite batch using the build's render context type
+		/// </summary>
+		using SpriteBatch = BasicSpriteBatch<RenderContext>;
+	}
+}
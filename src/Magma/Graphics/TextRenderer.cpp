@@ -1,10 +1,14 @@
 #include "TextRenderer.hpp"
+#include "GLContext.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
-Magma::Graphics::TextRenderer::TextRenderer(Context & context)
+#include <stdexcept>
+
+template <typename TContext>
+Magma::Graphics::BasicTextRenderer<TContext>::BasicTextRenderer(TContext & context)
 	: m_context(context)
 {
 	// Compile default text shader
@@ -58,7 +62,8 @@ Magma::Graphics::TextRenderer::TextRenderer(Context & context)
 	m_context.SetVertexAttributePointer(m_vao, m_vbo, 0, 4, AttributeType::Float, false, 0, 0);
 }
 
-Magma::Graphics::TextRenderer::~TextRenderer()
+template <typename TContext>
+Magma::Graphics::BasicTextRenderer<TContext>::~BasicTextRenderer()
 {
 	// Destroy shaders
 	if (m_destroyShader)
@@ -76,7 +81,8 @@ Magma::Graphics::TextRenderer::~TextRenderer()
 	m_context.DestroyVertexArray(m_vao);
 }
 
-void Magma::Graphics::TextRenderer::Load(const std::string & fontPath, unsigned int fontSize)
+template <typename TContext>
+void Magma::Graphics::BasicTextRenderer<TContext>::Load(const std::string & fontPath, unsigned int fontSize)
 {
 	for (auto& c : m_characters)
 		m_context.DestroyTexture2D(c.second.texture);
@@ -130,14 +136,15 @@ void Magma::Graphics::TextRenderer::Load(const std::string & fontPath, unsigned
 										   texture,
 										   glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
 										   glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-										   face->glyph->advance.x }));
+										   (int)face->glyph->advance.x }));
 	}
 
 	FT_Done_Face(face);
 	FT_Done_FreeType(ft);
 }
 
-void Magma::Graphics::TextRenderer::Render(const std::string & text, const glm::mat4 & transform, const glm::vec3 & color)
+template <typename TContext>
+void Magma::Graphics::BasicTextRenderer<TContext>::Render(const std::string & text, const glm::mat4 & transform, const glm::vec3 & color)
 {
 	m_context.ActivateProgram(m_shaderProgram);
 	m_context.SetUniform4x4f(0, transform);
@@ -182,3 +189,6 @@ void Magma::Graphics::TextRenderer::Render(const std::string & text, const glm::
 
 	m_context.DeactivateProgram(m_shaderProgram);
 }
+
+template class Magma::Graphics::BasicTextRenderer<Magma::Graphics::Context>;
+template class Magma::Graphics::BasicTextRenderer<Magma::Graphics::GLContext>;
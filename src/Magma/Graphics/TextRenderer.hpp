@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Context.hpp"
+#include "RenderContext.hpp"
 
 #include <glm/glm.hpp>
 #include <string>
@@ -40,11 +40,13 @@ namespace Magma
 		///		A renderer class used to render a single font.
 		///		In order to use another font, you need to create another TextRenderer object for it.
 		/// </summary>
-		class TextRenderer
+		/// <typeparam name="TContext">Context type the renderer calls (instantiated for Context and GLContext)</typeparam>
+		template <typename TContext>
+		class BasicTextRenderer
 		{
 		public:
-			TextRenderer(Context& context);
-			~TextRenderer();
+			BasicTextRenderer(TContext& context);
+			~BasicTextRenderer();
 
 			inline void SetShaderProgram(int shaderProgram) { m_shaderProgram = shaderProgram; m_destroyShader = false; }
 			inline int GetShaderProgram() { return m_shaderProgram; }
@@ -57,7 +59,7 @@ namespace Magma
 		private:
 			std::map<char, Character> m_characters;
 
-			Context& m_context;
+			TContext& m_context;
 
 			int m_vao, m_vbo;
 			int m_shaderProgram;
@@ -65,5 +67,10 @@ namespace Magma
 			int m_fragShader;
 			bool m_destroyShader;
 		};
+
+		/// <summary>
+		///		Text renderer using the build's render context type
+		/// </summary>
+		using TextRenderer = BasicTextRenderer<RenderContext>;
 	}
 }
\ No newline at end of file
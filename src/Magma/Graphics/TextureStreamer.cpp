@@ -0,0 +1,155 @@
+#include "TextureStreamer.hpp"
+
+#include <cstring>
+#include <sstream>
+
+// Staged uploads start on this boundary, so that row data is always aligned for the context
+static constexpr size_t StagingAlignment = 16;
+
+Magma::Graphics::TextureStreamer::TextureStreamer(Context & context, size_t ringSize, size_t frameBudget)
+	: m_context(context)
+{
+	if (ringSize == 0)
+		throw std::runtime_error("Failed to create TextureStreamer: ring size must be greater than zero");
+
+	m_ringSize = ringSize;
+	m_frameBudget = frameBudget;
+	m_head = 0;
+	m_used = 0;
+
+	m_pixelBuffer = m_context.CreatePixelBuffer(m_ringSize);
+	m_pointer = (unsigned char*)m_context.GetPixelBufferPointer(m_pixelBuffer);
+}
+
+Magma::Graphics::TextureStreamer::~TextureStreamer()
+{
+	for (auto& b : m_inFlight)
+		m_context.DestroyFence(b.fence);
+	m_context.DestroyPixelBuffer(m_pixelBuffer);
+}
+
+bool Magma::Graphics::TextureStreamer::Stage(int texture, int level, size_t x, size_t y, size_t width, size_t height, PixelFormat format, PixelType type, const void * data, size_t size, std::function<void()> onComplete)
+{
+	if (size > m_ringSize)
+	{
+		std::stringstream ss;
+		ss << "Failed to stage texture upload on TextureStreamer: upload size (" << size << ") is bigger than the ring size (" << m_ringSize << ")";
+		throw std::runtime_error(ss.str());
+	}
+
+	Upload* upload;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Allocate ring space, wrapping to the start if the upload doesn't fit at the end
+		size_t offset = (m_head + StagingAlignment - 1) & ~(StagingAlignment - 1);
+		size_t padding;
+		if (offset + size > m_ringSize)
+		{
+			padding = m_ringSize - m_head;
+			offset = 0;
+		}
+		else padding = offset - m_head;
+
+		if (m_used + padding + size > m_ringSize)
+			return false;
+
+		m_used += padding + size;
+		m_head = offset + size;
+
+		// Pending uploads are kept in allocation order, so that ring space is always freed in FIFO order
+		m_pending.emplace_back();
+		upload = &m_pending.back();
+		upload->texture = texture;
+		upload->level = level;
+		upload->x = x;
+		upload->y = y;
+		upload->width = width;
+		upload->height = height;
+		upload->format = format;
+		upload->type = type;
+		upload->offset = offset;
+		upload->size = size;
+		upload->allocated = padding + size;
+		upload->onComplete = std::move(onComplete);
+		upload->ready.store(false, std::memory_order_relaxed);
+	}
+
+	// Copy outside of the lock so that several loader threads can fill the ring at the same time
+	std::memcpy(m_pointer + upload->offset, data, size);
+	upload->ready.store(true, std::memory_order_release);
+
+	return true;
+}
+
+void Magma::Graphics::TextureStreamer::Update()
+{
+	// Retire the batches the context has already finished
+	while (!m_inFlight.empty() && m_context.IsFenceSignaled(m_inFlight.front().fence))
+	{
+		auto& batch = m_inFlight.front();
+		m_context.DestroyFence(batch.fence);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_used -= batch.allocated;
+		}
+
+		for (auto& c : batch.callbacks)
+			c();
+		m_inFlight.pop_front();
+	}
+
+	// Issue the uploads that fit in this frame's budget (at least one is always issued, so big uploads can't starve)
+	Batch batch;
+	batch.fence = 0;
+	batch.allocated = 0;
+	size_t uploaded = 0;
+	bool bound = false;
+
+	while (true)
+	{
+		Upload* upload;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_pending.empty())
+				break;
+			upload = &m_pending.front();
+		}
+
+		if (!upload->ready.load(std::memory_order_acquire))
+			break;
+		if (uploaded != 0 && uploaded + upload->size > m_frameBudget)
+			break;
+
+		if (!bound)
+		{
+			m_context.BindPixelBuffer(m_pixelBuffer);
+			m_context.SetUnpackAlignment(1);
+			bound = true;
+		}
+
+		m_context.ActivateTexture2D(upload->texture, 0);
+		m_context.TextureSubData2D(upload->level, upload->x, upload->y, upload->width, upload->height, upload->format, upload->type, (const void*)upload->offset);
+		m_context.DeactivateTexture2D(upload->texture, 0);
+
+		uploaded += upload->size;
+		batch.allocated += upload->allocated;
+		if (upload->onComplete)
+			batch.callbacks.push_back(std::move(upload->onComplete));
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pending.pop_front();
+		}
+	}
+
+	if (bound)
+	{
+		m_context.BindPixelBuffer(0);
+		batch.fence = m_context.CreateFence();
+		m_inFlight.push_back(std::move(batch));
+	}
+}
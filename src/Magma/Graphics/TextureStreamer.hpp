@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Context.hpp"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Streams texture data into the context asynchronously.
+		///		Loader threads stage pixel data into a persistently mapped pixel buffer ring, and the render thread
+		///		uploads it into the textures, limited by a per frame byte budget, so that big textures don't cause frame spikes.
+		/// </summary>
+		class TextureStreamer final
+		{
+		public:
+			/// <summary>
+			///		Creates a new texture streamer (must be called on the render thread)
+			/// </summary>
+			/// <param name="context">Context where the textures live</param>
+			/// <param name="ringSize">Staging ring size in bytes (an upload can't be bigger than this)</param>
+			/// <param name="frameBudget">Maximum number of bytes uploaded each frame</param>
+			TextureStreamer(Context& context, size_t ringSize, size_t frameBudget);
+			~TextureStreamer();
+
+			/// <summary>
+			///		Stages a texture region upload (thread safe, may be called from any thread).
+			///		The texture level must already have storage (e.g.: set with TextureData2D and a null data pointer).
+			/// </summary>
+			/// <param name="texture">Texture ID</param>
+			/// <param name="level">Texture LOD level</param>
+			/// <param name="x">Region left X coordinate</param>
+			/// <param name="y">Region lower Y coordinate</param>
+			/// <param name="width">Region width</param>
+			/// <param name="height">Region height</param>
+			/// <param name="format">Pixel data format</param>
+			/// <param name="type">Pixel data type</param>
+			/// <param name="data">Tightly packed pixel data (copied into the staging ring)</param>
+			/// <param name="size">Pixel data size in bytes</param>
+			/// <param name="onComplete">Called on the render thread once the context has finished the upload</param>
+			/// <returns>True if the upload was staged, false if the ring is currently full (try again later)</returns>
+			bool Stage(int texture, int level, size_t x, size_t y, size_t width, size_t height, PixelFormat format, PixelType type, const void* data, size_t size, std::function<void()> onComplete = nullptr);
+
+			/// <summary>
+			///		Issues the staged uploads that fit in this frame's budget and retires the completed ones (call once per frame on the render thread)
+			/// </summary>
+			void Update();
+
+			inline size_t GetFrameBudget() const { return m_frameBudget; }
+			inline void SetFrameBudget(size_t frameBudget) { m_frameBudget = frameBudget; }
+
+			inline size_t GetRingSize() const { return m_ringSize; }
+
+		private:
+			struct Upload
+			{
+				int texture;
+				int level;
+				size_t x, y, width, height;
+				PixelFormat format;
+				PixelType type;
+				size_t offset;
+				size_t size;
+				size_t allocated;
+				std::function<void()> onComplete;
+				std::atomic<bool> ready;
+			};
+
+			struct Batch
+			{
+				int fence;
+				size_t allocated;
+				std::vector<std::function<void()>> callbacks;
+			};
+
+			Context& m_context;
+
+			int m_pixelBuffer;
+			unsigned char* m_pointer;
+			size_t m_ringSize;
+			size_t m_frameBudget;
+
+			std::mutex m_mutex;
+			size_t m_head;
+			size_t m_used;
+			std::deque<Upload> m_pending;
+			std::deque<Batch> m_inFlight;
+		};
+	}
+}
@@ -0,0 +1,498 @@
+#include "TracePlayer.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+Magma::Graphics::TracePlayer::TracePlayer(Context & context, const std::string & path)
+	: m_context(context)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		throw std::runtime_error("Failed to load trace on TracePlayer: couldn't open file '" + path + "'");
+
+	m_trace.resize((size_t)file.tellg());
+	file.seekg(0);
+	file.read((char*)m_trace.data(), m_trace.size());
+	m_position = 0;
+
+	if (m_trace.size() < sizeof(uint32_t) * 2 || this->Read<uint32_t>() != ContextTraceMagic)
+		throw std::runtime_error("Failed to load trace on TracePlayer: '" + path + "' isn't a context trace");
+
+	auto version = this->Read<uint32_t>();
+	if (version != ContextTraceVersion)
+	{
+		std::stringstream ss;
+		ss << "Failed to load trace on TracePlayer: unsupported trace version " << version << " (expected " << ContextTraceVersion << ")";
+		throw std::runtime_error(ss.str());
+	}
+
+	m_ids[0] = 0;
+	m_boundPixelBuffer = 0;
+	m_frameCount = 0;
+	m_frameCallCount = 0;
+	for (auto& ms : m_callMilliseconds)
+		ms = 0.0;
+}
+
+bool Magma::Graphics::TracePlayer::PlayFrame()
+{
+	if (this->IsFinished())
+		return false;
+
+	m_frameCallCount = 0;
+	for (auto& ms : m_callMilliseconds)
+		ms = 0.0;
+
+	while (!this->IsFinished())
+	{
+		auto call = (ContextCall)this->Read<uint16_t>();
+		if (call <= ContextCall::Invalid || call >= ContextCall::Count)
+		{
+			std::stringstream ss;
+			ss << "Failed to play trace on TracePlayer: invalid call " << (int)call << " at offset " << m_position;
+			throw std::runtime_error(ss.str());
+		}
+
+		if (call == ContextCall::EndFrame)
+			break;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		this->PlayCall(call);
+		m_callMilliseconds[(size_t)call] += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		++m_frameCallCount;
+	}
+
+	++m_frameCount;
+	return true;
+}
+
+void Magma::Graphics::TracePlayer::PlayCall(ContextCall call)
+{
+	switch (call)
+	{
+		case ContextCall::CreateShader:
+		{
+			auto type = (ShaderType)this->ReadInt();
+			auto src = this->ReadString();
+			this->AddID(m_context.CreateShader(type, src.c_str()));
+			break;
+		}
+
+		case ContextCall::CreateProgram: this->AddID(m_context.CreateProgram()); break;
+		case ContextCall::LinkProgram: m_context.LinkProgram(this->ReadID()); break;
+
+		case ContextCall::AttachShader:
+		{
+			auto program = this->ReadID();
+			auto shader = this->ReadID();
+			m_context.AttachShader(program, shader);
+			break;
+		}
+
+		case ContextCall::DestroyShader: m_context.DestroyShader(this->ReadID()); break;
+		case ContextCall::DestroyProgram: m_context.DestroyProgram(this->ReadID()); break;
+
+		case ContextCall::DetachShader:
+		{
+			auto program = this->ReadID();
+			auto shader = this->ReadID();
+			m_context.DetachShader(program, shader);
+			break;
+		}
+
+		case ContextCall::CreateStaticVertexBuffer:
+		case ContextCall::CreateDynamicVertexBuffer:
+		{
+			auto vao = this->ReadID();
+			auto data = (void*)this->ReadData();
+			auto size = (size_t)this->ReadUnsigned();
+			if (call == ContextCall::CreateStaticVertexBuffer)
+				this->AddID(m_context.CreateStaticVertexBuffer(vao, data, size));
+			else
+				this->AddID(m_context.CreateDynamicVertexBuffer(vao, data, size));
+			break;
+		}
+
+		case ContextCall::SetDynamicVertexBufferData:
+		{
+			auto vao = this->ReadID();
+			auto vbo = this->ReadID();
+			auto data = (void*)this->ReadData();
+			auto size = (size_t)this->ReadUnsigned();
+			m_context.SetDynamicVertexBufferData(vao, vbo, data, size);
+			break;
+		}
+
+		case ContextCall::CreateVertexArray: this->AddID(m_context.CreateVertexArray()); break;
+
+		case ContextCall::SetVertexAttributePointer:
+		{
+			auto vao = this->ReadID();
+			auto vbo = this->ReadID();
+			auto index = this->ReadInt();
+			auto size = this->ReadInt();
+			auto type = (AttributeType)this->ReadInt();
+			auto normalized = this->ReadBool();
+			auto stride = (size_t)this->ReadUnsigned();
+			auto offset = (const void*)(uintptr_t)this->ReadUnsigned();
+			m_context.SetVertexAttributePointer(vao, vbo, index, size, type, normalized, stride, offset);
+			break;
+		}
+
+		case ContextCall::DestroyVertexBuffer: m_context.DestroyVertexBuffer(this->ReadID()); break;
+		case ContextCall::DestroyVertexArray: m_context.DestroyVertexArray(this->ReadID()); break;
+
+		case ContextCall::CreateIndexBuffer:
+		{
+			auto vao = this->ReadID();
+			auto data = this->ReadData();
+			auto size = (size_t)this->ReadUnsigned();
+			this->AddID(m_context.CreateIndexBuffer(vao, data, size));
+			break;
+		}
+
+		case ContextCall::DestroyIndexBuffer: m_context.DestroyIndexBuffer(this->ReadID()); break;
+
+		case ContextCall::DrawIndexedVertexArray:
+		{
+			auto vao = this->ReadID();
+			auto mode = (DrawMode)this->ReadInt();
+			auto type = (IndexType)this->ReadInt();
+			auto first = (size_t)this->ReadUnsigned();
+			auto count = (size_t)this->ReadUnsigned();
+			m_context.DrawIndexedVertexArray(vao, mode, type, first, count);
+			break;
+		}
+
+		case ContextCall::DrawVertexArray:
+		{
+			auto vao = this->ReadID();
+			auto mode = (DrawMode)this->ReadInt();
+			auto first = this->ReadInt();
+			auto count = (size_t)this->ReadUnsigned();
+			m_context.DrawVertexArray(vao, mode, first, count);
+			break;
+		}
+
+		case ContextCall::ActivateProgram: m_context.ActivateProgram(this->ReadID()); break;
+		case ContextCall::DeactivateProgram: m_context.DeactivateProgram(this->ReadID()); break;
+
+		case ContextCall::SetUniform1i: { auto index = this->ReadInt(); m_context.SetUniform1i(index, this->ReadInt()); break; }
+		case ContextCall::SetUniform1f: { auto index = this->ReadInt(); m_context.SetUniform1f(index, this->ReadFloat()); break; }
+		case ContextCall::SetUniform2i: { auto index = this->ReadInt(); m_context.SetUniform2i(index, this->Read<glm::ivec2>()); break; }
+		case ContextCall::SetUniform2f: { auto index = this->ReadInt(); m_context.SetUniform2f(index, this->Read<glm::vec2>()); break; }
+		case ContextCall::SetUniform3i: { auto index = this->ReadInt(); m_context.SetUniform3i(index, this->Read<glm::ivec3>()); break; }
+		case ContextCall::SetUniform3f: { auto index = this->ReadInt(); m_context.SetUniform3f(index, this->Read<glm::vec3>()); break; }
+		case ContextCall::SetUniform4i: { auto index = this->ReadInt(); m_context.SetUniform4i(index, this->Read<glm::ivec4>()); break; }
+		case ContextCall::SetUniform4f: { auto index = this->ReadInt(); m_context.SetUniform4f(index, this->Read<glm::vec4>()); break; }
+		case ContextCall::SetUniform3x3f: { auto index = this->ReadInt(); m_context.SetUniform3x3f(index, this->Read<glm::mat3>()); break; }
+		case ContextCall::SetUniform4x4f: { auto index = this->ReadInt(); m_context.SetUniform4x4f(index, this->Read<glm::mat4>()); break; }
+
+		case ContextCall::SetUniform1iv:
+		case ContextCall::SetUniform1fv:
+		case ContextCall::SetUniform2iv:
+		case ContextCall::SetUniform2fv:
+		case ContextCall::SetUniform3iv:
+		case ContextCall::SetUniform3fv:
+		case ContextCall::SetUniform4iv:
+		case ContextCall::SetUniform4fv:
+		case ContextCall::SetUniform3x3fv:
+		case ContextCall::SetUniform4x4fv:
+		{
+			auto index = this->ReadInt();
+			auto count = (size_t)this->ReadUnsigned();
+			auto data = this->ReadData();
+			switch (call)
+			{
+				case ContextCall::SetUniform1iv: m_context.SetUniform1iv(index, count, (int*)data); break;
+				case ContextCall::SetUniform1fv: m_context.SetUniform1fv(index, count, (float*)data); break;
+				case ContextCall::SetUniform2iv: m_context.SetUniform2iv(index, count, (const glm::ivec2*)data); break;
+				case ContextCall::SetUniform2fv: m_context.SetUniform2fv(index, count, (const glm::vec2*)data); break;
+				case ContextCall::SetUniform3iv: m_context.SetUniform3iv(index, count, (const glm::ivec3*)data); break;
+				case ContextCall::SetUniform3fv: m_context.SetUniform3fv(index, count, (const glm::vec3*)data); break;
+				case ContextCall::SetUniform4iv: m_context.SetUniform4iv(index, count, (const glm::ivec4*)data); break;
+				case ContextCall::SetUniform4fv: m_context.SetUniform4fv(index, count, (const glm::vec4*)data); break;
+				case ContextCall::SetUniform3x3fv: m_context.SetUniform3x3fv(index, count, (const glm::mat3*)data); break;
+				case ContextCall::SetUniform4x4fv: m_context.SetUniform4x4fv(index, count, (const glm::mat4*)data); break;
+				default: break;
+			}
+			break;
+		}
+
+		case ContextCall::SetViewport:
+		{
+			auto x = this->ReadFloat();
+			auto y = this->ReadFloat();
+			auto width = this->ReadFloat();
+			auto height = this->ReadFloat();
+			m_context.SetViewport(x, y, width, height);
+			break;
+		}
+
+		case ContextCall::CreateFramebuffer: this->AddID(m_context.CreateFramebuffer()); break;
+		case ContextCall::DestroyFramebuffer: m_context.DestroyFramebuffer(this->ReadID()); break;
+
+		case ContextCall::BindFramebuffer:
+		{
+			auto target = (FramebufferTarget)this->ReadInt();
+			m_context.BindFramebuffer(target, this->ReadID());
+			break;
+		}
+
+		case ContextCall::FramebufferTexture2D:
+		{
+			auto target = (FramebufferTarget)this->ReadInt();
+			auto attachment = (FramebufferAttachment)this->ReadInt();
+			auto texture = this->ReadID();
+			auto level = this->ReadInt();
+			m_context.FramebufferTexture2D(target, attachment, texture, level);
+			break;
+		}
+
+		case ContextCall::FramebufferRenderbuffer:
+		{
+			auto target = (FramebufferTarget)this->ReadInt();
+			auto attachment = (FramebufferAttachment)this->ReadInt();
+			m_context.FramebufferRenderbuffer(target, attachment, this->ReadID());
+			break;
+		}
+
+		case ContextCall::IsFramebufferComplete: m_context.IsFramebufferComplete((FramebufferTarget)this->ReadInt()); break;
+
+		case ContextCall::CreateRenderbuffer:
+		{
+			auto format = (TargetFormat)this->ReadInt();
+			auto width = (size_t)this->ReadUnsigned();
+			auto height = (size_t)this->ReadUnsigned();
+			auto samples = (size_t)this->ReadUnsigned();
+			this->AddID(m_context.CreateRenderbuffer(format, width, height, samples));
+			break;
+		}
+
+		case ContextCall::DestroyRenderbuffer: m_context.DestroyRenderbuffer(this->ReadID()); break;
+
+		case ContextCall::SetDrawBuffers:
+		{
+			auto count = (size_t)this->ReadUnsigned();
+			std::vector<FramebufferAttachment> attachments(count);
+			for (auto& a : attachments)
+				a = (FramebufferAttachment)this->ReadInt();
+			m_context.SetDrawBuffers(count, count == 0 ? nullptr : attachments.data());
+			break;
+		}
+
+		case ContextCall::BlitFramebuffer:
+		{
+			int coords[8];
+			for (auto& c : coords)
+				c = this->ReadInt();
+			auto mask = (BufferBit)this->ReadInt();
+			auto filter = (Filter)this->ReadInt();
+			m_context.BlitFramebuffer(coords[0], coords[1], coords[2], coords[3], coords[4], coords[5], coords[6], coords[7], mask, filter);
+			break;
+		}
+
+		case ContextCall::ReadPixels:
+		{
+			auto x = this->ReadInt();
+			auto y = this->ReadInt();
+			auto width = (size_t)this->ReadUnsigned();
+			auto height = (size_t)this->ReadUnsigned();
+			auto format = (PixelFormat)this->ReadInt();
+			auto type = (PixelType)this->ReadInt();
+			m_readback.resize((size_t)this->ReadUnsigned());
+			m_context.ReadPixels(x, y, width, height, format, type, m_readback.data());
+			break;
+		}
+
+		case ContextCall::CreateTexture2D: this->AddID(m_context.CreateTexture2D()); break;
+		case ContextCall::DestroyTexture2D: m_context.DestroyTexture2D(this->ReadID()); break;
+
+		case ContextCall::ActivateTexture2D:
+		case ContextCall::DeactivateTexture2D:
+		{
+			auto texture = this->ReadID();
+			auto slot = this->ReadInt();
+			if (call == ContextCall::ActivateTexture2D)
+				m_context.ActivateTexture2D(texture, slot);
+			else
+				m_context.DeactivateTexture2D(texture, slot);
+			break;
+		}
+
+		case ContextCall::TextureData2D:
+		case ContextCall::TextureSubData2D:
+		{
+			auto level = this->ReadInt();
+			size_t x = 0, y = 0;
+			PixelFormat internalFormat = PixelFormat::Invalid;
+			if (call == ContextCall::TextureData2D)
+				internalFormat = (PixelFormat)this->ReadInt();
+			else
+			{
+				x = (size_t)this->ReadUnsigned();
+				y = (size_t)this->ReadUnsigned();
+			}
+			auto width = (size_t)this->ReadUnsigned();
+			auto height = (size_t)this->ReadUnsigned();
+			auto format = (PixelFormat)this->ReadInt();
+			auto type = (PixelType)this->ReadInt();
+
+			// Pixel buffer uploads are played by copying the recorded contents into the pixel buffer bound now
+			const void* data;
+			if (this->ReadBool())
+			{
+				auto offset = this->ReadUnsigned();
+				size_t size;
+				auto contents = this->ReadData(&size);
+				if (contents != nullptr && m_boundPixelBuffer != 0)
+					std::memcpy((char*)m_context.GetPixelBufferPointer(m_boundPixelBuffer) + offset, contents, size);
+				data = (const void*)(uintptr_t)offset;
+			}
+			else data = this->ReadData();
+
+			if (call == ContextCall::TextureData2D)
+				m_context.TextureData2D(level, internalFormat, width, height, format, type, (void*)data);
+			else
+				m_context.TextureSubData2D(level, x, y, width, height, format, type, data);
+			break;
+		}
+
+		case ContextCall::TextureStorage2D:
+		{
+			auto levels = (size_t)this->ReadUnsigned();
+			auto format = (TargetFormat)this->ReadInt();
+			auto width = (size_t)this->ReadUnsigned();
+			auto height = (size_t)this->ReadUnsigned();
+			m_context.TextureStorage2D(levels, format, width, height);
+			break;
+		}
+
+		case ContextCall::SetTextureMinFilter: m_context.SetTextureMinFilter((Filter)this->ReadInt()); break;
+		case ContextCall::SetTextureMagFilter: m_context.SetTextureMagFilter((Filter)this->ReadInt()); break;
+		case ContextCall::SetTextureWrapSMode: m_context.SetTextureWrapSMode((WrapMode)this->ReadInt()); break;
+		case ContextCall::SetTextureWrapTMode: m_context.SetTextureWrapTMode((WrapMode)this->ReadInt()); break;
+		case ContextCall::Clear: m_context.Clear((BufferBit)this->ReadInt()); break;
+		case ContextCall::InsertBarrier: m_context.InsertBarrier((BarrierBit)this->ReadInt()); break;
+		case ContextCall::SetUnpackAlignment: m_context.SetUnpackAlignment(this->ReadInt()); break;
+
+		case ContextCall::CreatePixelBuffer: this->AddID(m_context.CreatePixelBuffer((size_t)this->ReadUnsigned())); break;
+		case ContextCall::DestroyPixelBuffer: m_context.DestroyPixelBuffer(this->ReadID()); break;
+		case ContextCall::GetPixelBufferPointer: m_context.GetPixelBufferPointer(this->ReadID()); break;
+
+		case ContextCall::BindPixelBuffer:
+			m_boundPixelBuffer = this->ReadID();
+			m_context.BindPixelBuffer(m_boundPixelBuffer);
+			break;
+
+		case ContextCall::CreateFence: this->AddID(m_context.CreateFence()); break;
+		case ContextCall::IsFenceSignaled: m_context.IsFenceSignaled(this->ReadID()); break;
+
+		// Blocking waits and query reads are skipped, as they would stall the CPU on the GPU and skew the measured call times
+		// (their results were only used by the recorded application, never by the following calls)
+		case ContextCall::WaitFence:
+			this->ReadID();
+			this->ReadUnsigned();
+			break;
+
+		case ContextCall::DestroyFence: m_context.DestroyFence(this->ReadID()); break;
+		case ContextCall::CreateTimerQuery: this->AddID(m_context.CreateTimerQuery()); break;
+		case ContextCall::DestroyTimerQuery: m_context.DestroyTimerQuery(this->ReadID()); break;
+		case ContextCall::QueryTimestamp: m_context.QueryTimestamp(this->ReadID()); break;
+		case ContextCall::IsTimerQueryAvailable: m_context.IsTimerQueryAvailable(this->ReadID()); break;
+		case ContextCall::GetTimerQueryResult: this->ReadID(); break;
+
+		default:
+		{
+			std::stringstream ss;
+			ss << "Failed to play trace on TracePlayer: unsupported call " << GetContextCallName(call);
+			throw std::runtime_error(ss.str());
+		}
+	}
+}
+
+template <typename T>
+T Magma::Graphics::TracePlayer::Read()
+{
+	if (m_trace.size() - m_position < sizeof(T))
+		throw std::runtime_error("Failed to play trace on TracePlayer: trace is truncated");
+
+	T value;
+	std::memcpy(&value, &m_trace[m_position], sizeof(T));
+	m_position += sizeof(T);
+	return value;
+}
+
+int Magma::Graphics::TracePlayer::ReadInt()
+{
+	return this->Read<int32_t>();
+}
+
+uint64_t Magma::Graphics::TracePlayer::ReadUnsigned()
+{
+	return this->Read<uint64_t>();
+}
+
+bool Magma::Graphics::TracePlayer::ReadBool()
+{
+	return this->Read<uint8_t>() != 0;
+}
+
+float Magma::Graphics::TracePlayer::ReadFloat()
+{
+	return this->Read<float>();
+}
+
+std::string Magma::Graphics::TracePlayer::ReadString()
+{
+	auto length = (size_t)this->ReadUnsigned();
+	if (m_trace.size() - m_position < length)
+		throw std::runtime_error("Failed to play trace on TracePlayer: trace is truncated");
+
+	std::string string((const char*)&m_trace[m_position], length);
+	m_position += length;
+	return string;
+}
+
+const void * Magma::Graphics::TracePlayer::ReadData(size_t * size)
+{
+	auto dataSize = (size_t)this->ReadUnsigned();
+	if (size != nullptr)
+		*size = dataSize;
+	if (dataSize == 0)
+		return nullptr;
+
+	auto hash = this->ReadUnsigned();
+	if (this->ReadBool())
+	{
+		if (m_trace.size() - m_position < dataSize)
+			throw std::runtime_error("Failed to play trace on TracePlayer: trace is truncated");
+		m_payloads[hash] = &m_trace[m_position];
+		m_position += dataSize;
+	}
+
+	auto it = m_payloads.find(hash);
+	if (it == m_payloads.end())
+		throw std::runtime_error("Failed to play trace on TracePlayer: trace references a payload which wasn't stored");
+	return it->second;
+}
+
+int Magma::Graphics::TracePlayer::ReadID()
+{
+	auto id = this->ReadInt();
+	auto it = m_ids.find(id);
+	if (it == m_ids.end())
+	{
+		std::stringstream ss;
+		ss << "Failed to play trace on TracePlayer: object " << id << " wasn't created in the trace (was the trace started after it was created?)";
+		throw std::runtime_error(ss.str());
+	}
+	return it->second;
+}
+
+void Magma::Graphics::TracePlayer::AddID(int id)
+{
+	m_ids[this->ReadInt()] = id;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "RecordingContext.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Magma
+{
+	namespace Graphics
+	{
+		/// <summary>
+		///		Plays back a trace written by a RecordingContext against another context, one frame at a time.
+		///		Object IDs in the trace are remapped to the objects created by the target context.
+		///		Fence waits and timer query result reads are skipped, so the played calls are timed without stalling on the GPU.
+		/// </summary>
+		class TracePlayer final
+		{
+		public:
+			/// <summary>
+			///		Loads a trace file
+			/// </summary>
+			/// <param name="context">Context where the calls are played</param>
+			/// <param name="path">Trace file path</param>
+			TracePlayer(Context& context, const std::string& path);
+			~TracePlayer() = default;
+
+			/// <summary>
+			///		Plays the calls of the next frame in the trace
+			/// </summary>
+			/// <returns>False if the trace has already ended</returns>
+			bool PlayFrame();
+
+			/// <summary>
+			///		Has the whole trace been played?
+			/// </summary>
+			inline bool IsFinished() const { return m_position >= m_trace.size(); }
+
+			/// <summary>
+			///		Gets the number of frames played
+			/// </summary>
+			inline size_t GetFrameCount() const { return m_frameCount; }
+
+			/// <summary>
+			///		Gets the number of calls played on the last frame
+			/// </summary>
+			inline size_t GetFrameCallCount() const { return m_frameCallCount; }
+
+			/// <summary>
+			///		Gets the CPU time spent on a call type during the last frame played, in milliseconds
+			/// </summary>
+			inline double GetCallMilliseconds(ContextCall call) const { return m_callMilliseconds[(size_t)call]; }
+
+		private:
+			void PlayCall(ContextCall call);
+
+			template <typename T> T Read();
+			int ReadInt();
+			uint64_t ReadUnsigned();
+			bool ReadBool();
+			float ReadFloat();
+			std::string ReadString();
+			const void* ReadData(size_t* size = nullptr);
+			int ReadID();
+			void AddID(int id);
+
+			Context& m_context;
+
+			std::vector<unsigned char> m_trace;
+			size_t m_position;
+			std::unordered_map<uint64_t, const unsigned char*> m_payloads;
+			std::unordered_map<int, int> m_ids;
+			std::vector<unsigned char> m_readback;
+			int m_boundPixelBuffer;
+
+			size_t m_frameCount;
+			size_t m_frameCallCount;
+			double m_callMilliseconds[(size_t)ContextCall::Count];
+		};
+	}
+}
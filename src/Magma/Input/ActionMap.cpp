@@ -0,0 +1,267 @@
+#include "ActionMap.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static const char* KeyboardNames[] =
+{
+	"Q", "W", "E", "R", "T", "Y", "U", "I", "O", "P",
+	"A", "S", "D", "F", "G", "H", "J", "K", "L",
+	"Z", "X", "C", "V", "B", "N", "M",
+	"Num1", "Num2", "Num3", "Num4", "Num5", "Num6", "Num7", "Num8", "Num9", "Num0",
+	"F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "F10", "F11", "F12",
+	"Escape",
+	"Tab",
+	"Caps",
+	"LShift",
+	"RShift",
+	"LControl",
+	"RControl",
+	"Alt",
+	"AltGr",
+	"Space",
+	"Enter",
+	"Backspace",
+	"Insert",
+	"Delete",
+	"Home",
+	"End",
+	"PageUp",
+	"PageDown",
+};
+
+static_assert(sizeof(KeyboardNames) / sizeof(*KeyboardNames) == (size_t)Magma::Input::Keyboard::Count, "Every keyboard key must have a name");
+
+static const char* MouseNames[] =
+{
+	"MouseLeft",
+	"MouseRight",
+	"MouseMiddle",
+};
+
+static_assert(sizeof(MouseNames) / sizeof(*MouseNames) == (size_t)Magma::Input::Mouse::Count, "Every mouse button must have a name");
+
+static std::string Trim(const std::string& str)
+{
+	auto first = str.find_first_not_of(" \t\r");
+	if (first == std::string::npos)
+		return "";
+	auto last = str.find_last_not_of(" \t\r");
+	return str.substr(first, last - first + 1);
+}
+
+Magma::Input::ActionMap::ActionMap()
+{
+	std::memset(m_first, 0, sizeof(m_first));
+	m_dirty = false;
+}
+
+void Magma::Input::ActionMap::Load(const std::string & path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+		throw std::runtime_error("Failed to load action map on ActionMap: couldn't open file '" + path + "'");
+	this->Load(file);
+}
+
+void Magma::Input::ActionMap::Load(std::istream & stream)
+{
+	std::string line;
+	size_t lineNumber = 0;
+	while (std::getline(stream, line))
+	{
+		++lineNumber;
+		auto error = [&](const std::string& message)
+		{
+			std::stringstream ss;
+			ss << "Failed to load action map on ActionMap: line " << lineNumber << ": " << message;
+			throw std::runtime_error(ss.str());
+		};
+
+		auto comment = line.find('#');
+		if (comment != std::string::npos)
+			line.erase(comment);
+		line = Trim(line);
+		if (line.empty())
+			continue;
+
+		auto equals = line.find('=');
+		if (equals == std::string::npos)
+			error("expected 'Action = Bindings'");
+		auto name = Trim(line.substr(0, equals));
+		if (name.empty())
+			error("missing action name");
+		auto action = this->AddAction(name);
+
+		std::stringstream bindings(line.substr(equals + 1));
+		std::string binding;
+		while (std::getline(bindings, binding, ','))
+		{
+			binding = Trim(binding);
+			if (binding.empty())
+				error("empty binding for action '" + name + "'");
+
+			// The last token is the key or button, the ones before it are modifiers (so "Alt" alone is the key, "Alt+F4" the modifier)
+			std::vector<std::string> tokens;
+			std::stringstream tokenStream(binding);
+			std::string token;
+			while (std::getline(tokenStream, token, '+'))
+				tokens.push_back(Trim(token));
+
+			auto modifiers = KeyModifiers::None;
+			for (size_t i = 0; i + 1 < tokens.size(); ++i)
+			{
+				if (tokens[i] == "Shift")
+					modifiers |= KeyModifiers::Shift;
+				else if (tokens[i] == "Control")
+					modifiers |= KeyModifiers::Control;
+				else if (tokens[i] == "Alt")
+					modifiers |= KeyModifiers::Alt;
+				else error("unknown modifier '" + tokens[i] + "' in binding '" + binding + "'");
+			}
+
+			size_t input = InputCount;
+			auto& inputName = tokens.empty() ? binding : tokens.back();
+			for (size_t i = 0; i < (size_t)Keyboard::Count && input == InputCount; ++i)
+				if (inputName == KeyboardNames[i])
+					input = i;
+			for (size_t i = 0; i < (size_t)Mouse::Count && input == InputCount; ++i)
+				if (inputName == MouseNames[i])
+					input = (size_t)Keyboard::Count + i;
+
+			if (input == InputCount)
+				error("unknown key or button '" + inputName + "' in binding '" + binding + "'");
+			this->AddBinding(action, input, modifiers);
+		}
+	}
+}
+
+size_t Magma::Input::ActionMap::AddAction(const std::string & name)
+{
+	auto it = m_actionIndices.find(name);
+	if (it != m_actionIndices.end())
+		return it->second;
+
+	auto action = m_actionNames.size();
+	m_actionNames.push_back(name);
+	m_actionIndices[name] = action;
+	m_down.push_back(0);
+	m_previousDown.push_back(0);
+	m_pressed.push_back(0);
+	m_released.push_back(0);
+	return action;
+}
+
+size_t Magma::Input::ActionMap::GetAction(const std::string & name) const
+{
+	auto it = m_actionIndices.find(name);
+	if (it == m_actionIndices.end())
+		throw std::runtime_error("Failed to get action on ActionMap: no action named '" + name + "'");
+	return it->second;
+}
+
+void Magma::Input::ActionMap::Bind(size_t action, Keyboard key, KeyModifiers modifiers)
+{
+	if (key == Keyboard::Invalid || key == Keyboard::Count)
+		throw std::runtime_error("Failed to bind action on ActionMap: invalid key");
+	this->AddBinding(action, (size_t)key, modifiers);
+}
+
+void Magma::Input::ActionMap::Bind(size_t action, Mouse button, KeyModifiers modifiers)
+{
+	if (button == Mouse::Invalid || button == Mouse::Count)
+		throw std::runtime_error("Failed to bind action on ActionMap: invalid mouse button");
+	this->AddBinding(action, (size_t)Keyboard::Count + (size_t)button, modifiers);
+}
+
+void Magma::Input::ActionMap::Unbind(size_t action)
+{
+	if (action >= m_actionNames.size())
+		throw std::runtime_error("Failed to unbind action on ActionMap: invalid action");
+
+	m_bindings.erase(std::remove_if(m_bindings.begin(), m_bindings.end(), [&](const Binding& b) { return b.action == action; }), m_bindings.end());
+	m_dirty = true;
+}
+
+void Magma::Input::ActionMap::Update(const InputSnapshot & snapshot)
+{
+	if (m_dirty)
+		this->Compile();
+
+	m_down.swap(m_previousDown);
+	std::fill(m_down.begin(), m_down.end(), 0);
+	std::fill(m_pressed.begin(), m_pressed.end(), 0);
+	std::fill(m_released.begin(), m_released.end(), 0);
+
+	// Modifiers come from the held keys, as the snapshot's modifiers are only those of the last key event
+	// (releasing another key after Control would otherwise drop Control from every chord)
+	auto modifiers = KeyModifiers::None;
+	if (snapshot.keysDown[(size_t)Keyboard::LShift] || snapshot.keysDown[(size_t)Keyboard::RShift])
+		modifiers |= KeyModifiers::Shift;
+	if (snapshot.keysDown[(size_t)Keyboard::LControl] || snapshot.keysDown[(size_t)Keyboard::RControl])
+		modifiers |= KeyModifiers::Control;
+	if (snapshot.keysDown[(size_t)Keyboard::Alt] || snapshot.keysDown[(size_t)Keyboard::AltGr])
+		modifiers |= KeyModifiers::Alt;
+	auto apply = [&](size_t input, bool down, bool pressed)
+	{
+		for (auto i = m_first[input]; i < m_first[input + 1]; ++i)
+		{
+			auto& binding = m_table[i];
+			if ((modifiers & binding.modifiers) != binding.modifiers)
+				continue;
+			m_down[binding.action] |= down;
+			m_pressed[binding.action] |= pressed;
+		}
+	};
+
+	for (size_t i = 0; i < (size_t)Keyboard::Count; ++i)
+		if (snapshot.keysDown[i] || snapshot.keysPressed[i])
+			apply(i, snapshot.keysDown[i], snapshot.keysPressed[i]);
+	for (size_t i = 0; i < (size_t)Mouse::Count; ++i)
+		if (snapshot.buttonsDown[i] || snapshot.buttonsPressed[i])
+			apply((size_t)Keyboard::Count + i, snapshot.buttonsDown[i], snapshot.buttonsPressed[i]);
+
+	// Actions also change state when a chord's modifier is pressed or released while its input is held,
+	// and actions tapped within a single frame are both pressed and released
+	for (size_t i = 0; i < m_down.size(); ++i)
+	{
+		m_pressed[i] |= m_down[i] && !m_previousDown[i];
+		m_released[i] = (m_previousDown[i] || m_pressed[i]) && !m_down[i];
+	}
+}
+
+void Magma::Input::ActionMap::AddBinding(size_t action, size_t input, KeyModifiers modifiers)
+{
+	if ((modifiers & KeyModifiers::System) != KeyModifiers::None)
+		throw std::runtime_error("Failed to bind action on ActionMap: the System modifier has no key and can't be used in chords");
+	if (action >= m_actionNames.size())
+		throw std::runtime_error("Failed to bind action on ActionMap: invalid action");
+
+	for (auto& b : m_bindings)
+		if (b.action == action && b.input == input && b.modifiers == modifiers)
+			return;
+
+	m_bindings.push_back(Binding { (uint32_t)input, (uint32_t)action, modifiers });
+	m_dirty = true;
+}
+
+void Magma::Input::ActionMap::Compile()
+{
+	// Counting sort of the bindings by input code
+	std::memset(m_first, 0, sizeof(m_first));
+	for (auto& b : m_bindings)
+		++m_first[b.input + 1];
+	for (size_t i = 0; i < InputCount; ++i)
+		m_first[i + 1] += m_first[i];
+
+	m_table.resize(m_bindings.size());
+	uint32_t next[InputCount];
+	std::memcpy(next, m_first, sizeof(next));
+	for (auto& b : m_bindings)
+		m_table[next[b.input]++] = b;
+
+	m_dirty = false;
+}
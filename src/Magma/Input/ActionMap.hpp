@@ -0,0 +1,139 @@
+#pragma once
+
+#include "InputSnapshot.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Magma
+{
+	namespace Input
+	{
+		/// <summary>
+		///		Maps keys, mouse buttons and chords (inputs with modifiers) to named actions, and keeps the state of each action per frame.
+		///		Bindings are compiled into a flat table indexed by input code, so updating the actions from an input snapshot only touches the
+		///		bindings of the inputs which are held or changed, and querying an action is a single array lookup.
+		///
+		///		Action map files have one action per line, bound to a comma separated list of inputs, each optionally prefixed by modifiers:
+		///			# Comment
+		///			Jump = Space
+		///			Save = Control+S, F5
+		///			Fire = MouseLeft
+		///		Input names are the Keyboard and Mouse enum names (mouse buttons prefixed by "Mouse"), and modifiers are Shift, Control and Alt.
+		///		A chord is active while its input is down and at least its modifiers are held (either Shift, Control or Alt/AltGr key).
+		/// </summary>
+		class ActionMap final
+		{
+		public:
+			ActionMap();
+			~ActionMap() = default;
+
+			/// <summary>
+			///		Loads actions and bindings from an action map file (added to the ones already in the map)
+			/// </summary>
+			/// <param name="path">Action map file path</param>
+			void Load(const std::string& path);
+
+			/// <summary>
+			///		Loads actions and bindings from an action map stream (added to the ones already in the map)
+			/// </summary>
+			/// <param name="stream">Stream</param>
+			void Load(std::istream& stream);
+
+			/// <summary>
+			///		Adds an action (does nothing if it already exists)
+			/// </summary>
+			/// <param name="name">Action name</param>
+			/// <returns>Action index (used to query its state)</returns>
+			size_t AddAction(const std::string& name);
+
+			/// <summary>
+			///		Gets the index of an action (throws if it doesn't exist)
+			/// </summary>
+			/// <param name="name">Action name</param>
+			/// <returns>Action index (used to query its state)</returns>
+			size_t GetAction(const std::string& name) const;
+
+			/// <summary>
+			///		Does an action exist?
+			/// </summary>
+			inline bool HasAction(const std::string& name) const { return m_actionIndices.find(name) != m_actionIndices.end(); }
+
+			/// <summary>
+			///		Gets the number of actions
+			/// </summary>
+			inline size_t GetActionCount() const { return m_actionNames.size(); }
+
+			/// <summary>
+			///		Gets the name of an action
+			/// </summary>
+			inline const std::string& GetActionName(size_t action) const { return m_actionNames[action]; }
+
+			/// <summary>
+			///		Binds a key chord to an action (the System modifier isn't supported, as it has no key)
+			/// </summary>
+			void Bind(size_t action, Keyboard key, KeyModifiers modifiers = KeyModifiers::None);
+
+			/// <summary>
+			///		Binds a mouse button chord to an action (the System modifier isn't supported, as it has no key)
+			/// </summary>
+			void Bind(size_t action, Mouse button, KeyModifiers modifiers = KeyModifiers::None);
+
+			/// <summary>
+			///		Removes every binding of an action
+			/// </summary>
+			void Unbind(size_t action);
+
+			/// <summary>
+			///		Updates the state of every action from a frame's input snapshot (call once per frame)
+			/// </summary>
+			void Update(const InputSnapshot& snapshot);
+
+			/// <summary>
+			///		Is an action held down?
+			/// </summary>
+			inline bool IsDown(size_t action) const { return m_down[action] != 0; }
+
+			/// <summary>
+			///		Was an action triggered during the last updated frame?
+			/// </summary>
+			inline bool WasPressed(size_t action) const { return m_pressed[action] != 0; }
+
+			/// <summary>
+			///		Was an action released during the last updated frame?
+			/// </summary>
+			inline bool WasReleased(size_t action) const { return m_released[action] != 0; }
+
+		private:
+			// Keys are followed by mouse buttons in the input codes
+			static constexpr size_t InputCount = (size_t)Keyboard::Count + (size_t)Mouse::Count;
+
+			struct Binding
+			{
+				uint32_t input;
+				uint32_t action;
+				KeyModifiers modifiers;
+			};
+
+			void AddBinding(size_t action, size_t input, KeyModifiers modifiers);
+			void Compile();
+
+			std::vector<std::string> m_actionNames;
+			std::unordered_map<std::string, size_t> m_actionIndices;
+
+			// Bindings as added, and compiled into a flat table sorted by input code (the bindings of input i are in [m_first[i], m_first[i + 1]))
+			std::vector<Binding> m_bindings;
+			std::vector<Binding> m_table;
+			uint32_t m_first[InputCount + 1];
+			bool m_dirty;
+
+			std::vector<uint8_t> m_down;
+			std::vector<uint8_t> m_previousDown;
+			std::vector<uint8_t> m_pressed;
+			std::vector<uint8_t> m_released;
+		};
+	}
+}
@@ -1,27 +1,172 @@
 #pragma once
 
-#include <functional>
-#include <map>
+#include "../Core/Delegate.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 namespace Magma
 {
 	namespace Input
 	{
+		/// <summary>
+		///		Event which calls its listeners when fired.
+		///		Listeners are stored contiguously as non-allocating delegates and called in the order they were added.
+		///		Listeners can be added and removed while the event is being fired: added listeners are first called on the next Fire,
+		///		and removed listeners aren't called anymore, even on the Fire which is running.
+		///
+		///		Listeners can be added, removed and fired from any thread. The listener list is only locked while it is updated, never while
+		///		listeners are called, so listeners are called concurrently when the event is fired from several threads at once, and a listener
+		///		removed from another thread may still be called once by a Fire which was already running.
+		/// </summary>
 		template <typename ... TArgs>
 		class Event
 		{
 		public:
-			inline Event() { m_nextID = 1; }
+			/// <summary>
+			///		Listener delegate type
+			/// </summary>
+			using Listener = Delegate<void(TArgs...)>;
+
+			inline Event() { m_nextID = 1; m_fireDepth = 0; m_removedCount = 0; }
 			inline ~Event() { }
 
-			inline size_t AddListener(std::function<void(TArgs...)> listener) { m_listeners.try_emplace(m_nextID, listener); return m_nextID++; }
-			inline void RemoveListener(size_t listener) { m_listeners.erase(listener); }
+			/// <summary>
+			///		Adds a listener to the event
+			/// </summary>
+			/// <returns>Listener ID (used to remove it)</returns>
+			inline size_t AddListener(Listener listener)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				// Listeners added while firing are kept aside, as growing the array could move the listener being called
+				auto& entries = m_fireDepth == 0 ? m_entries : m_added;
+				entries.emplace_back(m_nextID, std::move(listener));
+				return m_nextID++;
+			}
+
+			/// <summary>
+			///		Removes a listener from the event (does nothing if the listener was already removed)
+			/// </summary>
+			/// <param name="listener">Listener ID</param>
+			inline void RemoveListener(size_t listener)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				// IDs only grow and removed entries keep theirs, so both arrays stay sorted by ID
+				auto find = [&](std::vector<Entry>& entries)
+				{
+					auto it = std::lower_bound(entries.begin(), entries.end(), listener, [](const Entry& e, size_t id) { return e.id < id; });
+					return it != entries.end() && it->id == listener && !it->removed.load(std::memory_order_relaxed) ? it : entries.end();
+				};
+
+				auto it = find(m_added);
+				if (it != m_added.end())
+				{
+					m_added.erase(it);
+					return;
+				}
+
+				it = find(m_entries);
+				if (it == m_entries.end())
+					return;
+
+				// Listeners removed while firing are only marked, the array is compacted once the outermost Fire returns
+				if (m_fireDepth == 0)
+					m_entries.erase(it);
+				else
+				{
+					it->removed.store(true, std::memory_order_relaxed);
+					++m_removedCount;
+				}
+			}
+
+			/// <summary>
+			///		Calls every listener
+			/// </summary>
+			inline void Fire(TArgs ... args)
+			{
+				// The array isn't resized or compacted while a Fire is running, so it is read without holding the lock
+				FireScope scope(*this);
+				for (size_t i = 0; i < scope.count; ++i)
+					if (!m_entries[i].removed.load(std::memory_order_relaxed))
+						m_entries[i].listener(args...);
+			}
 
-			inline void Fire(TArgs ... args) { for (auto& l : m_listeners) l.second(args...); }
+			/// <summary>
+			///		Gets the number of listeners
+			/// </summary>
+			inline size_t GetListenerCount() const
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				return m_entries.size() - m_removedCount + m_added.size();
+			}
 
 		private:
+			struct Entry
+			{
+				inline Entry(size_t id, Listener listener) : id(id), removed(false), listener(std::move(listener)) { }
+
+				// Entries are only moved while no Fire is running, so the flag doesn't need to be moved atomically
+				inline Entry(Entry&& other) : id(other.id), removed(other.removed.load(std::memory_order_relaxed)), listener(std::move(other.listener)) { }
+				inline Entry& operator=(Entry&& other)
+				{
+					id = other.id;
+					removed.store(other.removed.load(std::memory_order_relaxed), std::memory_order_relaxed);
+					listener = std::move(other.listener);
+					return *this;
+				}
+
+				size_t id;
+				std::atomic<bool> removed;
+				Listener listener;
+			};
+
+			// Keeps the fire depth right even if a listener throws, and applies the changes made while firing when the outermost Fire returns
+			struct FireScope
+			{
+				inline FireScope(Event& event) : event(event)
+				{
+					std::lock_guard<std::mutex> lock(event.m_mutex);
+					++event.m_fireDepth;
+					count = event.m_entries.size();
+				}
+
+				inline ~FireScope()
+				{
+					std::lock_guard<std::mutex> lock(event.m_mutex);
+					if (--event.m_fireDepth == 0)
+						event.ApplyChanges();
+				}
+
+				Event& event;
+				size_t count;
+			};
+
+			inline void ApplyChanges()
+			{
+				if (m_removedCount != 0)
+				{
+					m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [](const Entry& e) { return e.removed.load(std::memory_order_relaxed); }), m_entries.end());
+					m_removedCount = 0;
+				}
+
+				if (!m_added.empty())
+				{
+					for (auto& e : m_added)
+						m_entries.push_back(std::move(e));
+					m_added.clear();
+				}
+			}
+
+			mutable std::mutex m_mutex;
 			size_t m_nextID;
-			std::map<size_t, std::function<void(TArgs...)>> m_listeners;
+			size_t m_fireDepth;
+			size_t m_removedCount;
+			std::vector<Entry> m_entries;
+			std::vector<Entry> m_added;
 		};
 	}
-}
\ No newline at end of file
+}
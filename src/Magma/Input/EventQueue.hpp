@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Event.hpp"
+#include "../Core/MPSCQueue.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Magma
+{
+	namespace Input
+	{
+		/// <summary>
+		///		Queue of deferred event calls, owned by the thread which consumes them.
+		///		Listeners subscribed through a queue aren't called when the event fires: the event's arguments are pushed into the queue
+		///		(lock-free, so the queue doesn't add any locking to the event's own), and the listeners are called on the consumer thread when it
+		///		dispatches the queue, at the point of the frame it chooses. A dispatch drains every queued call in a single pass.
+		///		Subscribe and Unsubscribe can be called from any thread, including while the event is fired on another one, so worker threads
+		///		can subscribe their own queues to events fired on the main thread.
+		/// </summary>
+		class EventQueue final
+		{
+		public:
+			/// <summary>
+			///		Creates a new event queue
+			/// </summary>
+			/// <param name="capacity">Maximum number of queued calls (power of two), calls fired while the queue is full are dropped</param>
+			inline EventQueue(size_t capacity = 4096) : m_queue(capacity) { m_droppedCount = 0; }
+
+			/// <summary>
+			///		Removes the queue's listeners from the events still subscribed to, as they point to the queue.
+			///		Must be destroyed before the events, while they aren't being fired (a Fire already running could still push into the queue).
+			/// </summary>
+			inline ~EventQueue()
+			{
+				std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+				for (auto& s : m_subscriptions)
+					if (s->active.load(std::memory_order_relaxed))
+						s->Remove();
+			}
+
+			EventQueue(const EventQueue&) = delete;
+			EventQueue& operator=(const EventQueue&) = delete;
+
+			/// <summary>
+			///		Subscribes a listener to an event, deferring its calls into this queue (can be called from any thread).
+			///		The event's arguments must fit with a pointer in a Delegate (queued calls never allocate).
+			/// </summary>
+			/// <param name="event">Event</param>
+			/// <param name="listener">Listener called when the queue is dispatched</param>
+			/// <returns>Listener ID on the event (used to unsubscribe)</returns>
+			template <typename ... TArgs>
+			size_t Subscribe(Event<TArgs...>& event, typename Event<TArgs...>::Listener listener)
+			{
+				// The lock is held until the ID is set, so a concurrent Unsubscribe never sees the subscription without it
+				std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+				std::unique_ptr<SubscriptionBase> owner(new Subscription<TArgs...>(event, std::move(listener)));
+				auto subscription = static_cast<Subscription<TArgs...>*>(owner.get());
+				m_subscriptions.push_back(std::move(owner));
+
+				auto queue = this;
+				subscription->id = event.AddListener([queue, subscription](TArgs ... args)
+				{
+					queue->Push([subscription, args...]()
+					{
+						if (subscription->active.load(std::memory_order_acquire))
+							subscription->listener(args...);
+					});
+				});
+				return subscription->id;
+			}
+
+			/// <summary>
+			///		Unsubscribes a listener from an event (can be called from any thread).
+			///		Calls already queued are discarded, but a Fire running on another thread may still queue one last call, which is discarded too.
+			/// </summary>
+			/// <param name="event">Event</param>
+			/// <param name="listener">Listener ID returned by Subscribe</param>
+			template <typename ... TArgs>
+			void Unsubscribe(Event<TArgs...>& event, size_t listener)
+			{
+				// Listener IDs are only unique per event, so the subscription is found by both
+				// (subscriptions are only freed with the queue, as queued calls may still point to them)
+				std::lock_guard<std::mutex> lock(m_subscriptionsMutex);
+				for (auto& s : m_subscriptions)
+					if (s->id == listener && s->event == &event && s->active.load(std::memory_order_relaxed))
+					{
+						s->active.store(false, std::memory_order_release);
+						event.RemoveListener(listener);
+						return;
+					}
+			}
+
+			/// <summary>
+			///		Calls the listeners of every call queued before this call (must only be called from the consumer thread)
+			/// </summary>
+			/// <returns>Number of calls dispatched</returns>
+			inline size_t Dispatch()
+			{
+				return m_queue.Drain([](Delegate<void()>& call) { call(); });
+			}
+
+			/// <summary>
+			///		Gets the number of calls dropped because the queue was full
+			/// </summary>
+			inline size_t GetDroppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+
+		private:
+			struct SubscriptionBase
+			{
+				SubscriptionBase(const void* event) : active(true), id(0), event(event) { }
+				virtual ~SubscriptionBase() = default;
+
+				// Removes the queue's listener from the event
+				virtual void Remove() = 0;
+
+				std::atomic<bool> active;
+				size_t id;
+				const void* event;
+			};
+
+			template <typename ... TArgs>
+			struct Subscription final : SubscriptionBase
+			{
+				Subscription(Event<TArgs...>& event, typename Event<TArgs...>::Listener listener) : SubscriptionBase(&event), typedEvent(event), listener(std::move(listener)) { }
+
+				virtual void Remove() override { typedEvent.RemoveListener(id); }
+
+				Event<TArgs...>& typedEvent;
+				typename Event<TArgs...>::Listener listener;
+			};
+
+			inline void Push(Delegate<void()> call)
+			{
+				if (!m_queue.TryPush(std::move(call)))
+					m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			MPSCQueue<Delegate<void()>> m_queue;
+			std::atomic<size_t> m_droppedCount;
+
+			std::mutex m_subscriptionsMutex;
+			std::vector<std::unique_ptr<SubscriptionBase>> m_subscriptions;
+		};
+	}
+}
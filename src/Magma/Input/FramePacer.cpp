@@ -0,0 +1,94 @@
+#include "FramePacer.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+Magma::Input::FramePacer::FramePacer(size_t historySize)
+{
+	if (historySize == 0)
+		throw std::runtime_error("Failed to create FramePacer: history size must be at least 1");
+
+	m_frameRateLimit = 0.0;
+	m_framePeriod = Clock::duration(0);
+	m_spinThreshold = std::chrono::milliseconds(2);
+	m_smoothing = 0.1;
+	m_deadline = Clock::time_point();
+	m_lastPresent = Clock::time_point();
+	m_presented = false;
+	m_lastWaitTime = std::chrono::nanoseconds(0);
+	m_frameMilliseconds = 0.0;
+	m_smoothedFrameMilliseconds = 0.0;
+	m_history.resize(historySize, 0.0);
+	m_historyCount = 0;
+	m_historyIndex = 0;
+}
+
+void Magma::Input::FramePacer::SetFrameRateLimit(double framesPerSecond)
+{
+	if (framesPerSecond < 0.0)
+		throw std::runtime_error("Failed to set frame rate limit on FramePacer: frame rate can't be negative");
+
+	m_frameRateLimit = framesPerSecond;
+	m_framePeriod = framesPerSecond > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond)) : Clock::duration(0);
+	m_deadline = Clock::time_point();
+}
+
+void Magma::Input::FramePacer::Wait()
+{
+	m_lastWaitTime = std::chrono::nanoseconds(0);
+	if (m_frameRateLimit <= 0.0)
+		return;
+
+	auto start = Clock::now();
+	if (start >= m_deadline)
+	{
+		// The deadline was missed (or this is the first frame), restart the grid from now
+		m_deadline = start + m_framePeriod;
+		return;
+	}
+
+	if (m_deadline - start > m_spinThreshold)
+		std::this_thread::sleep_for(m_deadline - start - m_spinThreshold);
+	while (Clock::now() < m_deadline)
+		std::this_thread::yield();
+
+	m_lastWaitTime = Clock::now() - start;
+	m_deadline += m_framePeriod;
+}
+
+void Magma::Input::FramePacer::Present()
+{
+	auto now = Clock::now();
+	if (m_presented)
+	{
+		m_frameMilliseconds = std::chrono::duration<double, std::milli>(now - m_lastPresent).count();
+		if (m_historyCount == 0)
+			m_smoothedFrameMilliseconds = m_frameMilliseconds;
+		else m_smoothedFrameMilliseconds += (m_frameMilliseconds - m_smoothedFrameMilliseconds) * m_smoothing;
+
+		m_history[m_historyIndex] = m_frameMilliseconds;
+		m_historyIndex = (m_historyIndex + 1) % m_history.size();
+		if (m_historyCount < m_history.size())
+			++m_historyCount;
+	}
+
+	m_lastPresent = now;
+	m_presented = true;
+}
+
+double Magma::Input::FramePacer::GetJitterMilliseconds() const
+{
+	if (m_historyCount < 2)
+		return 0.0;
+
+	double mean = 0.0;
+	for (size_t i = 0; i < m_historyCount; ++i)
+		mean += m_history[i];
+	mean /= m_historyCount;
+
+	double variance = 0.0;
+	for (size_t i = 0; i < m_historyCount; ++i)
+		variance += (m_history[i] - mean) * (m_history[i] - mean);
+	return std::sqrt(variance / (m_historyCount - 1));
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+namespace Magma
+{
+	namespace Input
+	{
+		/// <summary>
+		///		Limits the frame rate and measures the time between consecutive presents.
+		///		Frames are scheduled on a fixed grid of deadlines: the limiter sleeps until shortly before the deadline (OS sleeps
+		///		overshoot by up to the scheduler's granularity), then spins for the rest, so frames are released with sub-millisecond accuracy.
+		///		A frame which misses its deadline restarts the grid instead of letting the next frames catch up in a burst.
+		/// </summary>
+		class FramePacer final
+		{
+		public:
+			/// <summary>
+			///		Creates a new frame pacer
+			/// </summary>
+			/// <param name="historySize">Number of frame times used to measure jitter</param>
+			FramePacer(size_t historySize = 120);
+			~FramePacer() = default;
+
+			/// <summary>
+			///		Sets the maximum frame rate
+			/// </summary>
+			/// <param name="framesPerSecond">Maximum frames per second (0 for no limit)</param>
+			void SetFrameRateLimit(double framesPerSecond);
+
+			/// <summary>
+			///		Gets the maximum frame rate (0 if there's no limit)
+			/// </summary>
+			inline double GetFrameRateLimit() const { return m_frameRateLimit; }
+
+			/// <summary>
+			///		Sets how long before a deadline the limiter stops sleeping and starts spinning (trades CPU time for accuracy)
+			/// </summary>
+			inline void SetSpinThreshold(std::chrono::nanoseconds threshold) { m_spinThreshold = threshold; }
+
+			/// <summary>
+			///		Sets the weight of the last frame time in the smoothed frame time, in the range ]0, 1] (1 disables smoothing)
+			/// </summary>
+			inline void SetSmoothing(double weight) { m_smoothing = weight; }
+
+			/// <summary>
+			///		Blocks until the current frame's deadline (call right before presenting)
+			/// </summary>
+			void Wait();
+
+			/// <summary>
+			///		Records that the frame was presented (call right after presenting)
+			/// </summary>
+			void Present();
+
+			/// <summary>
+			///		Gets the time between the last two presents, in milliseconds
+			/// </summary>
+			inline double GetFrameMilliseconds() const { return m_frameMilliseconds; }
+
+			/// <summary>
+			///		Gets the exponentially smoothed time between presents, in milliseconds
+			/// </summary>
+			inline double GetSmoothedFrameMilliseconds() const { return m_smoothedFrameMilliseconds; }
+
+			/// <summary>
+			///		Gets the standard deviation of the time between presents over the last frames, in milliseconds
+			/// </summary>
+			double GetJitterMilliseconds() const;
+
+			/// <summary>
+			///		Gets how long the last Wait call blocked
+			/// </summary>
+			inline std::chrono::nanoseconds GetLastWaitTime() const { return m_lastWaitTime; }
+
+		private:
+			using Clock = std::chrono::steady_clock;
+
+			double m_frameRateLimit;
+			Clock::duration m_framePeriod;
+			std::chrono::nanoseconds m_spinThreshold;
+			double m_smoothing;
+
+			Clock::time_point m_deadline;
+			Clock::time_point m_lastPresent;
+			bool m_presented;
+			std::chrono::nanoseconds m_lastWaitTime;
+
+			double m_frameMilliseconds;
+			double m_smoothedFrameMilliseconds;
+			std::vector<double> m_history;
+			size_t m_historyCount;
+			size_t m_historyIndex;
+		};
+	}
+}
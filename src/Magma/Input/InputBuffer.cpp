@@ -0,0 +1,72 @@
+#include "InputBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+Magma::Input::InputBuffer::InputBuffer(size_t capacity)
+{
+	if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+		throw std::runtime_error("Failed to create InputBuffer: capacity must be a power of two");
+
+	m_capacity = capacity;
+	m_slots.reset(new Slot[capacity]);
+	for (size_t i = 0; i < capacity; ++i)
+	{
+		m_slots[i].sequence.store(0, std::memory_order_relaxed);
+		for (auto& w : m_slots[i].words)
+			w.store(0, std::memory_order_relaxed);
+	}
+	m_writeCursor.store(0, std::memory_order_relaxed);
+}
+
+void Magma::Input::InputBuffer::Push(const InputEvent & event)
+{
+	uint64_t words[EventWords] = {};
+	std::memcpy(words, &event, sizeof(event));
+
+	auto cursor = m_writeCursor.load(std::memory_order_relaxed);
+	auto& slot = m_slots[cursor & (m_capacity - 1)];
+
+	slot.sequence.store(2 * cursor + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (size_t i = 0; i < EventWords; ++i)
+		slot.words[i].store(words[i], std::memory_order_relaxed);
+	slot.sequence.store(2 * (cursor + 1), std::memory_order_release);
+
+	m_writeCursor.store(cursor + 1, std::memory_order_release);
+}
+
+size_t Magma::Input::InputBuffer::Read(uint64_t & cursor, InputEvent * events, size_t maxCount) const
+{
+	size_t count = 0;
+	while (count < maxCount)
+	{
+		auto writeCursor = m_writeCursor.load(std::memory_order_acquire);
+		if (cursor >= writeCursor)
+			break;
+
+		// Skip the events which were already overwritten
+		if (writeCursor - cursor > m_capacity)
+			cursor = writeCursor - m_capacity;
+
+		auto& slot = m_slots[cursor & (m_capacity - 1)];
+		auto sequence = slot.sequence.load(std::memory_order_acquire);
+		uint64_t words[EventWords];
+		for (size_t i = 0; i < EventWords; ++i)
+			words[i] = slot.words[i].load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// The slot was rewritten (or is being rewritten) with a newer event while it was copied, retry from the oldest event still available
+		if (sequence != 2 * (cursor + 1) || slot.sequence.load(std::memory_order_relaxed) != sequence)
+		{
+			cursor = std::max(cursor + 1, m_writeCursor.load(std::memory_order_acquire) - m_capacity + 1);
+			continue;
+		}
+
+		std::memcpy(&events[count++], words, sizeof(InputEvent));
+		++cursor;
+	}
+
+	return count;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Keyboard.hpp"
+#include "Mouse.hpp"
+
+namespace Magma
+{
+	namespace Input
+	{
+		/// <summary>
+		///		Raw input event types
+		/// </summary>
+		enum class InputEventType : int32_t
+		{
+			Invalid = -1,
+
+			KeyDown,
+			KeyUp,
+			MouseDown,
+			MouseUp,
+			MouseMove,
+			MouseScroll,
+			MouseEnter,
+			MouseLeave,
+			Text,
+			Close,
+
+			Count
+		};
+
+		/// <summary>
+		///		Raw timestamped input event
+		/// </summary>
+		struct InputEvent
+		{
+			/// <summary>
+			///		Time when the event was received, in seconds
+			/// </summary>
+			double time;
+
+			/// <summary>
+			///		Event type
+			/// </summary>
+			InputEventType type;
+
+			/// <summary>
+			///		Keyboard key (KeyDown, KeyUp), mouse button (MouseDown, MouseUp) or unicode codepoint (Text)
+			/// </summary>
+			int32_t code;
+
+			/// <summary>
+			///		Key modifiers (KeyDown, KeyUp)
+			/// </summary>
+			KeyModifiers modifiers;
+
+			/// <summary>
+			///		Mouse position (MouseMove) or scroll offsets (MouseScroll)
+			/// </summary>
+			float x, y;
+		};
+
+		/// <summary>
+		///		Fixed size lock-free ring buffer of input events, with a single writer and any number of readers on any threads.
+		///		Each reader keeps its own cursor, so reading doesn't consume events for the other readers.
+		///		The writer never waits: readers which fall more than the buffer's capacity behind lose the oldest events.
+		/// </summary>
+		class InputBuffer final
+		{
+		public:
+			/// <summary>
+			///		Creates a new input buffer
+			/// </summary>
+			/// <param name="capacity">Number of events kept (power of two)</param>
+			InputBuffer(size_t capacity = 1024);
+			~InputBuffer() = default;
+
+			InputBuffer(const InputBuffer&) = delete;
+			InputBuffer& operator=(const InputBuffer&) = delete;
+
+			/// <summary>
+			///		Writes an event (must only be called from the writer thread)
+			/// </summary>
+			void Push(const InputEvent& event);
+
+			/// <summary>
+			///		Reads the events written since the cursor (can be called from any thread)
+			/// </summary>
+			/// <param name="cursor">Reader cursor (start at GetWriteCursor() to only read new events), advanced past the events read</param>
+			/// <param name="events">Array where the events are copied</param>
+			/// <param name="maxCount">Maximum number of events read</param>
+			/// <returns>Number of events read</returns>
+			size_t Read(uint64_t& cursor, InputEvent* events, size_t maxCount) const;
+
+			/// <summary>
+			///		Gets the cursor of the next event written
+			/// </summary>
+			inline uint64_t GetWriteCursor() const { return m_writeCursor.load(std::memory_order_acquire); }
+
+			/// <summary>
+			///		Gets the buffer capacity
+			/// </summary>
+			inline size_t GetCapacity() const { return m_capacity; }
+
+		private:
+			static constexpr size_t EventWords = (sizeof(InputEvent) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+			// Each slot is a sequence lock: the sequence is odd while the slot is written, and 2 * (cursor + 1) once the event at cursor is in it.
+			// Events are copied as relaxed atomic words, so a reader racing with the writer gets a torn copy (detected by the sequence) instead of undefined behaviour.
+			struct Slot
+			{
+				std::atomic<uint64_t> sequence;
+				std::atomic<uint64_t> words[EventWords];
+			};
+
+			size_t m_capacity;
+			std::unique_ptr<Slot[]> m_slots;
+			std::atomic<uint64_t> m_writeCursor;
+		};
+	}
+}
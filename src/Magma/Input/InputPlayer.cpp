@@ -0,0 +1,173 @@
+#include "InputPlayer.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+Magma::Input::InputPlayer::InputPlayer(const std::string & path)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		throw std::runtime_error("Failed to load input log on InputPlayer: couldn't open file '" + path + "'");
+
+	std::vector<unsigned char> log((size_t)file.tellg());
+	file.seekg(0);
+	file.read((char*)log.data(), log.size());
+
+	uint32_t header[2];
+	if (log.size() < sizeof(header))
+		throw std::runtime_error("Failed to load input log on InputPlayer: '" + path + "' isn't an input log");
+	std::memcpy(header, log.data(), sizeof(header));
+	if (header[0] != InputLogMagic)
+		throw std::runtime_error("Failed to load input log on InputPlayer: '" + path + "' isn't an input log");
+	if (header[1] != InputLogVersion)
+	{
+		std::stringstream ss;
+		ss << "Failed to load input log on InputPlayer: unsupported log version " << header[1] << " (expected " << InputLogVersion << ")";
+		throw std::runtime_error(ss.str());
+	}
+
+	size_t position = sizeof(header);
+	m_initialState.Clear();
+	m_initialState.mouseX = this->ReadFloat(log, position);
+	m_initialState.mouseY = this->ReadFloat(log, position);
+	if (position + 2 > log.size())
+		throw std::runtime_error("Failed to load input log on InputPlayer: '" + path + "' is truncated");
+	m_initialState.mouseInside = log[position++] != 0;
+	m_initialState.modifiers = (KeyModifiers)log[position++];
+	for (auto count = this->ReadVarint(log, position); count > 0; --count)
+	{
+		auto key = this->ReadVarint(log, position);
+		if (key >= (uint64_t)Keyboard::Count)
+			throw std::runtime_error("Failed to load input log on InputPlayer: '" + path + "' has an invalid initial key");
+		m_initialState.keysDown.set((size_t)key);
+	}
+	for (auto count = this->ReadVarint(log, position); count > 0; --count)
+	{
+		auto button = this->ReadVarint(log, position);
+		if (button >= (uint64_t)Mouse::Count)
+			throw std::runtime_error("Failed to load input log on InputPlayer: '" + path + "' has an invalid initial mouse button");
+		m_initialState.buttonsDown.set((size_t)button);
+	}
+
+	uint64_t frame = 0;
+	for (;;)
+	{
+		frame += this->ReadVarint(log, position);
+		auto count = (size_t)this->ReadVarint(log, position);
+
+		// An empty frame block ends the log
+		if (count == 0)
+			break;
+
+		m_frames.push_back(Frame { frame, m_events.size(), count });
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (position >= log.size())
+				throw std::runtime_error("Failed to load input log on InputPlayer: '" + path + "' is truncated");
+
+			InputEvent event;
+			event.type = (InputEventType)log[position++];
+			event.time = this->ReadVarint(log, position) / 1000000.0;
+			event.code = -1;
+			event.modifiers = KeyModifiers::None;
+			event.x = 0.0f;
+			event.y = 0.0f;
+
+			switch (event.type)
+			{
+				case InputEventType::KeyDown:
+				case InputEventType::KeyUp:
+				case InputEventType::MouseDown:
+				case InputEventType::MouseUp:
+				{
+					auto code = this->ReadVarint(log, position);
+					event.code = (int32_t)((code >> 1) ^ (~(code & 1) + 1));
+					if (position >= log.size())
+						throw std::runtime_error("Failed to load input log on InputPlayer: '" + path + "' is truncated");
+					event.modifiers = (KeyModifiers)log[position++];
+					break;
+				}
+
+				case InputEventType::Text:
+					event.code = (int32_t)this->ReadVarint(log, position);
+					break;
+
+				case InputEventType::MouseMove:
+				case InputEventType::MouseScroll:
+					event.x = this->ReadFloat(log, position);
+					event.y = this->ReadFloat(log, position);
+					break;
+
+				case InputEventType::MouseEnter:
+				case InputEventType::MouseLeave:
+				case InputEventType::Close:
+					break;
+
+				default:
+				{
+					std::stringstream ss;
+					ss << "Failed to load input log on InputPlayer: invalid event type " << (int)event.type << " at offset " << position - 1;
+					throw std::runtime_error(ss.str());
+				}
+			}
+
+			m_events.push_back(event);
+		}
+	}
+
+	m_nextFrame = 0;
+	m_frame = 0;
+	m_frameCount = frame;
+}
+
+size_t Magma::Input::InputPlayer::PlayFrame(InputBuffer & buffer, double time)
+{
+	if (this->IsFinished())
+		return 0;
+
+	size_t count = 0;
+	if (m_nextFrame < m_frames.size() && m_frames[m_nextFrame].frame == m_frame)
+	{
+		auto& frame = m_frames[m_nextFrame++];
+		for (size_t i = 0; i < frame.eventCount; ++i)
+		{
+			auto event = m_events[frame.firstEvent + i];
+			event.time += time;
+			buffer.Push(event);
+		}
+		count = frame.eventCount;
+	}
+
+	++m_frame;
+	return count;
+}
+
+uint64_t Magma::Input::InputPlayer::ReadVarint(const std::vector<unsigned char>& log, size_t & position) const
+{
+	uint64_t value = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		if (position >= log.size())
+			throw std::runtime_error("Failed to load input log on InputPlayer: log is truncated");
+
+		auto byte = log[position++];
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			return value;
+	}
+
+	throw std::runtime_error("Failed to load input log on InputPlayer: invalid variable length integer");
+}
+
+float Magma::Input::InputPlayer::ReadFloat(const std::vector<unsigned char>& log, size_t & position) const
+{
+	if (position + sizeof(float) > log.size())
+		throw std::runtime_error("Failed to load input log on InputPlayer: log is truncated");
+
+	float value;
+	std::memcpy(&value, &log[position], sizeof(float));
+	position += sizeof(float);
+	return value;
+}
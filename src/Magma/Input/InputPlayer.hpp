@@ -0,0 +1,79 @@
+#pragma once
+
+#include "InputRecorder.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Magma
+{
+	namespace Input
+	{
+		/// <summary>
+		///		Plays back an input log written by an InputRecorder, one frame at a time.
+		///		Each frame's events are written into an input buffer, timestamped relative to the frame's start as they were recorded.
+		/// </summary>
+		class InputPlayer final
+		{
+		public:
+			/// <summary>
+			///		Loads an input log file
+			/// </summary>
+			/// <param name="path">Log file path</param>
+			InputPlayer(const std::string& path);
+			~InputPlayer() = default;
+
+			InputPlayer(const InputPlayer&) = delete;
+			InputPlayer& operator=(const InputPlayer&) = delete;
+
+			/// <summary>
+			///		Writes the events of the next frame into an input buffer
+			/// </summary>
+			/// <param name="buffer">Buffer where the events are written</param>
+			/// <param name="time">Time when the previous frame's events were polled, in seconds (event times are relative to it)</param>
+			/// <returns>Number of events written</returns>
+			size_t PlayFrame(InputBuffer& buffer, double time);
+
+			/// <summary>
+			///		Gets the input state when the recording started, which must be restored before playing the first frame
+			///		(only the held keys and buttons, modifiers and mouse position and inside flag are set)
+			/// </summary>
+			inline const InputSnapshot& GetInitialState() const { return m_initialState; }
+
+			/// <summary>
+			///		Have all the recorded frames been played?
+			/// </summary>
+			inline bool IsFinished() const { return m_frame >= m_frameCount; }
+
+			/// <summary>
+			///		Gets the number of frames played
+			/// </summary>
+			inline uint64_t GetFrame() const { return m_frame; }
+
+			/// <summary>
+			///		Gets the number of frames in the log
+			/// </summary>
+			inline uint64_t GetFrameCount() const { return m_frameCount; }
+
+		private:
+			struct Frame
+			{
+				uint64_t frame;
+				size_t firstEvent;
+				size_t eventCount;
+			};
+
+			uint64_t ReadVarint(const std::vector<unsigned char>& log, size_t& position) const;
+			float ReadFloat(const std::vector<unsigned char>& log, size_t& position) const;
+
+			InputSnapshot m_initialState;
+
+			// Events are decoded when the log is loaded, with their time offsets in their time
+			std::vector<InputEvent> m_events;
+			std::vector<Frame> m_frames;
+			size_t m_nextFrame;
+			uint64_t m_frame;
+			uint64_t m_frameCount;
+		};
+	}
+}
@@ -0,0 +1,120 @@
+#include "InputRecorder.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+Magma::Input::InputRecorder::InputRecorder(const std::string & path, const InputSnapshot & initialState)
+{
+	m_log.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_log.is_open())
+		throw std::runtime_error("Failed to create InputRecorder: couldn't open file '" + path + "'");
+
+	m_log.write((const char*)&InputLogMagic, sizeof(InputLogMagic));
+	m_log.write((const char*)&InputLogVersion, sizeof(InputLogVersion));
+
+	// Initial state: cursor position, mouse inside flag, modifiers, then the held keys and buttons as counted lists of codes
+	this->WriteFloat(initialState.mouseX);
+	this->WriteFloat(initialState.mouseY);
+	m_frameData.push_back(initialState.mouseInside ? 1 : 0);
+	m_frameData.push_back((unsigned char)initialState.modifiers);
+	this->WriteVarint(initialState.keysDown.count());
+	for (size_t i = 0; i < (size_t)Keyboard::Count; ++i)
+		if (initialState.keysDown[i])
+			this->WriteVarint(i);
+	this->WriteVarint(initialState.buttonsDown.count());
+	for (size_t i = 0; i < (size_t)Mouse::Count; ++i)
+		if (initialState.buttonsDown[i])
+			this->WriteVarint(i);
+	m_log.write((const char*)m_frameData.data(), m_frameData.size());
+	m_frameData.clear();
+
+	m_frameEventCount = 0;
+	m_frameTime = 0.0;
+	m_frameCount = 0;
+	m_lastWrittenFrame = 0;
+}
+
+Magma::Input::InputRecorder::~InputRecorder()
+{
+	// The end of the log is an empty frame block, placed on the frame after the last one recorded
+	m_frameData.clear();
+	this->WriteVarint(m_frameCount - m_lastWrittenFrame);
+	this->WriteVarint(0);
+	m_log.write((const char*)m_frameData.data(), m_frameData.size());
+}
+
+void Magma::Input::InputRecorder::BeginFrame(double time)
+{
+	m_frameData.clear();
+	m_frameEventCount = 0;
+	m_frameTime = time;
+}
+
+void Magma::Input::InputRecorder::Record(const InputEvent & event)
+{
+	m_frameData.push_back((unsigned char)event.type);
+	auto offset = std::round((event.time - m_frameTime) * 1000000.0);
+	this->WriteVarint(offset > 0.0 ? (uint64_t)offset : 0);
+
+	switch (event.type)
+	{
+		case InputEventType::KeyDown:
+		case InputEventType::KeyUp:
+		case InputEventType::MouseDown:
+		case InputEventType::MouseUp:
+			// Codes can be Invalid (-1), so they are zigzag encoded
+			this->WriteVarint(((uint64_t)event.code << 1) ^ (uint64_t)(int64_t)(event.code >> 31));
+			m_frameData.push_back((unsigned char)event.modifiers);
+			break;
+
+		case InputEventType::Text:
+			this->WriteVarint((uint32_t)event.code);
+			break;
+
+		case InputEventType::MouseMove:
+		case InputEventType::MouseScroll:
+			this->WriteFloat(event.x);
+			this->WriteFloat(event.y);
+			break;
+
+		default:
+			break;
+	}
+
+	++m_frameEventCount;
+}
+
+void Magma::Input::InputRecorder::EndFrame()
+{
+	if (m_frameEventCount != 0)
+	{
+		auto events = std::move(m_frameData);
+		m_frameData.clear();
+		this->WriteVarint(m_frameCount - m_lastWrittenFrame);
+		this->WriteVarint(m_frameEventCount);
+		m_log.write((const char*)m_frameData.data(), m_frameData.size());
+		m_log.write((const char*)events.data(), events.size());
+		m_frameData = std::move(events);
+		m_lastWrittenFrame = m_frameCount;
+	}
+
+	++m_frameCount;
+}
+
+void Magma::Input::InputRecorder::WriteVarint(uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		m_frameData.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	m_frameData.push_back((unsigned char)value);
+}
+
+void Magma::Input::InputRecorder::WriteFloat(float value)
+{
+	unsigned char bytes[sizeof(float)];
+	std::memcpy(bytes, &value, sizeof(float));
+	m_frameData.insert(m_frameData.end(), bytes, bytes + sizeof(float));
+}
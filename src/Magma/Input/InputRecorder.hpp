@@ -0,0 +1,82 @@
+#pragma once
+
+#include "InputSnapshot.hpp"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Magma
+{
+	namespace Input
+	{
+		/// <summary>
+		///		Magic number at the start of input log files ("MGIN")
+		/// </summary>
+		constexpr uint32_t InputLogMagic = 0x4E49474D;
+
+		/// <summary>
+		///		Input log file format version
+		/// </summary>
+		constexpr uint32_t InputLogVersion = 2;
+
+		/// <summary>
+		///		Writes the raw input events of a window into a binary log, which can be played back with an InputPlayer.
+		///		Events are grouped by the frame (PollEvents call) which received them, and timestamped relative to that frame's start,
+		///		so a replay delivers each event on the same frame regardless of how long frames take.
+		///		Frames without events take no space, and events are stored with variable length integers (a few bytes each).
+		///		The header holds the input state when the recording started (cursor position, held keys and buttons), which a replay restores
+		///		first, so the first events of a replay have the same effect as when they were recorded.
+		/// </summary>
+		class InputRecorder final
+		{
+		public:
+			/// <summary>
+			///		Creates a new input log file
+			/// </summary>
+			/// <param name="path">Log file path</param>
+			/// <param name="initialState">Input state when the recording starts (the window's last snapshot)</param>
+			InputRecorder(const std::string& path, const InputSnapshot& initialState);
+
+			/// <summary>
+			///		Writes the end of the log and closes the file
+			/// </summary>
+			~InputRecorder();
+
+			InputRecorder(const InputRecorder&) = delete;
+			InputRecorder& operator=(const InputRecorder&) = delete;
+
+			/// <summary>
+			///		Starts recording a new frame
+			/// </summary>
+			/// <param name="time">Time when the previous frame's events were polled, in seconds (event times are stored relative to it)</param>
+			void BeginFrame(double time);
+
+			/// <summary>
+			///		Records an event received during the current frame
+			/// </summary>
+			void Record(const InputEvent& event);
+
+			/// <summary>
+			///		Writes the events recorded during the current frame
+			/// </summary>
+			void EndFrame();
+
+			/// <summary>
+			///		Gets the number of frames recorded
+			/// </summary>
+			inline uint64_t GetFrameCount() const { return m_frameCount; }
+
+		private:
+			void WriteVarint(uint64_t value);
+			void WriteFloat(float value);
+
+			std::ofstream m_log;
+			std::vector<unsigned char> m_frameData;
+			size_t m_frameEventCount;
+			double m_frameTime;
+			uint64_t m_frameCount;
+			uint64_t m_lastWrittenFrame;
+		};
+	}
+}
@@ -0,0 +1,116 @@
+#include "InputSnapshot.hpp"
+
+void Magma::Input::InputSnapshot::Clear()
+{
+	frame = 0;
+	time = 0.0;
+	keysDown.reset();
+	keysPressed.reset();
+	keysReleased.reset();
+	modifiers = KeyModifiers::None;
+	buttonsDown.reset();
+	buttonsPressed.reset();
+	buttonsReleased.reset();
+	mouseX = 0.0f;
+	mouseY = 0.0f;
+	mouseDeltaX = 0.0f;
+	mouseDeltaY = 0.0f;
+	mouseHistory.clear();
+	scrollDelta = 0.0f;
+	mouseInside = false;
+	textLength = 0;
+}
+
+void Magma::Input::InputSnapshot::BeginFrame(const InputSnapshot & previous, uint64_t frame, double time)
+{
+	if (&previous != this)
+	{
+		keysDown = previous.keysDown;
+		modifiers = previous.modifiers;
+		buttonsDown = previous.buttonsDown;
+		mouseX = previous.mouseX;
+		mouseY = previous.mouseY;
+		mouseInside = previous.mouseInside;
+	}
+
+	this->frame = frame;
+	this->time = time;
+	keysPressed.reset();
+	keysReleased.reset();
+	buttonsPressed.reset();
+	buttonsReleased.reset();
+	mouseDeltaX = 0.0f;
+	mouseDeltaY = 0.0f;
+	mouseHistory.clear();
+	scrollDelta = 0.0f;
+	textLength = 0;
+}
+
+void Magma::Input::InputSnapshot::Apply(const InputEvent & event, bool keepMouseHistory)
+{
+	switch (event.type)
+	{
+		case InputEventType::KeyDown:
+			modifiers = event.modifiers;
+			if (event.code >= 0 && event.code < (int32_t)Keyboard::Count)
+			{
+				keysDown.set(event.code);
+				keysPressed.set(event.code);
+			}
+			break;
+
+		case InputEventType::KeyUp:
+			modifiers = event.modifiers;
+			if (event.code >= 0 && event.code < (int32_t)Keyboard::Count)
+			{
+				keysDown.reset(event.code);
+				keysReleased.set(event.code);
+			}
+			break;
+
+		case InputEventType::MouseDown:
+			if (event.code >= 0 && event.code < (int32_t)Mouse::Count)
+			{
+				buttonsDown.set(event.code);
+				buttonsPressed.set(event.code);
+			}
+			break;
+
+		case InputEventType::MouseUp:
+			if (event.code >= 0 && event.code < (int32_t)Mouse::Count)
+			{
+				buttonsDown.reset(event.code);
+				buttonsReleased.set(event.code);
+			}
+			break;
+
+		case InputEventType::MouseMove:
+			mouseDeltaX += event.x - mouseX;
+			mouseDeltaY += event.y - mouseY;
+			mouseX = event.x;
+			mouseY = event.y;
+			if (keepMouseHistory)
+				mouseHistory.push_back(MouseSample { event.time, event.x, event.y });
+			break;
+
+		case InputEventType::MouseScroll:
+			scrollDelta += event.y;
+			break;
+
+		case InputEventType::MouseEnter:
+			mouseInside = true;
+			break;
+
+		case InputEventType::MouseLeave:
+			mouseInside = false;
+			break;
+
+		case InputEventType::Text:
+			if (textLength < MaxTextLength)
+				text[textLength++] = (char32_t)event.code;
+			break;
+
+		default:
+			break;
+	}
+}
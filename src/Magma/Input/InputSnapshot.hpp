@@ -0,0 +1,149 @@
+#pragma once
+
+#include "InputBuffer.hpp"
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace Magma
+{
+	namespace Input
+	{
+		/// <summary>
+		///		Mouse position received during a frame
+		/// </summary>
+		struct MouseSample
+		{
+			/// <summary>
+			///		Time when the position was received, in seconds
+			/// </summary>
+			double time;
+
+			/// <summary>
+			///		Mouse position, in pixels from the window's top left corner
+			/// </summary>
+			float x, y;
+		};
+
+		/// <summary>
+		///		Immutable input state of a frame, built once per Window::PollEvents from the raw input events received since the last one.
+		///		Keys and buttons which were pressed and released during the same frame are reported as pressed and released, but not down.
+		/// </summary>
+		struct InputSnapshot
+		{
+			/// <summary>
+			///		Maximum number of text codepoints kept per frame (the rest are dropped)
+			/// </summary>
+			static constexpr size_t MaxTextLength = 32;
+
+			/// <summary>
+			///		Frame number (incremented by each PollEvents)
+			/// </summary>
+			uint64_t frame;
+
+			/// <summary>
+			///		Time when the snapshot was built, in seconds
+			/// </summary>
+			double time;
+
+			/// <summary>
+			///		Keys held down at the end of the frame
+			/// </summary>
+			std::bitset<(size_t)Keyboard::Count> keysDown;
+
+			/// <summary>
+			///		Keys pressed during the frame
+			/// </summary>
+			std::bitset<(size_t)Keyboard::Count> keysPressed;
+
+			/// <summary>
+			///		Keys released during the frame
+			/// </summary>
+			std::bitset<(size_t)Keyboard::Count> keysReleased;
+
+			/// <summary>
+			///		Key modifiers of the last key event
+			/// </summary>
+			KeyModifiers modifiers;
+
+			/// <summary>
+			///		Mouse buttons held down at the end of the frame
+			/// </summary>
+			std::bitset<(size_t)Mouse::Count> buttonsDown;
+
+			/// <summary>
+			///		Mouse buttons pressed during the frame
+			/// </summary>
+			std::bitset<(size_t)Mouse::Count> buttonsPressed;
+
+			/// <summary>
+			///		Mouse buttons released during the frame
+			/// </summary>
+			std::bitset<(size_t)Mouse::Count> buttonsReleased;
+
+			/// <summary>
+			///		Mouse position at the end of the frame, in pixels from the window's top left corner
+			/// </summary>
+			float mouseX, mouseY;
+
+			/// <summary>
+			///		Mouse movement during the frame, in pixels
+			/// </summary>
+			float mouseDeltaX, mouseDeltaY;
+
+			/// <summary>
+			///		Every mouse position received during the frame, in order (only filled if the window keeps mouse history)
+			/// </summary>
+			std::vector<MouseSample> mouseHistory;
+
+			/// <summary>
+			///		Scroll offset accumulated during the frame
+			/// </summary>
+			float scrollDelta;
+
+			/// <summary>
+			///		Is the mouse inside the window?
+			/// </summary>
+			bool mouseInside;
+
+			/// <summary>
+			///		Unicode codepoints typed during the frame
+			/// </summary>
+			char32_t text[MaxTextLength];
+
+			/// <summary>
+			///		Number of codepoints in text
+			/// </summary>
+			size_t textLength;
+
+			inline bool IsKeyDown(Keyboard key) const { return key != Keyboard::Invalid && keysDown[(size_t)key]; }
+			inline bool WasKeyPressed(Keyboard key) const { return key != Keyboard::Invalid && keysPressed[(size_t)key]; }
+			inline bool WasKeyReleased(Keyboard key) const { return key != Keyboard::Invalid && keysReleased[(size_t)key]; }
+
+			inline bool IsButtonDown(Mouse button) const { return button != Mouse::Invalid && buttonsDown[(size_t)button]; }
+			inline bool WasButtonPressed(Mouse button) const { return button != Mouse::Invalid && buttonsPressed[(size_t)button]; }
+			inline bool WasButtonReleased(Mouse button) const { return button != Mouse::Invalid && buttonsReleased[(size_t)button]; }
+
+			/// <summary>
+			///		Resets the snapshot to no input
+			/// </summary>
+			void Clear();
+
+			/// <summary>
+			///		Starts the next frame's snapshot from the previous one: held keys, buttons and the mouse position are kept, per frame state is cleared
+			/// </summary>
+			/// <param name="previous">Previous frame's snapshot (may be this snapshot)</param>
+			/// <param name="frame">Frame number</param>
+			/// <param name="time">Frame time, in seconds</param>
+			void BeginFrame(const InputSnapshot& previous, uint64_t frame, double time);
+
+			/// <summary>
+			///		Applies a raw input event received during the frame
+			/// </summary>
+			/// <param name="event">Event</param>
+			/// <param name="keepMouseHistory">Should mouse positions be added to the mouse history?</param>
+			void Apply(const InputEvent& event, bool keepMouseHistory = false);
+		};
+	}
+}
@@ -1,92 +1,137 @@
 #include "Window.hpp"
 
 #include <GLFW/glfw3.h>
+#include <array>
+#include <chrono>
 #include <sstream>
-#include <map>
+#include <utility>
 
-static std::map<GLFWwindow*, Magma::Input::Window*> glfwWindows;
+#if defined(__linux__)
+#define MAGMA_HEADLESS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+// Number of GLFW windows open (GLFW is initialized with the first one and terminated with the last one)
+static size_t glfwWindowCount = 0;
+
+// Number of headless contexts alive (they share the default EGL display, which is terminated with the last one)
+static size_t headlessContextCount = 0;
+
+static double GetInputTime()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void PushInputEvent(GLFWwindow* window, Magma::Input::InputEventType type, int32_t code = -1, Magma::Input::KeyModifiers modifiers = Magma::Input::KeyModifiers::None, float x = 0.0f, float y = 0.0f)
+{
+	Magma::Input::InputEvent event;
+	event.time = GetInputTime();
+	event.type = type;
+	event.code = code;
+	event.modifiers = modifiers;
+	event.x = x;
+	event.y = y;
+
+	// Replayed logs replace the live input, but the window can still be closed
+	auto w = (Magma::Input::Window*)glfwGetWindowUserPointer(window);
+	if (!w->IsReplayingInput() || type == Magma::Input::InputEventType::Close)
+		w->PushInputEvent(event);
+}
+
+// GLFW key codes are sparse but small (up to GLFW_KEY_LAST), so they are translated through a table built on first use
+static const std::pair<int, Magma::Input::Keyboard> GLFWKeys[] =
+{
+	{ GLFW_KEY_Q, Magma::Input::Keyboard::Q },
+	{ GLFW_KEY_W, Magma::Input::Keyboard::W },
+	{ GLFW_KEY_E, Magma::Input::Keyboard::E },
+	{ GLFW_KEY_R, Magma::Input::Keyboard::R },
+	{ GLFW_KEY_T, Magma::Input::Keyboard::T },
+	{ GLFW_KEY_Y, Magma::Input::Keyboard::Y },
+	{ GLFW_KEY_U, Magma::Input::Keyboard::U },
+	{ GLFW_KEY_I, Magma::Input::Keyboard::I },
+	{ GLFW_KEY_O, Magma::Input::Keyboard::O },
+	{ GLFW_KEY_P, Magma::Input::Keyboard::P },
+	{ GLFW_KEY_A, Magma::Input::Keyboard::A },
+	{ GLFW_KEY_S, Magma::Input::Keyboard::S },
+	{ GLFW_KEY_D, Magma::Input::Keyboard::D },
+	{ GLFW_KEY_F, Magma::Input::Keyboard::F },
+	{ GLFW_KEY_G, Magma::Input::Keyboard::G },
+	{ GLFW_KEY_H, Magma::Input::Keyboard::H },
+	{ GLFW_KEY_J, Magma::Input::Keyboard::J },
+	{ GLFW_KEY_K, Magma::Input::Keyboard::K },
+	{ GLFW_KEY_L, Magma::Input::Keyboard::L },
+	{ GLFW_KEY_Z, Magma::Input::Keyboard::Z },
+	{ GLFW_KEY_X, Magma::Input::Keyboard::X },
+	{ GLFW_KEY_C, Magma::Input::Keyboard::C },
+	{ GLFW_KEY_V, Magma::Input::Keyboard::V },
+	{ GLFW_KEY_B, Magma::Input::Keyboard::B },
+	{ GLFW_KEY_N, Magma::Input::Keyboard::N },
+	{ GLFW_KEY_M, Magma::Input::Keyboard::M },
+
+	{ GLFW_KEY_1, Magma::Input::Keyboard::Num1 },
+	{ GLFW_KEY_2, Magma::Input::Keyboard::Num2 },
+	{ GLFW_KEY_3, Magma::Input::Keyboard::Num3 },
+	{ GLFW_KEY_4, Magma::Input::Keyboard::Num4 },
+	{ GLFW_KEY_5, Magma::Input::Keyboard::Num5 },
+	{ GLFW_KEY_6, Magma::Input::Keyboard::Num6 },
+	{ GLFW_KEY_7, Magma::Input::Keyboard::Num7 },
+	{ GLFW_KEY_8, Magma::Input::Keyboard::Num8 },
+	{ GLFW_KEY_9, Magma::Input::Keyboard::Num9 },
+	{ GLFW_KEY_0, Magma::Input::Keyboard::Num0 },
+
+	{ GLFW_KEY_F1, Magma::Input::Keyboard::F1 },
+	{ GLFW_KEY_F2, Magma::Input::Keyboard::F2 },
+	{ GLFW_KEY_F3, Magma::Input::Keyboard::F3 },
+	{ GLFW_KEY_F4, Magma::Input::Keyboard::F4 },
+	{ GLFW_KEY_F5, Magma::Input::Keyboard::F5 },
+	{ GLFW_KEY_F6, Magma::Input::Keyboard::F6 },
+	{ GLFW_KEY_F7, Magma::Input::Keyboard::F7 },
+	{ GLFW_KEY_F8, Magma::Input::Keyboard::F8 },
+	{ GLFW_KEY_F9, Magma::Input::Keyboard::F9 },
+	{ GLFW_KEY_F10, Magma::Input::Keyboard::F10 },
+	{ GLFW_KEY_F11, Magma::Input::Keyboard::F11 },
+	{ GLFW_KEY_F12, Magma::Input::Keyboard::F12 },
+
+	{ GLFW_KEY_ESCAPE, Magma::Input::Keyboard::Escape },
+	{ GLFW_KEY_TAB, Magma::Input::Keyboard::Tab },
+	{ GLFW_KEY_CAPS_LOCK, Magma::Input::Keyboard::Caps },
+	{ GLFW_KEY_LEFT_SHIFT, Magma::Input::Keyboard::LShift },
+	{ GLFW_KEY_RIGHT_SHIFT, Magma::Input::Keyboard::RShift },
+	{ GLFW_KEY_LEFT_CONTROL, Magma::Input::Keyboard::LControl },
+	{ GLFW_KEY_RIGHT_CONTROL, Magma::Input::Keyboard::RControl },
+	{ GLFW_KEY_LEFT_ALT, Magma::Input::Keyboard::Alt },
+	{ GLFW_KEY_RIGHT_ALT, Magma::Input::Keyboard::AltGr },
+	{ GLFW_KEY_SPACE, Magma::Input::Keyboard::Space },
+	{ GLFW_KEY_ENTER, Magma::Input::Keyboard::Enter },
+	{ GLFW_KEY_BACKSPACE, Magma::Input::Keyboard::Backspace },
+	{ GLFW_KEY_INSERT, Magma::Input::Keyboard::Insert },
+	{ GLFW_KEY_DELETE, Magma::Input::Keyboard::Delete },
+	{ GLFW_KEY_HOME, Magma::Input::Keyboard::Home },
+	{ GLFW_KEY_END, Magma::Input::Keyboard::End },
+	{ GLFW_KEY_PAGE_UP, Magma::Input::Keyboard::PageUp },
+	{ GLFW_KEY_PAGE_DOWN, Magma::Input::Keyboard::PageDown },
+};
 
 Magma::Input::Keyboard GLFWToMagmaKey(int key)
 {
-	switch (key)
-	{
-		case GLFW_KEY_Q: return Magma::Input::Keyboard::Q;
-		case GLFW_KEY_W: return Magma::Input::Keyboard::W;
-		case GLFW_KEY_E: return Magma::Input::Keyboard::E;
-		case GLFW_KEY_R: return Magma::Input::Keyboard::R;
-		case GLFW_KEY_T: return Magma::Input::Keyboard::T;
-		case GLFW_KEY_Y: return Magma::Input::Keyboard::Y;
-		case GLFW_KEY_U: return Magma::Input::Keyboard::U;
-		case GLFW_KEY_I: return Magma::Input::Keyboard::I;
-		case GLFW_KEY_O: return Magma::Input::Keyboard::O;
-		case GLFW_KEY_P: return Magma::Input::Keyboard::P;
-		case GLFW_KEY_A: return Magma::Input::Keyboard::A;
-		case GLFW_KEY_S: return Magma::Input::Keyboard::S;
-		case GLFW_KEY_D: return Magma::Input::Keyboard::D;
-		case GLFW_KEY_F: return Magma::Input::Keyboard::F;
-		case GLFW_KEY_G: return Magma::Input::Keyboard::G;
-		case GLFW_KEY_H: return Magma::Input::Keyboard::H;
-		case GLFW_KEY_J: return Magma::Input::Keyboard::J;
-		case GLFW_KEY_K: return Magma::Input::Keyboard::K;
-		case GLFW_KEY_L: return Magma::Input::Keyboard::L;
-		case GLFW_KEY_Z: return Magma::Input::Keyboard::Z;
-		case GLFW_KEY_X: return Magma::Input::Keyboard::X;
-		case GLFW_KEY_C: return Magma::Input::Keyboard::C;
-		case GLFW_KEY_V: return Magma::Input::Keyboard::V;
-		case GLFW_KEY_B: return Magma::Input::Keyboard::B;
-		case GLFW_KEY_N: return Magma::Input::Keyboard::N;
-		case GLFW_KEY_M: return Magma::Input::Keyboard::M;
-
-		case GLFW_KEY_1: return Magma::Input::Keyboard::Num1;
-		case GLFW_KEY_2: return Magma::Input::Keyboard::Num2;
-		case GLFW_KEY_3: return Magma::Input::Keyboard::Num3;
-		case GLFW_KEY_4: return Magma::Input::Keyboard::Num4;
-		case GLFW_KEY_5: return Magma::Input::Keyboard::Num5;
-		case GLFW_KEY_6: return Magma::Input::Keyboard::Num6;
-		case GLFW_KEY_7: return Magma::Input::Keyboard::Num7;
-		case GLFW_KEY_8: return Magma::Input::Keyboard::Num8;
-		case GLFW_KEY_9: return Magma::Input::Keyboard::Num9;
-		case GLFW_KEY_0: return Magma::Input::Keyboard::Num0;
-
-		case GLFW_KEY_F1: return Magma::Input::Keyboard::F1;
-		case GLFW_KEY_F2: return Magma::Input::Keyboard::F2;
-		case GLFW_KEY_F3: return Magma::Input::Keyboard::F3;
-		case GLFW_KEY_F4: return Magma::Input::Keyboard::F4;
-		case GLFW_KEY_F5: return Magma::Input::Keyboard::F5;
-		case GLFW_KEY_F6: return Magma::Input::Keyboard::F6;
-		case GLFW_KEY_F7: return Magma::Input::Keyboard::F7;
-		case GLFW_KEY_F8: return Magma::Input::Keyboard::F8;
-		case GLFW_KEY_F9: return Magma::Input::Keyboard::F9;
-		case GLFW_KEY_F10: return Magma::Input::Keyboard::F10;
-		case GLFW_KEY_F11: return Magma::Input::Keyboard::F11;
-		case GLFW_KEY_F12: return Magma::Input::Keyboard::F12;
-
-		case GLFW_KEY_ESCAPE: return Magma::Input::Keyboard::Escape;
-		case GLFW_KEY_TAB: return Magma::Input::Keyboard::Tab;
-		case GLFW_KEY_CAPS_LOCK: return Magma::Input::Keyboard::Caps;
-		case GLFW_KEY_LEFT_SHIFT: return Magma::Input::Keyboard::LShift;
-		case GLFW_KEY_RIGHT_SHIFT: return Magma::Input::Keyboard::RShift;
-		case GLFW_KEY_LEFT_CONTROL: return Magma::Input::Keyboard::LControl;
-		case GLFW_KEY_RIGHT_CONTROL: return Magma::Input::Keyboard::RControl;
-		case GLFW_KEY_LEFT_ALT: return Magma::Input::Keyboard::Alt;
-		case GLFW_KEY_RIGHT_ALT: return Magma::Input::Keyboard::AltGr;
-		case GLFW_KEY_SPACE: return Magma::Input::Keyboard::Space;
-		case GLFW_KEY_ENTER: return Magma::Input::Keyboard::Enter;
-		case GLFW_KEY_BACKSPACE: return Magma::Input::Keyboard::Backspace;
-		case GLFW_KEY_INSERT: return Magma::Input::Keyboard::Insert;
-		case GLFW_KEY_DELETE: return Magma::Input::Keyboard::Delete;
-		case GLFW_KEY_HOME: return Magma::Input::Keyboard::Home;
-		case GLFW_KEY_END: return Magma::Input::Keyboard::End;
-		case GLFW_KEY_PAGE_UP: return Magma::Input::Keyboard::PageUp;
-		case GLFW_KEY_PAGE_DOWN: return Magma::Input::Keyboard::PageDown;
-
-		default: return Magma::Input::Keyboard::Invalid;
-	}
+	static const auto table = []()
+	{
+		std::array<Magma::Input::Keyboard, GLFW_KEY_LAST + 1> table;
+		table.fill(Magma::Input::Keyboard::Invalid);
+		for (auto& k : GLFWKeys)
+			table[k.first] = k.second;
+		return table;
+	}();
+
+	if (key < 0 || key > GLFW_KEY_LAST)
+		return Magma::Input::Keyboard::Invalid;
+	return table[key];
 }
 
 void GLFWWindowCloseCallback(GLFWwindow* window)
 {
-	glfwWindows[window]->OnClose.Fire();
+	PushInputEvent(window, Magma::Input::InputEventType::Close);
 }
 
 void GLFWErrorCallback(int err, const char* errMsg)
@@ -103,17 +148,22 @@ void GLFWKeyCallback(GLFWwindow* window, int key, int scancode, int action, int
 	switch (action)
 	{
 		case GLFW_PRESS:
-			glfwWindows[window]->OnKeyDown.Fire(k, (Magma::Input::KeyModifiers)mods);
+			PushInputEvent(window, Magma::Input::InputEventType::KeyDown, (int32_t)k, (Magma::Input::KeyModifiers)mods);
 			break;
 		case GLFW_RELEASE:
-			glfwWindows[window]->OnKeyUp.Fire(k, (Magma::Input::KeyModifiers)mods);
+			PushInputEvent(window, Magma::Input::InputEventType::KeyUp, (int32_t)k, (Magma::Input::KeyModifiers)mods);
 			break;
 	}
 }
 
+void GLFWCharCallback(GLFWwindow* window, unsigned int codepoint)
+{
+	PushInputEvent(window, Magma::Input::InputEventType::Text, (int32_t)codepoint);
+}
+
 void GLFWMousePositionCallback(GLFWwindow* window, double x, double y)
 {
-	glfwWindows[window]->OnMouseMove.Fire((int)x, (int)y);
+	PushInputEvent(window, Magma::Input::InputEventType::MouseMove, -1, Magma::Input::KeyModifiers::None, (float)x, (float)y);
 }
 
 void GLFWMouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
@@ -136,30 +186,133 @@ void GLFWMouseButtonCallback(GLFWwindow* window, int button, int action, int mod
 	switch (action)
 	{
 		case GLFW_PRESS:
-			glfwWindows[window]->OnMouseDown.Fire(mouseButton);
+			PushInputEvent(window, Magma::Input::InputEventType::MouseDown, (int32_t)mouseButton, (Magma::Input::KeyModifiers)mods);
 			break;
 		case GLFW_RELEASE:
-			glfwWindows[window]->OnMouseUp.Fire(mouseButton);
+			PushInputEvent(window, Magma::Input::InputEventType::MouseUp, (int32_t)mouseButton, (Magma::Input::KeyModifiers)mods);
 			break;
 	}
 }
 
 void GLFWMouseScroll(GLFWwindow* window, double x, double y)
 {
-	glfwWindows[window]->OnMouseScroll.Fire((int)y);
+	PushInputEvent(window, Magma::Input::InputEventType::MouseScroll, -1, Magma::Input::KeyModifiers::None, (float)x, (float)y);
 }
 
 void GLFWCursorEnterCallback(GLFWwindow* window, int enter)
 {
-	if (enter == GLFW_TRUE)
-		glfwWindows[window]->OnMouseEnter.Fire();
-	else
-		glfwWindows[window]->OnMouseLeave.Fire();
+	PushInputEvent(window, enter == GLFW_TRUE ? Magma::Input::InputEventType::MouseEnter : Magma::Input::InputEventType::MouseLeave);
+}
+
+static void CreateHeadlessContext(void*& display, void*& context)
+{
+#ifdef MAGMA_HEADLESS_EGL
+	// Prefer Mesa's surfaceless platform, which needs neither a display server nor a GPU (falls back to llvmpipe)
+	EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+	auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay != nullptr)
+		eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	if (eglDisplay == EGL_NO_DISPLAY)
+		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	if (eglDisplay == EGL_NO_DISPLAY || eglInitialize(eglDisplay, nullptr, nullptr) != EGL_TRUE)
+		throw std::runtime_error("Failed to open headless window, couldn't init EGL display");
+
+	// Terminating the display would destroy the other headless windows' contexts, so it is only done if there are none
+	auto terminate = [&]()
+	{
+		if (headlessContextCount == 0)
+			eglTerminate(eglDisplay);
+	};
+
+	if (eglBindAPI(EGL_OPENGL_API) != EGL_TRUE)
+	{
+		terminate();
+		throw std::runtime_error("Failed to open headless window, EGL doesn't support OpenGL");
+	}
+
+	const EGLint configAttribs[] =
+	{
+		EGL_SURFACE_TYPE, EGL_DONT_CARE,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (eglChooseConfig(eglDisplay, configAttribs, &config, 1, &configCount) != EGL_TRUE || configCount == 0)
+	{
+		terminate();
+		throw std::runtime_error("Failed to open headless window, no EGL config supports OpenGL");
+	}
+
+	const EGLint contextAttribs[] =
+	{
+		EGL_CONTEXT_MAJOR_VERSION, 4,
+		EGL_CONTEXT_MINOR_VERSION, 5,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+
+	EGLContext eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+	if (eglContext == EGL_NO_CONTEXT)
+	{
+		terminate();
+		throw std::runtime_error("Failed to open headless window, couldn't create an OpenGL 4.5 core EGL context");
+	}
+
+	if (eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext) != EGL_TRUE)
+	{
+		eglDestroyContext(eglDisplay, eglContext);
+		terminate();
+		throw std::runtime_error("Failed to open headless window, EGL doesn't support surfaceless contexts");
+	}
+
+	display = eglDisplay;
+	context = eglContext;
+	++headlessContextCount;
+#else
+	throw std::runtime_error("Failed to open headless window, headless windows aren't supported on this platform");
+#endif
+}
+
+static void DestroyHeadlessContext(void* display, void* context)
+{
+#ifdef MAGMA_HEADLESS_EGL
+	eglMakeCurrent((EGLDisplay)display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	eglDestroyContext((EGLDisplay)display, (EGLContext)context);
+	if (--headlessContextCount == 0)
+		eglTerminate((EGLDisplay)display);
+#endif
 }
 
-Magma::Input::Window::Window(unsigned int width, unsigned int height, const std::string& title, WindowMode mode)
+// High polling rate mice (up to 8000 Hz) fill hundreds of slots per frame, the ring must hold a few slow frames of them
+Magma::Input::Window::Window(unsigned int width, unsigned int height, const std::string& title, WindowMode mode, Window* share)
+	: m_inputBuffer(4096)
 {
-	if (glfwWindows.size() == 0)
+	m_width = width;
+	m_height = height;
+	m_mode = mode;
+	m_vsyncMode = VSyncMode::Invalid;
+	m_cursorMode = CursorMode::Normal;
+	m_rawMouseMotion = false;
+	m_mouseHistory = false;
+	m_glfwWindow = nullptr;
+	m_eglDisplay = nullptr;
+	m_eglContext = nullptr;
+	m_inputCursor = 0;
+	m_frame = 0;
+	m_lastPollTime = GetInputTime();
+	for (auto& s : m_inputSnapshots)
+		s.Clear();
+	m_inputSnapshotIndex.store(0, std::memory_order_relaxed);
+
+	if (mode == WindowMode::Headless)
+	{
+		CreateHeadlessContext(m_eglDisplay, m_eglContext);
+		return;
+	}
+
+	if (glfwWindowCount == 0)
 	{
 		glfwSetErrorCallback(GLFWErrorCallback);
 
@@ -173,50 +326,236 @@ Magma::Input::Window::Window(unsigned int width, unsigned int height, const std:
 	}
 
 	GLFWwindow* win;
+	auto shareWindow = share != nullptr ? (GLFWwindow*)share->m_glfwWindow : NULL;
 
 	glfwWindowHint(GLFW_RESIZABLE, 0);
 
 	switch (mode)
 	{
 		case WindowMode::Windowed:
-			win = glfwCreateWindow(width, height, title.c_str(), NULL, NULL);
+			win = glfwCreateWindow(width, height, title.c_str(), NULL, shareWindow);
 			break;
 
 		case WindowMode::Fullscreen:
-			win = glfwCreateWindow(width, height, title.c_str(), glfwGetPrimaryMonitor(), NULL);
+			win = glfwCreateWindow(width, height, title.c_str(), glfwGetPrimaryMonitor(), shareWindow);
 			break;
+
+		default:
+			throw std::runtime_error("Failed to open window, invalid window mode");
 	}
 
 	if (win == nullptr)
+	{
+		if (glfwWindowCount == 0)
+			glfwTerminate();
 		throw std::runtime_error("Failed to open window, window is NULL");
+	}
 
 	glfwMakeContextCurrent(win);
+	glfwSetWindowUserPointer(win, this);
 
 	glfwSetKeyCallback(win, GLFWKeyCallback);
+	glfwSetCharCallback(win, GLFWCharCallback);
 	glfwSetCursorPosCallback(win, GLFWMousePositionCallback);
+	glfwSetMouseButtonCallback(win, GLFWMouseButtonCallback);
 	glfwSetWindowCloseCallback(win, GLFWWindowCloseCallback);
 	glfwSetScrollCallback(win, GLFWMouseScroll);
 	glfwSetCursorEnterCallback(win, GLFWCursorEnterCallback);
 	
 	m_glfwWindow = win;
-	glfwWindows[win] = this;
+	++glfwWindowCount;
+
+	// Start from the current cursor position, so the first move doesn't report a jump from the origin
+	double mouseX, mouseY;
+	glfwGetCursorPos(win, &mouseX, &mouseY);
+	m_inputSnapshots[0].mouseX = (float)mouseX;
+	m_inputSnapshots[0].mouseY = (float)mouseY;
 }
 
 Magma::Input::Window::~Window()
 {
-	glfwWindows.erase((GLFWwindow*)m_glfwWindow);
+	if (m_mode == WindowMode::Headless)
+	{
+		DestroyHeadlessContext(m_eglDisplay, m_eglContext);
+		return;
+	}
+
 	glfwDestroyWindow((GLFWwindow*)m_glfwWindow);
 
-	if (glfwWindows.size() == 0)
+	if (--glfwWindowCount == 0)
 		glfwTerminate();
 }
 
 void Magma::Input::Window::PollEvents()
 {
-	glfwPollEvents();
+	if (m_mode != WindowMode::Headless)
+		glfwPollEvents();
+	this->ProcessEvents();
+}
+
+void Magma::Input::Window::ProcessEvents()
+{
+	if (m_inputPlayer != nullptr)
+		m_inputPlayer->PlayFrame(m_inputBuffer, m_lastPollTime);
+	if (m_inputRecorder != nullptr)
+		m_inputRecorder->BeginFrame(m_lastPollTime);
+
+	// The callbacks only write raw events, the snapshot is built and the listeners are called from them here
+	auto time = GetInputTime();
+	auto previousIndex = m_inputSnapshotIndex.load(std::memory_order_relaxed);
+	auto index = (previousIndex + 1) % 3;
+	auto& snapshot = m_inputSnapshots[index];
+	snapshot.BeginFrame(m_inputSnapshots[previousIndex], ++m_frame, time);
+
+	InputEvent events[64];
+	size_t count;
+	bool mouseMoved = false;
+	while ((count = m_inputBuffer.Read(m_inputCursor, events, 64)) != 0)
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto& e = events[i];
+			snapshot.Apply(e, m_mouseHistory);
+			if (m_inputRecorder != nullptr)
+				m_inputRecorder->Record(e);
+
+			switch (e.type)
+			{
+				case InputEventType::KeyDown: OnKeyDown.Fire((Keyboard)e.code, e.modifiers); break;
+				case InputEventType::KeyUp: OnKeyUp.Fire((Keyboard)e.code, e.modifiers); break;
+				case InputEventType::MouseDown: OnMouseDown.Fire((Mouse)e.code); break;
+				case InputEventType::MouseUp: OnMouseUp.Fire((Mouse)e.code); break;
+				case InputEventType::MouseMove: mouseMoved = true; break;
+				case InputEventType::MouseScroll: OnMouseScroll.Fire(e.y); break;
+				case InputEventType::MouseEnter: OnMouseEnter.Fire(); break;
+				case InputEventType::MouseLeave: OnMouseLeave.Fire(); break;
+				case InputEventType::Close: OnClose.Fire(); break;
+				default: break;
+			}
+		}
+
+	// High polling rate mice send hundreds of positions per frame, listeners only get the result
+	if (mouseMoved)
+	{
+		OnMouseMove.Fire(snapshot.mouseX, snapshot.mouseY);
+		OnMouseDelta.Fire(snapshot.mouseDeltaX, snapshot.mouseDeltaY);
+	}
+
+	if (m_inputRecorder != nullptr)
+		m_inputRecorder->EndFrame();
+	m_lastPollTime = time;
+	m_inputSnapshotIndex.store(index, std::memory_order_release);
+}
+
+void Magma::Input::Window::StartInputRecording(const std::string & path)
+{
+	m_inputRecorder.reset();
+	m_inputRecorder.reset(new InputRecorder(path, m_inputSnapshots[m_inputSnapshotIndex.load(std::memory_order_relaxed)]));
+}
+
+void Magma::Input::Window::StopInputRecording()
+{
+	m_inputRecorder.reset();
+}
+
+void Magma::Input::Window::StartInputReplay(const std::string & path)
+{
+	m_inputPlayer.reset(new InputPlayer(path));
+
+	// Live events received before the replay started are dropped
+	m_inputCursor = m_inputBuffer.GetWriteCursor();
+
+	// The replay starts from the recorded state instead of the live one, published like a frame so readers never see it half written
+	auto index = (m_inputSnapshotIndex.load(std::memory_order_relaxed) + 1) % 3;
+	auto& snapshot = m_inputSnapshots[index];
+	snapshot = m_inputPlayer->GetInitialState();
+	snapshot.frame = m_frame;
+	snapshot.time = m_lastPollTime;
+	m_inputSnapshotIndex.store(index, std::memory_order_release);
+}
+
+void Magma::Input::Window::StopInputReplay()
+{
+	m_inputPlayer.reset();
+}
+
+void Magma::Input::Window::MakeCurrent()
+{
+	if (m_mode == WindowMode::Headless)
+	{
+#ifdef MAGMA_HEADLESS_EGL
+		eglMakeCurrent((EGLDisplay)m_eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, (EGLContext)m_eglContext);
+#endif
+		return;
+	}
+	glfwMakeContextCurrent((GLFWwindow*)m_glfwWindow);
 }
 
 void Magma::Input::Window::SwapBuffers()
 {
-	glfwSwapBuffers((GLFWwindow*)m_glfwWindow);
+	m_framePacer.Wait();
+	if (m_mode != WindowMode::Headless)
+		glfwSwapBuffers((GLFWwindow*)m_glfwWindow);
+	m_framePacer.Present();
+}
+
+void Magma::Input::Window::SetCursorMode(CursorMode mode)
+{
+	if (mode == CursorMode::Invalid || mode == CursorMode::Count)
+		throw std::runtime_error("Failed to set window cursor mode, invalid cursor mode");
+
+	if (mode != CursorMode::Disabled)
+		this->SetRawMouseMotion(false);
+	m_cursorMode = mode;
+	if (m_mode == WindowMode::Headless)
+		return;
+
+	switch (mode)
+	{
+		case CursorMode::Normal: glfwSetInputMode((GLFWwindow*)m_glfwWindow, GLFW_CURSOR, GLFW_CURSOR_NORMAL); break;
+		case CursorMode::Hidden: glfwSetInputMode((GLFWwindow*)m_glfwWindow, GLFW_CURSOR, GLFW_CURSOR_HIDDEN); break;
+		case CursorMode::Disabled: glfwSetInputMode((GLFWwindow*)m_glfwWindow, GLFW_CURSOR, GLFW_CURSOR_DISABLED); break;
+		default: break;
+	}
+}
+
+bool Magma::Input::Window::SetRawMouseMotion(bool enabled)
+{
+	if (enabled && (m_mode == WindowMode::Headless || m_cursorMode != CursorMode::Disabled || glfwRawMouseMotionSupported() != GLFW_TRUE))
+		enabled = false;
+
+	if (m_mode != WindowMode::Headless && enabled != m_rawMouseMotion)
+		glfwSetInputMode((GLFWwindow*)m_glfwWindow, GLFW_RAW_MOUSE_MOTION, enabled ? GLFW_TRUE : GLFW_FALSE);
+	m_rawMouseMotion = enabled;
+	return enabled;
+}
+
+void Magma::Input::Window::SetVSync(VSyncMode mode, int interval)
+{
+	if (mode == VSyncMode::Invalid || mode == VSyncMode::Count)
+		throw std::runtime_error("Failed to set window vsync, invalid vsync mode");
+	if (mode != VSyncMode::Off && interval < 1)
+		throw std::runtime_error("Failed to set window vsync, swap interval must be at least 1");
+
+	// Headless windows have no surface to present, so there is nothing to synchronize
+	if (m_mode == WindowMode::Headless)
+	{
+		m_vsyncMode = mode;
+		return;
+	}
+
+	// Extensions and the swap interval apply to the current context, so this window's must be current before querying them
+	this->MakeCurrent();
+
+	// Negative intervals enable adaptive vsync, if the driver supports tearing on late frames
+	if (mode == VSyncMode::Adaptive && glfwExtensionSupported("WGL_EXT_swap_control_tear") != GLFW_TRUE && glfwExtensionSupported("GLX_EXT_swap_control_tear") != GLFW_TRUE)
+		mode = VSyncMode::On;
+
+	switch (mode)
+	{
+		case VSyncMode::Off: glfwSwapInterval(0); break;
+		case VSyncMode::On: glfwSwapInterval(interval); break;
+		case VSyncMode::Adaptive: glfwSwapInterval(-interval); break;
+		default: break;
+	}
+	m_vsyncMode = mode;
 }
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
 
 #include "Event.hpp"
+#include "FramePacer.hpp"
+#include "InputBuffer.hpp"
+#include "InputPlayer.hpp"
+#include "InputRecorder.hpp"
+#include "InputSnapshot.hpp"
 #include "Keyboard.hpp"
 #include "Mouse.hpp"
 
@@ -16,23 +23,221 @@ namespace Magma
 
 			Windowed,
 			Fullscreen,
+			Headless,
 
 			Count,
 		};
 
+		/// <summary>
+		///		Vertical synchronization modes
+		/// </summary>
+		enum class VSyncMode
+		{
+			Invalid = -1,
+
+			/// <summary>
+			///		Frames are presented immediately (lowest latency, may tear)
+			/// </summary>
+			Off,
+
+			/// <summary>
+			///		Frames are presented on vertical blanks
+			/// </summary>
+			On,
+
+			/// <summary>
+			///		Frames are presented on vertical blanks, unless they missed one, then they're presented immediately (falls back to On if unsupported)
+			/// </summary>
+			Adaptive,
+
+			Count
+		};
+
+		/// <summary>
+		///		Mouse cursor modes
+		/// </summary>
+		enum class CursorMode
+		{
+			Invalid = -1,
+
+			/// <summary>
+			///		Visible cursor, moving freely
+			/// </summary>
+			Normal,
+
+			/// <summary>
+			///		Cursor hidden while over the window
+			/// </summary>
+			Hidden,
+
+			/// <summary>
+			///		Cursor hidden and locked to the window, with unbounded virtual positions (for camera controls)
+			/// </summary>
+			Disabled,
+
+			Count
+		};
+
 		class Window
 		{
 		public:
-			Window(unsigned int width, unsigned int height, const std::string& title, WindowMode mode = WindowMode::Windowed);
+			/// <summary>
+			///		Opens a new window and makes its rendering context current
+			/// </summary>
+			/// <param name="width">Window width</param>
+			/// <param name="height">Window height</param>
+			/// <param name="title">Window title</param>
+			/// <param name="mode">Window mode</param>
+			/// <param name="share">Window whose rendering context shares its objects with the new window's (ignored for headless windows)</param>
+			Window(unsigned int width, unsigned int height, const std::string& title, WindowMode mode = WindowMode::Windowed, Window* share = nullptr);
 			virtual ~Window();
 
+			Window(const Window&) = delete;
+			Window& operator=(const Window&) = delete;
+
+			/// <summary>
+			///		Polls the window's input, builds the frame's input snapshot and fires the input events
+			/// </summary>
 			void PollEvents();
+
+			/// <summary>
+			///		Builds the frame's input snapshot and fires the input events from the events already received (PollEvents without polling,
+			///		used when the events of several windows are polled at once)
+			/// </summary>
+			void ProcessEvents();
+
+			/// <summary>
+			///		Makes this window's rendering context current on the calling thread
+			/// </summary>
+			void MakeCurrent();
+
+			/// <summary>
+			///		Waits for the frame limiter, presents the frame and records its present time
+			/// </summary>
 			void SwapBuffers();
 
+			/// <summary>
+			///		Sets the window's vertical synchronization (makes the window's rendering context current)
+			/// </summary>
+			/// <param name="mode">Synchronization mode</param>
+			/// <param name="interval">Number of vertical blanks between presents (ignored when off)</param>
+			void SetVSync(VSyncMode mode, int interval = 1);
+
+			/// <summary>
+			///		Gets the vertical synchronization mode in use (On if Adaptive was requested but isn't supported, Invalid if it was never set and the driver's default is used)
+			/// </summary>
+			inline VSyncMode GetVSync() const { return m_vsyncMode; }
+
+			/// <summary>
+			///		Gets the frame pacer used by SwapBuffers (frame rate limit and present-to-present timings)
+			/// </summary>
+			inline FramePacer& GetFramePacer() { return m_framePacer; }
+			inline const FramePacer& GetFramePacer() const { return m_framePacer; }
+
+			/// <summary>
+			///		Sets the mouse cursor mode (raw mouse motion is disabled when the cursor isn't disabled)
+			/// </summary>
+			void SetCursorMode(CursorMode mode);
+
+			/// <summary>
+			///		Gets the mouse cursor mode
+			/// </summary>
+			inline CursorMode GetCursorMode() const { return m_cursorMode; }
+
+			/// <summary>
+			///		Enables or disables raw (unaccelerated, unscaled) mouse motion, only available while the cursor is disabled
+			/// </summary>
+			/// <returns>True if raw mouse motion is enabled</returns>
+			bool SetRawMouseMotion(bool enabled);
+
+			/// <summary>
+			///		Is raw mouse motion enabled?
+			/// </summary>
+			inline bool IsRawMouseMotion() const { return m_rawMouseMotion; }
+
+			/// <summary>
+			///		Sets whether every mouse position received is kept in the input snapshot's mouse history, or only the accumulated motion
+			/// </summary>
+			inline void SetMouseHistory(bool keep) { m_mouseHistory = keep; }
+
+			/// <summary>
+			///		Are the mouse positions received kept in the input snapshot's mouse history?
+			/// </summary>
+			inline bool HasMouseHistory() const { return m_mouseHistory; }
+
+			inline unsigned int GetWidth() const { return m_width; }
+			inline unsigned int GetHeight() const { return m_height; }
+
+			/// <summary>
+			///		Is this window headless (has an offscreen rendering context but no visible surface nor input)?
+			///		Headless windows have no default framebuffer, so rendering must go to offscreen render targets.
+			/// </summary>
+			inline bool IsHeadless() const { return m_mode == WindowMode::Headless; }
+
+			/// <summary>
+			///		Gets the input snapshot built by the last PollEvents (can be called from any thread).
+			///		The snapshot is never modified, and stays valid until PollEvents is called twice more.
+			/// </summary>
+			inline const InputSnapshot& GetInputSnapshot() const { return m_inputSnapshots[m_inputSnapshotIndex.load(std::memory_order_acquire)]; }
+
+			/// <summary>
+			///		Gets the buffer where the raw input events are written (events can be read from it on any thread)
+			/// </summary>
+			inline const InputBuffer& GetInputBuffer() const { return m_inputBuffer; }
+
+			/// <summary>
+			///		Writes a raw input event (called by the window's callbacks, must only be called from the thread which polls the window)
+			/// </summary>
+			inline void PushInputEvent(const InputEvent& event) { m_inputBuffer.Push(event); }
+
+			/// <summary>
+			///		Starts writing the input events received by each PollEvents into a log file (stops any recording in progress)
+			/// </summary>
+			/// <param name="path">Log file path</param>
+			void StartInputRecording(const std::string& path);
+
+			/// <summary>
+			///		Stops the recording in progress, if any
+			/// </summary>
+			void StopInputRecording();
+
+			/// <summary>
+			///		Starts playing an input log in place of the window's input, one recorded frame per PollEvents.
+			///		Live input is ignored while replaying, except close requests.
+			/// </summary>
+			/// <param name="path">Log file path</param>
+			void StartInputReplay(const std::string& path);
+
+			/// <summary>
+			///		Stops the replay in progress, if any, and goes back to live input
+			/// </summary>
+			void StopInputReplay();
+
+			/// <summary>
+			///		Is an input log being replayed (even if every frame was already played)?
+			/// </summary>
+			inline bool IsReplayingInput() const { return m_inputPlayer != nullptr; }
+
+			/// <summary>
+			///		Have all the frames of the input log being replayed been played?
+			/// </summary>
+			inline bool IsInputReplayFinished() const { return m_inputPlayer != nullptr && m_inputPlayer->IsFinished(); }
+
 			Event<> OnClose;
 			Event<> OnMouseEnter;
 			Event<> OnMouseLeave;
+
+			/// <summary>
+			///		Fired at most once per frame, with the last mouse position received (mouse motion is coalesced, see the input snapshot's
+			///		mouse history for every position)
+			/// </summary>
 			Event<float, float> OnMouseMove;
+
+			/// <summary>
+			///		Fired at most once per frame, with the mouse motion accumulated during the frame
+			/// </summary>
+			Event<float, float> OnMouseDelta;
+
 			Event<float> OnMouseScroll; 
 			Event<Keyboard, KeyModifiers> OnKeyUp;
 			Event<Keyboard, KeyModifiers> OnKeyDown;
@@ -41,6 +246,27 @@ namespace Magma
 
 		private:
 			void* m_glfwWindow;
+			void* m_eglDisplay;
+			void* m_eglContext;
+			unsigned int m_width;
+			unsigned int m_height;
+			WindowMode m_mode;
+			VSyncMode m_vsyncMode;
+			CursorMode m_cursorMode;
+			bool m_rawMouseMotion;
+			bool m_mouseHistory;
+			FramePacer m_framePacer;
+
+			InputBuffer m_inputBuffer;
+			uint64_t m_inputCursor;
+			uint64_t m_frame;
+			double m_lastPollTime;
+			std::unique_ptr<InputRecorder> m_inputRecorder;
+			std::unique_ptr<InputPlayer> m_inputPlayer;
+
+			// Triple buffered, so the snapshot being built is never the last nor the previous published one
+			InputSnapshot m_inputSnapshots[3];
+			std::atomic<size_t> m_inputSnapshotIndex;
 		};
 	}
 }
\ No newline at end of file
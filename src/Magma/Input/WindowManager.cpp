@@ -0,0 +1,46 @@
+#include "WindowManager.hpp"
+
+#include <GLFW/glfw3.h>
+#include <stdexcept>
+
+Magma::Input::Window & Magma::Input::WindowManager::OpenWindow(unsigned int width, unsigned int height, const std::string & title, WindowMode mode)
+{
+	Window* share = nullptr;
+	for (auto& w : m_windows)
+		if (!w->IsHeadless())
+		{
+			share = w.get();
+			break;
+		}
+
+	// The window is owned before the vector grows, so it isn't leaked if the vector fails to reallocate
+	std::unique_ptr<Window> window(new Window(width, height, title, mode, share));
+	m_windows.push_back(std::move(window));
+	return *m_windows.back();
+}
+
+void Magma::Input::WindowManager::CloseWindow(Window & window)
+{
+	for (auto it = m_windows.begin(); it != m_windows.end(); ++it)
+		if (it->get() == &window)
+		{
+			m_windows.erase(it);
+			return;
+		}
+
+	throw std::runtime_error("Failed to close window on WindowManager: window wasn't created by this manager");
+}
+
+void Magma::Input::WindowManager::PollEvents()
+{
+	// A single poll dispatches the events of every GLFW window into their input buffers
+	for (auto& w : m_windows)
+		if (!w->IsHeadless())
+		{
+			glfwPollEvents();
+			break;
+		}
+
+	for (auto& w : m_windows)
+		w->ProcessEvents();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Window.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace Magma
+{
+	namespace Input
+	{
+		/// <summary>
+		///		Owns several windows, polls their events at once and keeps their rendering contexts sharing objects.
+		///		Windows must be created, polled and destroyed on the main thread (GLFW's requirement).
+		/// </summary>
+		class WindowManager final
+		{
+		public:
+			WindowManager() = default;
+			~WindowManager() = default;
+
+			WindowManager(const WindowManager&) = delete;
+			WindowManager& operator=(const WindowManager&) = delete;
+
+			/// <summary>
+			///		Opens a new window, sharing rendering context objects with the first visible window open
+			/// </summary>
+			/// <param name="width">Window width</param>
+			/// <param name="height">Window height</param>
+			/// <param name="title">Window title</param>
+			/// <param name="mode">Window mode</param>
+			/// <returns>Window (valid until it is closed through the manager)</returns>
+			Window& OpenWindow(unsigned int width, unsigned int height, const std::string& title, WindowMode mode = WindowMode::Windowed);
+
+			/// <summary>
+			///		Closes a window created by this manager
+			/// </summary>
+			void CloseWindow(Window& window);
+
+			/// <summary>
+			///		Polls the events of every window, then builds each window's input snapshot and fires its input events
+			/// </summary>
+			void PollEvents();
+
+			/// <summary>
+			///		Gets the number of windows open
+			/// </summary>
+			inline size_t GetWindowCount() const { return m_windows.size(); }
+
+			/// <summary>
+			///		Gets a window, in creation order
+			/// </summary>
+			inline Window& GetWindow(size_t index) { return *m_windows[index]; }
+
+		private:
+			std::vector<std::unique_ptr<Window>> m_windows;
+		};
+	}
+}
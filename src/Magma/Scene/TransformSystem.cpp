@@ -0,0 +1,400 @@
+#include "TransformSystem.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MAGMA_TRANSFORM_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MAGMA_TRANSFORM_SSE
+#endif
+
+static constexpr size_t InvalidIndex = SIZE_MAX;
+static const float Identity[12] = { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f };
+
+// Batch operations, so the same composition code runs on SIMD batches and on single transforms (for the end of each range)
+struct ScalarBatch
+{
+	using Type = float;
+	static constexpr size_t Width = 1;
+	static inline float Load(const float* p) { return *p; }
+	static inline void Store(float* p, float v) { *p = v; }
+	static inline float Set(float v) { return v; }
+	static inline float Add(float a, float b) { return a + b; }
+	static inline float Sub(float a, float b) { return a - b; }
+	static inline float Mul(float a, float b) { return a * b; }
+};
+
+#if defined(MAGMA_TRANSFORM_AVX)
+struct AVXBatch
+{
+	using Type = __m256;
+	static constexpr size_t Width = 8;
+	static inline __m256 Load(const float* p) { return _mm256_loadu_ps(p); }
+	static inline void Store(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+	static inline __m256 Set(float v) { return _mm256_set1_ps(v); }
+	static inline __m256 Add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+	static inline __m256 Sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+	static inline __m256 Mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+};
+
+using Batch = AVXBatch;
+#elif defined(MAGMA_TRANSFORM_SSE)
+struct SSEBatch
+{
+	using Type = __m128;
+	static constexpr size_t Width = 4;
+	static inline __m128 Load(const float* p) { return _mm_loadu_ps(p); }
+	static inline void Store(float* p, __m128 v) { _mm_storeu_ps(p, v); }
+	static inline __m128 Set(float v) { return _mm_set1_ps(v); }
+	static inline __m128 Add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+	static inline __m128 Sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+	static inline __m128 Mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+};
+
+using Batch = SSEBatch;
+#else
+using Batch = ScalarBatch;
+#endif
+
+template <typename T>
+static void Permute(std::vector<T>& values, const std::vector<size_t>& order)
+{
+	std::vector<T> permuted(order.size());
+	for (size_t i = 0; i < order.size(); ++i)
+		permuted[i] = values[order[i]];
+	values.swap(permuted);
+}
+
+Magma::Scene::TransformSystem::TransformSystem()
+{
+	// ID 0 means no transform
+	m_indices.push_back(InvalidIndex);
+	m_structureDirty = false;
+	m_levelOffsets.push_back(0);
+}
+
+int Magma::Scene::TransformSystem::Create(int parent)
+{
+	auto parentIndex = parent != 0 ? (int32_t)this->GetIndex(parent) : -1;
+
+	int id;
+	if (!m_freeIDs.empty())
+	{
+		id = m_freeIDs.back();
+		m_freeIDs.pop_back();
+	}
+	else
+	{
+		id = (int)m_indices.size();
+		m_indices.push_back(InvalidIndex);
+	}
+
+	// New transforms are appended and moved to their level on the next update
+	m_indices[id] = m_ids.size();
+	m_ids.push_back(id);
+	m_parents.push_back(parentIndex);
+	m_dirty.push_back(1);
+	m_destroyed.push_back(0);
+	m_positionX.push_back(0.0f);
+	m_positionY.push_back(0.0f);
+	m_positionZ.push_back(0.0f);
+	m_rotationX.push_back(0.0f);
+	m_rotationY.push_back(0.0f);
+	m_rotationZ.push_back(0.0f);
+	m_rotationW.push_back(1.0f);
+	m_scaleX.push_back(1.0f);
+	m_scaleY.push_back(1.0f);
+	m_scaleZ.push_back(1.0f);
+	for (size_t k = 0; k < 12; ++k)
+		m_world[k].push_back(Identity[k]);
+
+	m_structureDirty = true;
+	return id;
+}
+
+void Magma::Scene::TransformSystem::Destroy(int transform)
+{
+	// Descendants and IDs are released on the next update, when the hierarchy is rebuilt
+	m_destroyed[this->GetIndex(transform)] = 1;
+	m_structureDirty = true;
+}
+
+void Magma::Scene::TransformSystem::SetParent(int transform, int parent)
+{
+	auto index = this->GetIndex(transform);
+	auto parentIndex = parent != 0 ? (int32_t)this->GetIndex(parent) : -1;
+
+	for (auto i = parentIndex; i >= 0; i = m_parents[i])
+		if ((size_t)i == index)
+			throw std::runtime_error("Failed to set parent on TransformSystem: a transform can't be parented to itself or to one of its descendants");
+
+	m_parents[index] = parentIndex;
+	m_dirty[index] = 1;
+	m_structureDirty = true;
+}
+
+int Magma::Scene::TransformSystem::GetParent(int transform) const
+{
+	auto parentIndex = m_parents[this->GetIndex(transform)];
+	return parentIndex >= 0 ? m_ids[parentIndex] : 0;
+}
+
+void Magma::Scene::TransformSystem::SetLocalPosition(int transform, const glm::vec3 & position)
+{
+	auto index = this->GetIndex(transform);
+	m_positionX[index] = position.x;
+	m_positionY[index] = position.y;
+	m_positionZ[index] = position.z;
+	m_dirty[index] = 1;
+}
+
+void Magma::Scene::TransformSystem::SetLocalRotation(int transform, const glm::quat & rotation)
+{
+	auto index = this->GetIndex(transform);
+	m_rotationX[index] = rotation.x;
+	m_rotationY[index] = rotation.y;
+	m_rotationZ[index] = rotation.z;
+	m_rotationW[index] = rotation.w;
+	m_dirty[index] = 1;
+}
+
+void Magma::Scene::TransformSystem::SetLocalScale(int transform, const glm::vec3 & scale)
+{
+	auto index = this->GetIndex(transform);
+	m_scaleX[index] = scale.x;
+	m_scaleY[index] = scale.y;
+	m_scaleZ[index] = scale.z;
+	m_dirty[index] = 1;
+}
+
+glm::vec3 Magma::Scene::TransformSystem::GetLocalPosition(int transform) const
+{
+	auto index = this->GetIndex(transform);
+	return glm::vec3(m_positionX[index], m_positionY[index], m_positionZ[index]);
+}
+
+glm::quat Magma::Scene::TransformSystem::GetLocalRotation(int transform) const
+{
+	auto index = this->GetIndex(transform);
+	return glm::quat(m_rotationW[index], m_rotationX[index], m_rotationY[index], m_rotationZ[index]);
+}
+
+glm::vec3 Magma::Scene::TransformSystem::GetLocalScale(int transform) const
+{
+	auto index = this->GetIndex(transform);
+	return glm::vec3(m_scaleX[index], m_scaleY[index], m_scaleZ[index]);
+}
+
+glm::mat4 Magma::Scene::TransformSystem::GetWorldMatrix(int transform) const
+{
+	auto index = this->GetIndex(transform);
+	glm::mat4 matrix(1.0f);
+	for (int column = 0; column < 4; ++column)
+		for (int row = 0; row < 3; ++row)
+			matrix[column][row] = m_world[column * 3 + row][index];
+	return matrix;
+}
+
+glm::vec3 Magma::Scene::TransformSystem::GetWorldPosition(int transform) const
+{
+	auto index = this->GetIndex(transform);
+	return glm::vec3(m_world[9][index], m_world[10][index], m_world[11][index]);
+}
+
+void Magma::Scene::TransformSystem::Update()
+{
+	this->BeginUpdate();
+	for (size_t level = 0; level < this->GetLevelCount(); ++level)
+		this->UpdateLevel(level, 0, this->GetLevelSize(level));
+	this->EndUpdate();
+}
+
+void Magma::Scene::TransformSystem::BeginUpdate()
+{
+	if (m_structureDirty)
+		this->Rebuild();
+}
+
+void Magma::Scene::TransformSystem::UpdateLevel(size_t level, size_t first, size_t count)
+{
+	if (m_structureDirty)
+		throw std::runtime_error("Failed to update level on TransformSystem: the hierarchy changed since BeginUpdate was called");
+	if (level >= this->GetLevelCount() || first + count > this->GetLevelSize(level))
+		throw std::runtime_error("Failed to update level on TransformSystem: range out of bounds");
+
+	auto i = m_levelOffsets[level] + first;
+	auto end = i + count;
+	for (; i + Batch::Width <= end; i += Batch::Width)
+		this->ComposeBatch<Batch>(i);
+	for (; i < end; ++i)
+		this->ComposeBatch<ScalarBatch>(i);
+}
+
+void Magma::Scene::TransformSystem::EndUpdate()
+{
+	std::fill(m_dirty.begin(), m_dirty.end(), (uint8_t)0);
+}
+
+size_t Magma::Scene::TransformSystem::GetIndex(int transform) const
+{
+	if (transform <= 0 || (size_t)transform >= m_indices.size() || m_indices[transform] == InvalidIndex || m_destroyed[m_indices[transform]] != 0)
+		throw std::runtime_error("Failed to get transform on TransformSystem: invalid transform ID");
+	return m_indices[transform];
+}
+
+void Magma::Scene::TransformSystem::Rebuild()
+{
+	auto count = m_ids.size();
+
+	// Children of each transform
+	std::vector<size_t> childOffsets(count + 1, 0);
+	for (size_t i = 0; i < count; ++i)
+		if (m_parents[i] >= 0)
+			++childOffsets[m_parents[i] + 1];
+	for (size_t i = 0; i < count; ++i)
+		childOffsets[i + 1] += childOffsets[i];
+	std::vector<size_t> children(childOffsets[count]);
+	std::vector<size_t> fill(childOffsets.begin(), childOffsets.end() - 1);
+	for (size_t i = 0; i < count; ++i)
+		if (m_parents[i] >= 0)
+			children[fill[m_parents[i]]++] = i;
+
+	// Breadth first order, skipping destroyed transforms (and so their descendants)
+	std::vector<size_t> order;
+	order.reserve(count);
+	m_levelOffsets.clear();
+	m_levelOffsets.push_back(0);
+	for (size_t i = 0; i < count; ++i)
+		if (m_parents[i] < 0 && m_destroyed[i] == 0)
+			order.push_back(i);
+
+	for (size_t levelStart = 0; levelStart < order.size();)
+	{
+		auto levelEnd = order.size();
+		m_levelOffsets.push_back(levelEnd);
+		for (auto i = levelStart; i < levelEnd; ++i)
+			for (auto c = childOffsets[order[i]]; c < childOffsets[order[i] + 1]; ++c)
+				if (m_destroyed[children[c]] == 0)
+					order.push_back(children[c]);
+		levelStart = levelEnd;
+	}
+
+	// Release the IDs of the transforms which weren't reached
+	std::vector<size_t> newIndices(count, InvalidIndex);
+	for (size_t i = 0; i < order.size(); ++i)
+		newIndices[order[i]] = i;
+	for (size_t i = 0; i < count; ++i)
+		if (newIndices[i] == InvalidIndex)
+		{
+			m_indices[m_ids[i]] = InvalidIndex;
+			m_freeIDs.push_back(m_ids[i]);
+		}
+
+	Permute(m_ids, order);
+	Permute(m_parents, order);
+	Permute(m_dirty, order);
+	Permute(m_destroyed, order);
+	Permute(m_positionX, order);
+	Permute(m_positionY, order);
+	Permute(m_positionZ, order);
+	Permute(m_rotationX, order);
+	Permute(m_rotationY, order);
+	Permute(m_rotationZ, order);
+	Permute(m_rotationW, order);
+	Permute(m_scaleX, order);
+	Permute(m_scaleY, order);
+	Permute(m_scaleZ, order);
+	for (auto& w : m_world)
+		Permute(w, order);
+
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		m_indices[m_ids[i]] = i;
+		if (m_parents[i] >= 0)
+			m_parents[i] = (int32_t)newIndices[m_parents[i]];
+	}
+
+	m_structureDirty = false;
+}
+
+template <typename TBatch>
+void Magma::Scene::TransformSystem::ComposeBatch(size_t i)
+{
+	using Ops = TBatch;
+	using Type = typename TBatch::Type;
+	constexpr size_t Width = Ops::Width;
+
+	// A transform is recomputed if it or its parent changed (parents were updated on the previous level, so their flags are final)
+	bool dirty = false;
+	for (size_t j = 0; j < Width; ++j)
+	{
+		auto p = m_parents[i + j];
+		if (p >= 0 && m_dirty[p] != 0)
+			m_dirty[i + j] = 1;
+		dirty |= m_dirty[i + j] != 0;
+	}
+	if (!dirty)
+		return;
+
+	// Siblings are stored together, so batches often share a single parent which can just be broadcast,
+	// otherwise the parents' world matrices are gathered into batch layout
+	Type p[12];
+	auto firstParent = m_parents[i];
+	bool sameParent = true;
+	for (size_t j = 1; j < Width; ++j)
+		sameParent &= m_parents[i + j] == firstParent;
+
+	if (sameParent)
+	{
+		for (size_t k = 0; k < 12; ++k)
+			p[k] = Ops::Set(firstParent >= 0 ? m_world[k][firstParent] : Identity[k]);
+	}
+	else
+	{
+		float parent[12][Width];
+		for (size_t j = 0; j < Width; ++j)
+		{
+			auto parentIndex = m_parents[i + j];
+			for (size_t k = 0; k < 12; ++k)
+				parent[k][j] = parentIndex >= 0 ? m_world[k][parentIndex] : Identity[k];
+		}
+		for (size_t k = 0; k < 12; ++k)
+			p[k] = Ops::Load(parent[k]);
+	}
+
+	auto qx = Ops::Load(&m_rotationX[i]), qy = Ops::Load(&m_rotationY[i]), qz = Ops::Load(&m_rotationZ[i]), qw = Ops::Load(&m_rotationW[i]);
+	auto sx = Ops::Load(&m_scaleX[i]), sy = Ops::Load(&m_scaleY[i]), sz = Ops::Load(&m_scaleZ[i]);
+	auto one = Ops::Set(1.0f), two = Ops::Set(2.0f);
+
+	auto xx = Ops::Mul(qx, qx), yy = Ops::Mul(qy, qy), zz = Ops::Mul(qz, qz);
+	auto xy = Ops::Mul(qx, qy), xz = Ops::Mul(qx, qz), yz = Ops::Mul(qy, qz);
+	auto wx = Ops::Mul(qw, qx), wy = Ops::Mul(qw, qy), wz = Ops::Mul(qw, qz);
+
+	// Local 3x4 matrix (rotation * scale, then translation), local[column * 3 + row]
+	Type local[12];
+	local[0] = Ops::Mul(Ops::Sub(one, Ops::Mul(two, Ops::Add(yy, zz))), sx);
+	local[1] = Ops::Mul(Ops::Mul(two, Ops::Add(xy, wz)), sx);
+	local[2] = Ops::Mul(Ops::Mul(two, Ops::Sub(xz, wy)), sx);
+	local[3] = Ops::Mul(Ops::Mul(two, Ops::Sub(xy, wz)), sy);
+	local[4] = Ops::Mul(Ops::Sub(one, Ops::Mul(two, Ops::Add(xx, zz))), sy);
+	local[5] = Ops::Mul(Ops::Mul(two, Ops::Add(yz, wx)), sy);
+	local[6] = Ops::Mul(Ops::Mul(two, Ops::Add(xz, wy)), sz);
+	local[7] = Ops::Mul(Ops::Mul(two, Ops::Sub(yz, wx)), sz);
+	local[8] = Ops::Mul(Ops::Sub(one, Ops::Mul(two, Ops::Add(xx, yy))), sz);
+	local[9] = Ops::Load(&m_positionX[i]);
+	local[10] = Ops::Load(&m_positionY[i]);
+	local[11] = Ops::Load(&m_positionZ[i]);
+
+	// world = parent * local, the parent's translation is only added to the translation column
+	for (size_t column = 0; column < 4; ++column)
+		for (size_t row = 0; row < 3; ++row)
+		{
+			auto value = Ops::Add(Ops::Add(Ops::Mul(p[row], local[column * 3]), Ops::Mul(p[3 + row], local[column * 3 + 1])), Ops::Mul(p[6 + row], local[column * 3 + 2]));
+			if (column == 3)
+				value = Ops::Add(value, p[9 + row]);
+			Ops::Store(&m_world[column * 3 + row][i], value);
+		}
+}
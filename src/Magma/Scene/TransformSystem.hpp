@@ -0,0 +1,159 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Magma
+{
+	namespace Scene
+	{
+		/// <summary>
+		///		Transform hierarchy.
+		///		Local transforms (position, rotation, scale) and world matrices are stored in structure of arrays layout, sorted breadth first
+		///		so parents always come before their children and every level of the hierarchy is a contiguous range.
+		///		Changing a local transform marks it dirty, and updates only recompute the world matrices of dirty transforms and their descendants,
+		///		composing them in SIMD batches (8 transforms at a time with AVX, 4 with SSE).
+		///		Transforms on the same level don't depend on each other, so each level can be split between threads (see UpdateLevel).
+		///		Transforms are referenced by IDs, which stay valid while the arrays are reordered.
+		/// </summary>
+		class TransformSystem final
+		{
+		public:
+			TransformSystem();
+			~TransformSystem() = default;
+
+			/// <summary>
+			///		Creates a new transform, with an identity local transform
+			/// </summary>
+			/// <param name="parent">Parent transform ID (0 for a root transform)</param>
+			/// <returns>Transform ID</returns>
+			int Create(int parent = 0);
+
+			/// <summary>
+			///		Destroys a transform and all of its descendants
+			/// </summary>
+			/// <param name="transform">Transform ID</param>
+			void Destroy(int transform);
+
+			/// <summary>
+			///		Changes the parent of a transform (its local transform is kept)
+			/// </summary>
+			/// <param name="transform">Transform ID</param>
+			/// <param name="parent">New parent transform ID (0 to make it a root transform)</param>
+			void SetParent(int transform, int parent);
+
+			/// <summary>
+			///		Gets the parent of a transform (0 for root transforms)
+			/// </summary>
+			int GetParent(int transform) const;
+
+			/// <summary>
+			///		Sets the position of a transform relative to its parent
+			/// </summary>
+			void SetLocalPosition(int transform, const glm::vec3& position);
+
+			/// <summary>
+			///		Sets the rotation of a transform relative to its parent
+			/// </summary>
+			void SetLocalRotation(int transform, const glm::quat& rotation);
+
+			/// <summary>
+			///		Sets the scale of a transform relative to its parent
+			/// </summary>
+			void SetLocalScale(int transform, const glm::vec3& scale);
+
+			/// <summary>
+			///		Gets the position of a transform relative to its parent
+			/// </summary>
+			glm::vec3 GetLocalPosition(int transform) const;
+
+			/// <summary>
+			///		Gets the rotation of a transform relative to its parent
+			/// </summary>
+			glm::quat GetLocalRotation(int transform) const;
+
+			/// <summary>
+			///		Gets the scale of a transform relative to its parent
+			/// </summary>
+			glm::vec3 GetLocalScale(int transform) const;
+
+			/// <summary>
+			///		Gets the world matrix of a transform, as computed on the last update
+			/// </summary>
+			glm::mat4 GetWorldMatrix(int transform) const;
+
+			/// <summary>
+			///		Gets the world position of a transform, as computed on the last update
+			/// </summary>
+			glm::vec3 GetWorldPosition(int transform) const;
+
+			/// <summary>
+			///		Recomputes the world matrices of the dirty transforms and their descendants
+			/// </summary>
+			void Update();
+
+			/// <summary>
+			///		Starts a multithreaded update: applies pending hierarchy changes (creations, destructions and parent changes).
+			///		The levels must then be updated in order with UpdateLevel (the ranges of a level can be updated in parallel), followed by EndUpdate.
+			/// </summary>
+			void BeginUpdate();
+
+			/// <summary>
+			///		Recomputes the world matrices of the dirty transforms in a range of a hierarchy level (whose parents are already updated)
+			/// </summary>
+			/// <param name="level">Hierarchy level (0 for root transforms)</param>
+			/// <param name="first">First transform in the level</param>
+			/// <param name="count">Number of transforms updated</param>
+			void UpdateLevel(size_t level, size_t first, size_t count);
+
+			/// <summary>
+			///		Ends a multithreaded update, clearing the dirty flags
+			/// </summary>
+			void EndUpdate();
+
+			/// <summary>
+			///		Gets the number of transforms
+			/// </summary>
+			inline size_t GetCount() const { return m_parents.size(); }
+
+			/// <summary>
+			///		Gets the number of levels in the hierarchy (valid after BeginUpdate)
+			/// </summary>
+			inline size_t GetLevelCount() const { return m_levelOffsets.size() - 1; }
+
+			/// <summary>
+			///		Gets the number of transforms on a level of the hierarchy (valid after BeginUpdate)
+			/// </summary>
+			inline size_t GetLevelSize(size_t level) const { return m_levelOffsets[level + 1] - m_levelOffsets[level]; }
+
+		private:
+			size_t GetIndex(int transform) const;
+			void Rebuild();
+
+			template <typename TBatch>
+			void ComposeBatch(size_t i);
+
+			// Transform ID to array index, and free IDs
+			std::vector<size_t> m_indices;
+			std::vector<int> m_freeIDs;
+			bool m_structureDirty;
+
+			// Sorted arrays (parents come before their children)
+			std::vector<int> m_ids;
+			std::vector<int32_t> m_parents;
+			std::vector<uint8_t> m_dirty;
+			std::vector<uint8_t> m_destroyed;
+			std::vector<float> m_positionX, m_positionY, m_positionZ;
+			std::vector<float> m_rotationX, m_rotationY, m_rotationZ, m_rotationW;
+			std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+
+			// World matrices as 3x4 affine matrices, one array per element (column major: m_world[column * 3 + row])
+			std::vector<float> m_world[12];
+
+			std::vector<size_t> m_levelOffsets;
+		};
+	}
+}
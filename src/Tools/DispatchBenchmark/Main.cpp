@@ -0,0 +1,133 @@
+#include <Magma/Input/Window.hpp>
+#include <Magma/Graphics/GLContext.hpp>
+#include <Magma/Graphics/SpriteBatch.hpp>
+#include <Magma/Graphics/TextRenderer.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace Magma;
+
+// Renders frames of glyphs through a text renderer and returns the average CPU time spent submitting a frame, in milliseconds
+template <typename TContext>
+static double MeasureText(Input::Window& window, TContext& context, const std::string& fontPath, size_t frameCount, size_t glyphCount)
+{
+	Graphics::BasicTextRenderer<TContext> renderer(context);
+	renderer.Load(fontPath, 16);
+
+	std::string line = "The quick brown fox jumps over the lazy dog 0123456789";
+	auto lineCount = std::max<size_t>(glyphCount / line.size(), 1);
+	auto projection = glm::ortho(0.0f, (float)window.GetWidth(), 0.0f, (float)window.GetHeight());
+
+	double total = 0.0;
+	for (size_t frame = 0; frame < frameCount; ++frame)
+	{
+		window.PollEvents();
+		auto start = std::chrono::high_resolution_clock::now();
+		for (size_t i = 0; i < lineCount; ++i)
+		{
+			auto transform = glm::translate(projection, glm::vec3(0.0f, (float)(i % 50) * 16.0f, 0.0f));
+			renderer.Render(line, transform, glm::vec3(1.0f));
+		}
+		total += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		window.SwapBuffers();
+	}
+	return total / frameCount;
+}
+
+// Renders frames of sprites alternating between two textures (one draw call each) and returns the average CPU time spent submitting a frame, in milliseconds
+template <typename TContext>
+static double MeasureSprites(Input::Window& window, TContext& context, const int textures[2], size_t frameCount, size_t spriteCount)
+{
+	Graphics::BasicSpriteBatch<TContext> batch(context);
+	auto projection = glm::ortho(0.0f, (float)window.GetWidth(), 0.0f, (float)window.GetHeight());
+
+	double total = 0.0;
+	for (size_t frame = 0; frame < frameCount; ++frame)
+	{
+		window.PollEvents();
+		auto start = std::chrono::high_resolution_clock::now();
+		batch.Begin(projection, Graphics::SpriteSortMode::Deferred);
+		for (size_t i = 0; i < spriteCount; ++i)
+			batch.Draw(textures[i % 2], glm::vec2((float)(i % 100) * 14.0f, (float)(i / 100 % 60) * 13.0f), glm::vec2(12.0f));
+		batch.End();
+		total += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		window.SwapBuffers();
+	}
+	return total / frameCount;
+}
+
+// Measures the CPU cost of glyph and draw heavy frames when renderers call the virtual Context interface (dynamic dispatch)
+// against calling GLContext directly (static dispatch, used by release builds). Build it in release mode, where the calls can be inlined.
+//
+// Usage: DispatchBenchmark FONT [options]
+//	--headless			Renders without a visible window
+//	--frames=N			Number of frames measured per renderer (default 200)
+//	--glyphs=N			Number of glyphs rendered per frame (default 20000)
+//	--sprites=N			Number of sprites drawn per frame, each in its own draw call (default 20000)
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s FONT [--headless] [--frames=N] [--glyphs=N] [--sprites=N]\n", argv[0]);
+		return -1;
+	}
+
+	std::string fontPath = argv[1];
+	bool headless = false;
+	size_t frameCount = 200, glyphCount = 20000, spriteCount = 20000;
+	for (int i = 2; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--headless")
+			headless = true;
+		else if (arg.compare(0, 9, "--frames=") == 0)
+			frameCount = std::max<size_t>(std::stoul(arg.substr(9)), 1);
+		else if (arg.compare(0, 9, "--glyphs=") == 0)
+			glyphCount = std::stoul(arg.substr(9));
+		else if (arg.compare(0, 10, "--sprites=") == 0)
+			spriteCount = std::stoul(arg.substr(10));
+	}
+
+	Input::Window window(1400, 800, "Dispatch Benchmark", headless ? Input::WindowMode::Headless : Input::WindowMode::Windowed);
+	Graphics::GLContext glContext;
+	Graphics::Context& context = glContext;
+
+	// Two 1x1 textures, so consecutive sprites never share a draw call
+	int textures[2];
+	unsigned char pixels[2][4] = { { 255, 0, 0, 255 }, { 0, 0, 255, 255 } };
+	for (size_t i = 0; i < 2; ++i)
+	{
+		textures[i] = context.CreateTexture2D();
+		context.ActivateTexture2D(textures[i], 0);
+		context.TextureData2D(0, Graphics::PixelFormat::RGBA, 1, 1, Graphics::PixelFormat::RGBA, Graphics::PixelType::UByte, pixels[i]);
+		context.SetTextureMinFilter(Graphics::Filter::Nearest);
+		context.SetTextureMagFilter(Graphics::Filter::Nearest);
+		context.DeactivateTexture2D(textures[i], 0);
+	}
+
+	try
+	{
+		printf("%10s %18s %18s %10s\n", "Workload", "Context (ms)", "GLContext (ms)", "Speedup");
+
+		auto dynamicText = MeasureText<Graphics::Context>(window, context, fontPath, frameCount, glyphCount);
+		auto staticText = MeasureText<Graphics::GLContext>(window, glContext, fontPath, frameCount, glyphCount);
+		printf("%10s %18.3f %18.3f %9.2fx\n", "Text", dynamicText, staticText, dynamicText / staticText);
+
+		auto dynamicSprites = MeasureSprites<Graphics::Context>(window, context, textures, frameCount, spriteCount);
+		auto staticSprites = MeasureSprites<Graphics::GLContext>(window, glContext, textures, frameCount, spriteCount);
+		printf("%10s %18.3f %18.3f %9.2fx\n", "Sprites", dynamicSprites, staticSprites, dynamicSprites / staticSprites);
+	}
+	catch (std::runtime_error& err)
+	{
+		fprintf(stderr, "%s\n", err.what());
+	}
+
+	for (size_t i = 0; i < 2; ++i)
+		context.DestroyTexture2D(textures[i]);
+	return 0;
+}
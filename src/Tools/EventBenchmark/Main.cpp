@@ -0,0 +1,77 @@
+#include <Magma/Input/Event.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+
+using namespace Magma;
+
+// Previous Event implementation (ordered map of std::functions), kept as the baseline
+template <typename ... TArgs>
+class MapEvent
+{
+public:
+	inline MapEvent() { m_nextID = 1; }
+
+	inline size_t AddListener(std::function<void(TArgs...)> listener) { m_listeners.emplace(m_nextID, listener); return m_nextID++; }
+	inline void RemoveListener(size_t listener) { m_listeners.erase(listener); }
+
+	inline void Fire(TArgs ... args) { for (auto& l : m_listeners) l.second(args...); }
+
+private:
+	size_t m_nextID;
+	std::map<size_t, std::function<void(TArgs...)>> m_listeners;
+};
+
+// Adds listeners to an event and measures how long it takes to fire it, in nanoseconds per listener call
+template <typename TEvent>
+static double Measure(size_t listenerCount, size_t callCount)
+{
+	TEvent event;
+	volatile int sink = 0;
+	int offsets[4] = { 1, 2, 3, 4 };
+	for (size_t i = 0; i < listenerCount; ++i)
+	{
+		// Captures three pointers, which std::function implementations usually store on the heap
+		auto offset = &offsets[i % 4];
+		auto sinkPointer = &sink;
+		auto index = i;
+		event.AddListener([offset, sinkPointer, index](int x, int y) { *sinkPointer = *sinkPointer + x * *offset + y + (int)index; });
+	}
+
+	auto fireCount = std::max<size_t>(callCount / listenerCount, 1);
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < fireCount; ++i)
+		event.Fire((int)i, 1);
+	auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+	return elapsed / (fireCount * listenerCount);
+}
+
+// Measures Event::Fire throughput with 1 to 1000 listeners, against the previous std::map and std::function implementation.
+//
+// Usage: EventBenchmark [options]
+//	--calls=N			Number of listener calls measured for each listener count (default 10000000)
+int main(int argc, char** argv)
+{
+	size_t callCount = 10000000;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg.compare(0, 8, "--calls=") == 0)
+			callCount = std::stoul(arg.substr(8));
+	}
+
+	printf("%10s %16s %16s %10s\n", "Listeners", "Event (ns/call)", "Map (ns/call)", "Speedup");
+	size_t listenerCounts[] = { 1, 10, 100, 1000 };
+	for (auto listenerCount : listenerCounts)
+	{
+		auto event = Measure<Input::Event<int, int>>(listenerCount, callCount);
+		auto map = Measure<MapEvent<int, int>>(listenerCount, callCount);
+		printf("%10zu %16.3f %16.3f %9.2fx\n", listenerCount, event, map, map / event);
+	}
+
+	return 0;
+}
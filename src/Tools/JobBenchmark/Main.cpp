@@ -0,0 +1,139 @@
+#include <Magma/Core/JobSystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Magma;
+
+// Runs a workload a few times and returns the fastest run, in milliseconds
+template <typename TFunction>
+static double Measure(size_t repeatCount, const TFunction& function)
+{
+	double best = 0.0;
+	for (size_t i = 0; i < repeatCount; ++i)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		function();
+		auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		best = (i == 0) ? elapsed : std::min(best, elapsed);
+	}
+	return best;
+}
+
+// Compute bound work on a single element, heavy enough for the scheduling overhead not to matter
+static float Work(float x)
+{
+	for (int i = 0; i < 64; ++i)
+		x = std::sqrt(x * x + 1.0f) * 0.999f;
+	return x;
+}
+
+// Measures how the job system scales from 1 to N workers, on a large parallel for (few large chunks),
+// on many tiny independent jobs (scheduling and stealing overhead), and on jobs which wait on child jobs (fiber switches).
+//
+// Usage: JobBenchmark [options]
+//	--workers=N			Maximum number of workers (default one per hardware thread)
+//	--elements=N		Number of elements processed by the parallel for (default 4000000)
+//	--jobs=N			Number of tiny jobs (default 100000)
+//	--fibers=N			Number of fibers per worker (default 16, 0 to disable fibers)
+//	--repeats=N			Number of runs per measure, the fastest is kept (default 5)
+int main(int argc, char** argv)
+{
+	size_t maxWorkers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	size_t elementCount = 4000000;
+	size_t jobCount = 100000;
+	size_t repeatCount = 5;
+	size_t fiberCount = 16;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg.compare(0, 10, "--workers=") == 0)
+			maxWorkers = std::max<size_t>(std::stoul(arg.substr(10)), 1);
+		else if (arg.compare(0, 11, "--elements=") == 0)
+			elementCount = std::stoul(arg.substr(11));
+		else if (arg.compare(0, 7, "--jobs=") == 0)
+			jobCount = std::stoul(arg.substr(7));
+		else if (arg.compare(0, 9, "--fibers=") == 0)
+			fiberCount = std::stoul(arg.substr(9));
+		else if (arg.compare(0, 10, "--repeats=") == 0)
+			repeatCount = std::max<size_t>(std::stoul(arg.substr(10)), 1);
+	}
+
+	std::vector<float> elements(elementCount);
+	std::vector<size_t> results(jobCount);
+	for (size_t i = 0; i < elementCount; ++i)
+		elements[i] = (float)(i % 1000);
+
+	printf("%8s %18s %9s %18s %9s %18s %9s\n", "Workers", "ParallelFor (ms)", "Speedup", "Tiny jobs (ms)", "Speedup", "Waiting jobs (ms)", "Speedup");
+	double baseFor = 0.0, baseJobs = 0.0, baseWaiting = 0.0;
+	for (size_t workerCount = 1;; workerCount = std::min(workerCount * 2, maxWorkers))
+	{
+		JobSystem jobSystem(workerCount, 4096, fiberCount);
+
+		auto parallelFor = Measure(repeatCount, [&]()
+		{
+			jobSystem.ParallelFor(elementCount, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; ++i)
+					elements[i] = Work(elements[i]);
+			}, 1024);
+		});
+
+		auto tinyJobs = Measure(repeatCount, [&]()
+		{
+			JobCounter counter;
+			auto data = results.data();
+			for (size_t i = 0; i < jobCount; ++i)
+				jobSystem.Run([data, i]() { data[i] += i; }, &counter);
+			jobSystem.Wait(counter);
+		});
+
+		// Like loading assets: each job splits the elements of its slice between child jobs, waits on them, then finishes its slice
+		auto waitingJobs = Measure(repeatCount, [&]()
+		{
+			const size_t parentCount = 256, childCount = 16;
+			auto sliceSize = elementCount / parentCount;
+			JobCounter parents;
+			for (size_t p = 0; p < parentCount; ++p)
+				jobSystem.Run([&, p, sliceSize]()
+				{
+					JobCounter children;
+					auto childSize = sliceSize / childCount;
+					for (size_t c = 0; c < childCount; ++c)
+					{
+						auto child = elements.data() + p * sliceSize + c * childSize;
+						jobSystem.Run([child, childSize]()
+						{
+							for (size_t i = 0; i < childSize; ++i)
+								child[i] = Work(child[i]);
+						}, &children);
+					}
+					jobSystem.Wait(children);
+
+					auto first = p * sliceSize;
+					for (size_t i = first; i < first + sliceSize; i += childSize)
+						elements[i] = Work(elements[i]);
+				}, &parents);
+			jobSystem.Wait(parents);
+		});
+
+		if (workerCount == 1)
+		{
+			baseFor = parallelFor;
+			baseJobs = tinyJobs;
+			baseWaiting = waitingJobs;
+		}
+		printf("%8zu %18.3f %8.2fx %18.3f %8.2fx %18.3f %8.2fx\n", workerCount, parallelFor, baseFor / parallelFor, tinyJobs, baseJobs / tinyJobs, waitingJobs, baseWaiting / waitingJobs);
+
+		// Powers of two, then the maximum
+		if (workerCount == maxWorkers)
+			break;
+	}
+
+	return 0;
+}
@@ -0,0 +1,388 @@
+#include "MeshOptimizer.hpp"
+
+#include <Magma/Graphics/AttributePacking.hpp>
+#include <Magma/Graphics/Context.hpp>
+#include <Magma/Graphics/MeshFormat.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace Magma;
+
+// Quantized vertex layout written by the cooker (16 bytes)
+struct CookedVertex
+{
+	uint16_t position[4];	// unorm16 relative to the mesh bounds, the last component is padding
+	uint32_t normal;		// snorm 10_10_10_2, w is unused
+	uint16_t uv[2];			// unorm16 relative to the texture coordinate bounds
+};
+
+static_assert(sizeof(CookedVertex) == 16, "CookedVertex must have no padding");
+
+struct CookedVertexHash
+{
+	size_t operator()(const CookedVertex& v) const
+	{
+		// FNV-1a over the vertex bytes
+		uint64_t hash = 14695981039346656037ull;
+		auto bytes = (const unsigned char*)&v;
+		for (size_t i = 0; i < sizeof(v); ++i)
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		return (size_t)hash;
+	}
+};
+
+struct CookedVertexEqual
+{
+	bool operator()(const CookedVertex& a, const CookedVertex& b) const
+	{
+		return std::memcmp(&a, &b, sizeof(a)) == 0;
+	}
+};
+
+static uint16_t QuantizeUnorm16(float value, float offset, float scale)
+{
+	if (scale == 0.0f)
+		return 0;
+	auto q = std::round((value - offset) / scale);
+	return (uint16_t)std::min(std::max(q, 0.0f), 65535.0f);
+}
+
+static void WritePadding(std::ofstream& out)
+{
+	static const char zeros[16] = {};
+	auto position = (size_t)out.tellp();
+	out.write(zeros, (16 - position % 16) % 16);
+}
+
+// Imports a mesh with assimp and writes it as a cooked mesh (see MeshFormat.hpp), ready to be memory mapped and uploaded by Graphics::Mesh.
+//
+// Usage: MeshCooker INPUT OUTPUT [options]
+//	--no-optimize		Keeps the triangle and vertex order from the source file
+//	--lods=N			Maximum number of levels of detail, including the full detail one (default 4)
+//	--lod-error=E		Maximum simplification error, relative to the size of the mesh bounds (default 0.02)
+//	--quiet				Only prints errors
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "Usage: %s INPUT OUTPUT [--no-optimize] [--lods=N] [--lod-error=E] [--quiet]\n", argv[0]);
+		return -1;
+	}
+
+	std::string inputPath = argv[1];
+	std::string outputPath = argv[2];
+	bool optimize = true, quiet = false;
+	size_t lodCount = 4;
+	float lodError = 0.02f;
+	for (int i = 3; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--no-optimize")
+			optimize = false;
+		else if (arg == "--quiet")
+			quiet = true;
+		else if (arg.compare(0, 7, "--lods=") == 0)
+			lodCount = std::min(std::max(std::stoul(arg.substr(7)), 1ul), (unsigned long)Graphics::MaxMeshLods);
+		else if (arg.compare(0, 12, "--lod-error=") == 0)
+			lodError = std::stof(arg.substr(12));
+	}
+
+	Assimp::Importer importer;
+	auto scene = importer.ReadFile(inputPath,
+								   aiProcess_Triangulate |
+								   aiProcess_JoinIdenticalVertices |
+								   aiProcess_GenSmoothNormals |
+								   aiProcess_PreTransformVertices |
+								   aiProcess_SortByPType |
+								   aiProcess_FindDegenerates |
+								   aiProcess_FindInvalidData);
+	if (scene == nullptr)
+	{
+		fprintf(stderr, "Failed to import '%s': %s\n", inputPath.c_str(), importer.GetErrorString());
+		return -1;
+	}
+
+	// Gather the positions and texture coordinate bounds used for quantization
+	glm::vec3 positionMin(INFINITY), positionMax(-INFINITY);
+	glm::vec2 uvMin(INFINITY), uvMax(-INFINITY);
+	size_t sourceVertexCount = 0;
+	for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+	{
+		auto mesh = scene->mMeshes[m];
+		if ((mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE) == 0)
+			continue;
+
+		for (unsigned int v = 0; v < mesh->mNumVertices; ++v)
+		{
+			auto& p = mesh->mVertices[v];
+			positionMin = glm::min(positionMin, glm::vec3(p.x, p.y, p.z));
+			positionMax = glm::max(positionMax, glm::vec3(p.x, p.y, p.z));
+			if (mesh->HasTextureCoords(0))
+			{
+				auto& uv = mesh->mTextureCoords[0][v];
+				uvMin = glm::min(uvMin, glm::vec2(uv.x, uv.y));
+				uvMax = glm::max(uvMax, glm::vec2(uv.x, uv.y));
+			}
+		}
+		sourceVertexCount += mesh->mNumVertices;
+	}
+
+	if (sourceVertexCount == 0)
+	{
+		fprintf(stderr, "Failed to cook '%s': the file has no triangle meshes\n", inputPath.c_str());
+		return -1;
+	}
+	if (uvMin.x > uvMax.x)
+		uvMin = uvMax = glm::vec2(0.0f);
+
+	auto positionScale = (positionMax - positionMin) / 65535.0f;
+	auto uvScale = (uvMax - uvMin) / 65535.0f;
+
+	// Quantize the vertices of every mesh into a single vertex buffer, merging the ones which became identical
+	std::vector<CookedVertex> vertices;
+	std::vector<std::vector<uint32_t>> submeshIndices;
+	std::vector<uint32_t> submeshMaterials;
+	std::unordered_map<CookedVertex, uint32_t, CookedVertexHash, CookedVertexEqual> vertexMap;
+	std::vector<uint32_t> remap;
+
+	for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+	{
+		auto mesh = scene->mMeshes[m];
+		if ((mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE) == 0)
+			continue;
+
+		remap.resize(mesh->mNumVertices);
+		for (unsigned int v = 0; v < mesh->mNumVertices; ++v)
+		{
+			CookedVertex cooked = {};
+			auto& p = mesh->mVertices[v];
+			cooked.position[0] = QuantizeUnorm16(p.x, positionMin.x, positionScale.x);
+			cooked.position[1] = QuantizeUnorm16(p.y, positionMin.y, positionScale.y);
+			cooked.position[2] = QuantizeUnorm16(p.z, positionMin.z, positionScale.z);
+			if (mesh->HasNormals())
+			{
+				auto& n = mesh->mNormals[v];
+				cooked.normal = Graphics::PackSnorm2_10_10_10(glm::vec4(n.x, n.y, n.z, 0.0f));
+			}
+			if (mesh->HasTextureCoords(0))
+			{
+				auto& uv = mesh->mTextureCoords[0][v];
+				cooked.uv[0] = QuantizeUnorm16(uv.x, uvMin.x, uvScale.x);
+				cooked.uv[1] = QuantizeUnorm16(uv.y, uvMin.y, uvScale.y);
+			}
+
+			auto it = vertexMap.find(cooked);
+			if (it == vertexMap.end())
+			{
+				it = vertexMap.emplace(cooked, (uint32_t)vertices.size()).first;
+				vertices.push_back(cooked);
+			}
+			remap[v] = it->second;
+		}
+
+		std::vector<uint32_t> indices;
+		for (unsigned int f = 0; f < mesh->mNumFaces; ++f)
+		{
+			auto& face = mesh->mFaces[f];
+			if (face.mNumIndices != 3)
+				continue;
+
+			// Skip triangles which became degenerate after quantization
+			auto a = remap[face.mIndices[0]], b = remap[face.mIndices[1]], c = remap[face.mIndices[2]];
+			if (a == b || b == c || a == c)
+				continue;
+			indices.push_back(a);
+			indices.push_back(b);
+			indices.push_back(c);
+		}
+
+		if (!indices.empty())
+		{
+			submeshIndices.push_back(std::move(indices));
+			submeshMaterials.push_back(mesh->mMaterialIndex);
+		}
+	}
+
+	auto vertexCount = vertices.size();
+	std::vector<glm::vec3> positions(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v)
+		positions[v] = glm::vec3(vertices[v].position[0], vertices[v].position[1], vertices[v].position[2]) * positionScale + positionMin;
+
+	// Vertices used by several submeshes are locked, as simplifying each submesh on its own would crack their shared borders
+	std::vector<bool> locked(vertexCount, false);
+	{
+		std::vector<uint32_t> owner(vertexCount, UINT32_MAX);
+		for (size_t s = 0; s < submeshIndices.size(); ++s)
+			for (auto v : submeshIndices[s])
+			{
+				if (owner[v] == UINT32_MAX)
+					owner[v] = (uint32_t)s;
+				else if (owner[v] != s)
+					locked[v] = true;
+			}
+	}
+
+	// Simplify each level of detail from the previous one, halving its triangles until the error limit is reached
+	// or the simplification stops making progress (all levels share the vertex buffer)
+	std::vector<std::vector<std::vector<uint32_t>>> lodIndices = { submeshIndices };
+	std::vector<float> lodErrors = { 0.0f };
+	auto maxError = lodError * glm::length(positionMax - positionMin);
+	while (lodIndices.size() < lodCount)
+	{
+		// The new level is simplified from the previous one, so their errors add up and it only gets what is left of the limit
+		auto remainingError = maxError - lodErrors.back();
+		if (remainingError <= 0.0f)
+			break;
+
+		auto lod = lodIndices.back();
+		size_t previousCount = 0, count = 0;
+		float error = 0.0f;
+		for (auto& indices : lod)
+		{
+			previousCount += indices.size();
+			error = std::max(error, SimplifyMesh(indices, positions, locked, indices.size() / 2, remainingError));
+			count += indices.size();
+		}
+
+		if (count == 0 || count > previousCount * 9 / 10)
+			break;
+		lodIndices.push_back(std::move(lod));
+		lodErrors.push_back(lodErrors.back() + error);
+	}
+
+	// Lay out the index buffer level by level, with the submeshes of a level contiguous
+	std::vector<uint32_t> indices;
+	std::vector<Graphics::MeshFileSubmesh> submeshes;
+	std::vector<Graphics::MeshFileLod> lods;
+	for (size_t l = 0; l < lodIndices.size(); ++l)
+	{
+		Graphics::MeshFileLod lod;
+		lod.firstIndex = (uint32_t)indices.size();
+		lod.error = lodErrors[l];
+		lod.reserved = 0;
+
+		for (size_t s = 0; s < submeshIndices.size(); ++s)
+		{
+			Graphics::MeshFileSubmesh submesh;
+			submesh.firstIndex = (uint32_t)indices.size();
+			submesh.indexCount = (uint32_t)lodIndices[l][s].size();
+			submesh.material = submeshMaterials[s];
+			submesh.reserved = 0;
+			submeshes.push_back(submesh);
+			indices.insert(indices.end(), lodIndices[l][s].begin(), lodIndices[l][s].end());
+		}
+
+		lod.indexCount = (uint32_t)indices.size() - lod.firstIndex;
+		lods.push_back(lod);
+	}
+
+	float acmrBefore = ComputeACMR(indices.data(), indices.size(), vertexCount);
+
+	if (optimize)
+	{
+		// Triangles are only reordered within their submesh, so submeshes stay contiguous
+		for (auto& s : submeshes)
+		{
+			OptimizeVertexCache(&indices[s.firstIndex], s.indexCount, vertexCount);
+			OptimizeOverdraw(&indices[s.firstIndex], s.indexCount, positions);
+		}
+
+		// Vertices are ordered by their first use, which is in the first level of detail as the others only use a subset of its vertices.
+		// Vertices no triangle uses (such as the ones of triangles which became degenerate after quantization) are dropped.
+		auto order = OptimizeVertexFetch(indices, vertexCount);
+		std::vector<CookedVertex> reordered(order.size());
+		for (size_t v = 0; v < order.size(); ++v)
+			reordered[v] = vertices[order[v]];
+		vertices.swap(reordered);
+		vertexCount = vertices.size();
+	}
+
+	float acmrAfter = ComputeACMR(indices.data(), indices.size(), vertexCount);
+
+	// Fill the header
+	Graphics::MeshFileHeader header = {};
+	header.magic = Graphics::MeshFileMagic;
+	header.version = Graphics::MeshFileVersion;
+	header.vertexCount = (uint32_t)vertexCount;
+	header.vertexStride = sizeof(CookedVertex);
+	header.indexCount = (uint32_t)indices.size();
+	header.indexType = (int32_t)(vertexCount <= 65536 ? Graphics::IndexType::UShort : Graphics::IndexType::UInt);
+	header.submeshCount = (uint32_t)submeshIndices.size();
+	header.lodCount = (uint32_t)lods.size();
+
+	header.attributeCount = 3;
+	header.attributes[0] = { (int32_t)Graphics::MeshAttribute::Position, (int32_t)Graphics::AttributeType::UShort, 3, 1, offsetof(CookedVertex, position) };
+	header.attributes[1] = { (int32_t)Graphics::MeshAttribute::Normal, (int32_t)Graphics::AttributeType::Int2_10_10_10, 4, 1, offsetof(CookedVertex, normal) };
+	header.attributes[2] = { (int32_t)Graphics::MeshAttribute::UV, (int32_t)Graphics::AttributeType::UShort, 2, 1, offsetof(CookedVertex, uv) };
+
+	// Normalized attributes are read as [0, 1] in shaders, so the scales cover the whole quantized range
+	for (int i = 0; i < 3; ++i)
+	{
+		header.positionOffset[i] = positionMin[i];
+		header.positionScale[i] = positionScale[i] * 65535.0f;
+	}
+	for (int i = 0; i < 2; ++i)
+	{
+		header.uvOffset[i] = uvMin[i];
+		header.uvScale[i] = uvScale[i] * 65535.0f;
+	}
+
+	std::ofstream out(outputPath, std::ios::binary);
+	if (!out)
+	{
+		fprintf(stderr, "Failed to open '%s' for writing\n", outputPath.c_str());
+		return -1;
+	}
+
+	out.write((const char*)&header, sizeof(header));
+
+	WritePadding(out);
+	header.vertexDataOffset = (uint64_t)out.tellp();
+	out.write((const char*)vertices.data(), vertices.size() * sizeof(CookedVertex));
+
+	WritePadding(out);
+	header.indexDataOffset = (uint64_t)out.tellp();
+	if (header.indexType == (int32_t)Graphics::IndexType::UShort)
+	{
+		std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+		out.write((const char*)shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+	}
+	else out.write((const char*)indices.data(), indices.size() * sizeof(uint32_t));
+
+	WritePadding(out);
+	header.submeshDataOffset = (uint64_t)out.tellp();
+	out.write((const char*)submeshes.data(), submeshes.size() * sizeof(Graphics::MeshFileSubmesh));
+
+	WritePadding(out);
+	header.lodDataOffset = (uint64_t)out.tellp();
+	out.write((const char*)lods.data(), lods.size() * sizeof(Graphics::MeshFileLod));
+
+	// Rewrite the header now that the data offsets are known
+	out.seekp(0);
+	out.write((const char*)&header, sizeof(header));
+	out.close();
+
+	if (!quiet)
+	{
+		printf("Cooked '%s' into '%s'\n", inputPath.c_str(), outputPath.c_str());
+		printf("\t%zu source vertices, %zu cooked vertices (%u bytes each), %zu submeshes\n",
+			   sourceVertexCount, vertexCount, header.vertexStride, submeshIndices.size());
+		for (size_t l = 0; l < lods.size(); ++l)
+			printf("\tLOD %zu: %u triangles, error %f\n", l, lods[l].indexCount / 3, lods[l].error);
+		printf("\tACMR %.3f -> %.3f (16 entry FIFO)\n", acmrBefore, acmrAfter);
+	}
+
+	return 0;
+}
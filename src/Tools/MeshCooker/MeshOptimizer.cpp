@@ -0,0 +1,500 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+// Forsyth's scoring parameters
+static constexpr int CacheSize = 32;
+static constexpr float CacheDecayPower = 1.5f;
+static constexpr float LastTriangleScore = 0.75f;
+static constexpr float ValenceBoostScale = 2.0f;
+static constexpr float ValenceBoostPower = 0.5f;
+
+static float VertexScore(int cachePosition, size_t remainingTriangles)
+{
+	if (remainingTriangles == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+	if (cachePosition >= 0)
+	{
+		// The vertices of the last triangle added get a fixed score, so the next triangle doesn't just reuse the same edge
+		if (cachePosition < 3)
+			score = LastTriangleScore;
+		else
+			score = std::pow(1.0f - (float)(cachePosition - 3) / (CacheSize - 3), CacheDecayPower);
+	}
+
+	// Vertices with few remaining triangles are boosted so they are finished off instead of lingering
+	return score + ValenceBoostScale * std::pow((float)remainingTriangles, -ValenceBoostPower);
+}
+
+void OptimizeVertexCache(uint32_t * indices, size_t indexCount, size_t vertexCount)
+{
+	auto triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Triangles adjacent to each vertex
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (size_t i = 0; i < indexCount; ++i)
+		++adjacencyOffsets[indices[i] + 1];
+	for (size_t v = 0; v < vertexCount; ++v)
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+	std::vector<uint32_t> adjacency(indexCount);
+	std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t i = 0; i < indexCount; ++i)
+		adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+
+	std::vector<uint32_t> remaining(vertexCount);
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		remaining[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+		vertexScores[v] = VertexScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> added(triangleCount, false);
+	for (size_t t = 0; t < triangleCount; ++t)
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+
+	std::vector<uint32_t> output;
+	output.reserve(indexCount);
+	std::vector<uint32_t> cache, newCache;
+	size_t scanStart = 0;
+
+	for (size_t added_count = 0; added_count < triangleCount; ++added_count)
+	{
+		// Pick the best triangle touching the cache, or the best remaining one if none does
+		int64_t best = -1;
+		float bestScore = -1.0f;
+		for (auto v : cache)
+			for (auto a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+			{
+				auto t = adjacency[a];
+				if (!added[t] && triangleScores[t] > bestScore)
+				{
+					best = t;
+					bestScore = triangleScores[t];
+				}
+			}
+
+		if (best < 0)
+		{
+			while (added[scanStart])
+				++scanStart;
+			for (size_t t = scanStart; t < triangleCount; ++t)
+				if (!added[t] && triangleScores[t] > bestScore)
+				{
+					best = (int64_t)t;
+					bestScore = triangleScores[t];
+				}
+		}
+
+		added[best] = true;
+		auto tri = &indices[best * 3];
+		output.insert(output.end(), tri, tri + 3);
+
+		// Move the triangle's vertices to the front of the cache
+		newCache.assign(tri, tri + 3);
+		for (auto v : cache)
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+				newCache.push_back(v);
+
+		for (int i = 0; i < 3; ++i)
+			--remaining[tri[i]];
+
+		for (size_t i = 0; i < newCache.size(); ++i)
+		{
+			auto v = newCache[i];
+			cachePosition[v] = i < (size_t)CacheSize ? (int)i : -1;
+			vertexScores[v] = VertexScore(cachePosition[v], remaining[v]);
+		}
+
+		// Update the scores of the triangles around every vertex whose score changed
+		for (auto v : newCache)
+			for (auto a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+			{
+				auto t = adjacency[a];
+				if (!added[t])
+					triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+			}
+
+		if (newCache.size() > (size_t)CacheSize)
+			newCache.resize(CacheSize);
+		std::swap(cache, newCache);
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+void OptimizeOverdraw(uint32_t * indices, size_t indexCount, const std::vector<glm::vec3>& positions)
+{
+	auto triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return;
+
+	// Split into clusters where a triangle misses the cache on all of its vertices (the cache is cold there anyway)
+	std::vector<size_t> clusterStarts;
+	std::vector<uint32_t> cache;
+	for (size_t t = 0; t < triangleCount; ++t)
+	{
+		int misses = 0;
+		for (int i = 0; i < 3; ++i)
+		{
+			auto v = indices[t * 3 + i];
+			if (std::find(cache.begin(), cache.end(), v) == cache.end())
+			{
+				++misses;
+				cache.push_back(v);
+				if (cache.size() > 16)
+					cache.erase(cache.begin());
+			}
+		}
+
+		if (t == 0 || misses == 3)
+			clusterStarts.push_back(t);
+	}
+	clusterStarts.push_back(triangleCount);
+
+	glm::vec3 meshCenter(0.0f);
+	float meshArea = 0.0f;
+	struct Cluster { size_t first, last; float sortKey; };
+	std::vector<Cluster> clusters;
+
+	std::vector<glm::vec3> clusterCenters, clusterNormals;
+	for (size_t c = 0; c + 1 < clusterStarts.size(); ++c)
+	{
+		glm::vec3 center(0.0f), normal(0.0f);
+		float area = 0.0f;
+		for (auto t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t)
+		{
+			auto& a = positions[indices[t * 3]];
+			auto& b = positions[indices[t * 3 + 1]];
+			auto& d = positions[indices[t * 3 + 2]];
+			auto n = glm::cross(b - a, d - a);
+			auto triangleArea = glm::length(n) * 0.5f;
+			center += (a + b + d) * (triangleArea / 3.0f);
+			normal += n;
+			area += triangleArea;
+		}
+
+		meshCenter += center;
+		meshArea += area;
+		clusterCenters.push_back(area > 0.0f ? center / area : positions[indices[clusterStarts[c] * 3]]);
+		clusterNormals.push_back(glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f));
+		clusters.push_back(Cluster { clusterStarts[c], clusterStarts[c + 1], 0.0f });
+	}
+	if (meshArea > 0.0f)
+		meshCenter = meshCenter / meshArea;
+
+	// Clusters facing away from the mesh center are more likely to occlude the others, so they are drawn first
+	for (size_t c = 0; c < clusters.size(); ++c)
+		clusters[c].sortKey = glm::dot(clusterCenters[c] - meshCenter, clusterNormals[c]);
+	std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+	std::vector<uint32_t> output;
+	output.reserve(indexCount);
+	for (auto& c : clusters)
+		output.insert(output.end(), indices + c.first * 3, indices + c.last * 3);
+	std::copy(output.begin(), output.end(), indices);
+}
+
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+	std::vector<uint32_t> order;
+	order.reserve(vertexCount);
+
+	for (auto& i : indices)
+	{
+		if (remap[i] == UINT32_MAX)
+		{
+			remap[i] = (uint32_t)order.size();
+			order.push_back(i);
+		}
+		i = remap[i];
+	}
+
+	return order;
+}
+
+float ComputeACMR(const uint32_t * indices, size_t indexCount, size_t vertexCount, size_t cacheSize)
+{
+	if (indexCount < 3)
+		return 0.0f;
+
+	// FIFO cache, simulated with the time each vertex entered it
+	std::vector<size_t> entered(vertexCount, SIZE_MAX);
+	size_t time = 0, misses = 0;
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		auto v = indices[i];
+		if (entered[v] == SIZE_MAX || time - entered[v] >= cacheSize)
+		{
+			entered[v] = time++;
+			++misses;
+		}
+	}
+
+	return (float)misses / (indexCount / 3);
+}
+
+// Symmetric 4x4 quadric (sum of squared distances to a set of planes), weighted by the area of the planes' triangles
+struct Quadric
+{
+	double a2, b2, c2, d2, ab, ac, ad, bc, bd, cd;
+	double weight;
+};
+
+static void AddPlane(Quadric& q, const glm::vec3& normal, float distance, double weight)
+{
+	double a = normal.x, b = normal.y, c = normal.z, d = distance;
+	q.a2 += a * a * weight; q.b2 += b * b * weight; q.c2 += c * c * weight; q.d2 += d * d * weight;
+	q.ab += a * b * weight; q.ac += a * c * weight; q.ad += a * d * weight;
+	q.bc += b * c * weight; q.bd += b * d * weight; q.cd += c * d * weight;
+	q.weight += weight;
+}
+
+static void AddQuadric(Quadric& q, const Quadric& other)
+{
+	q.a2 += other.a2; q.b2 += other.b2; q.c2 += other.c2; q.d2 += other.d2;
+	q.ab += other.ab; q.ac += other.ac; q.ad += other.ad;
+	q.bc += other.bc; q.bd += other.bd; q.cd += other.cd;
+	q.weight += other.weight;
+}
+
+// Average distance from a point to the quadric's planes
+static float QuadricError(const Quadric& q, const glm::vec3& p)
+{
+	double x = p.x, y = p.y, z = p.z;
+	double e = q.a2 * x * x + q.b2 * y * y + q.c2 * z * z + q.d2 +
+		2.0 * (q.ab * x * y + q.ac * x * z + q.ad * x + q.bc * y * z + q.bd * y + q.cd * z);
+	return q.weight > 0.0 ? (float)std::sqrt(std::max(e / q.weight, 0.0)) : 0.0f;
+}
+
+enum class VertexKind
+{
+	Invalid = -1,
+
+	Manifold,
+	Border,
+	Locked,
+
+	Count
+};
+
+struct EdgeCollapse
+{
+	float error;
+	uint32_t from, to;
+
+	inline bool operator<(const EdgeCollapse& rhs) const { return error < rhs.error; }
+};
+
+static uint64_t EdgeKey(uint32_t a, uint32_t b)
+{
+	return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+}
+
+float SimplifyMesh(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions, const std::vector<bool>& locked, size_t targetIndexCount, float maxError)
+{
+	auto vertexCount = positions.size();
+
+	// Vertices sharing their position with another vertex are on attribute seams, collapsing them would tear the seam open
+	std::vector<bool> seam(vertexCount, false);
+	{
+		std::vector<uint32_t> sorted(vertexCount);
+		for (size_t v = 0; v < vertexCount; ++v)
+			sorted[v] = (uint32_t)v;
+		auto less = [&](uint32_t a, uint32_t b)
+		{
+			auto& pa = positions[a];
+			auto& pb = positions[b];
+			return pa.x != pb.x ? pa.x < pb.x : pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z;
+		};
+		std::sort(sorted.begin(), sorted.end(), less);
+		for (size_t i = 1; i < vertexCount; ++i)
+			if (!less(sorted[i - 1], sorted[i]))
+				seam[sorted[i - 1]] = seam[sorted[i]] = true;
+	}
+
+	std::vector<Quadric> quadrics(vertexCount, Quadric {});
+	std::vector<VertexKind> kinds(vertexCount);
+	std::unordered_map<uint64_t, uint32_t> edgeCounts;
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+		for (int e = 0; e < 3; ++e)
+			++edgeCounts[EdgeKey(indices[i + e], indices[i + (e + 1) % 3])];
+
+	for (size_t v = 0; v < vertexCount; ++v)
+		kinds[v] = seam[v] || locked[v] ? VertexKind::Locked : VertexKind::Manifold;
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		auto& a = positions[indices[i]];
+		auto& b = positions[indices[i + 1]];
+		auto& c = positions[indices[i + 2]];
+		auto n = glm::cross(b - a, c - a);
+		auto area = glm::length(n);
+		if (area == 0.0f)
+			continue;
+		n = n / area;
+
+		for (int e = 0; e < 3; ++e)
+			AddPlane(quadrics[indices[i + e]], n, -glm::dot(n, a), area);
+
+		// Open border edges add a plane perpendicular to the triangle, which keeps the border from shrinking
+		for (int e = 0; e < 3; ++e)
+		{
+			auto v0 = indices[i + e], v1 = indices[i + (e + 1) % 3];
+			if (edgeCounts[EdgeKey(v0, v1)] != 1)
+				continue;
+
+			auto edge = positions[v1] - positions[v0];
+			auto edgeLength = glm::length(edge);
+			if (edgeLength == 0.0f)
+				continue;
+			auto borderNormal = glm::normalize(glm::cross(edge, n));
+			AddPlane(quadrics[v0], borderNormal, -glm::dot(borderNormal, positions[v0]), edgeLength * edgeLength * 10.0f);
+			AddPlane(quadrics[v1], borderNormal, -glm::dot(borderNormal, positions[v1]), edgeLength * edgeLength * 10.0f);
+			if (kinds[v0] == VertexKind::Manifold)
+				kinds[v0] = VertexKind::Border;
+			if (kinds[v1] == VertexKind::Manifold)
+				kinds[v1] = VertexKind::Border;
+		}
+	}
+
+	float resultError = 0.0f;
+	std::vector<uint32_t> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+	std::vector<uint32_t> adjacencyOffsets, adjacency, fill;
+	std::vector<EdgeCollapse> collapses;
+
+	// Collapses are done in passes: the cheapest collapses are applied as long as they don't touch the neighbourhood of an earlier collapse
+	// from the same pass, then the mesh is rebuilt
+	while (indices.size() > targetIndexCount)
+	{
+		// Triangles around each vertex
+		adjacencyOffsets.assign(vertexCount + 1, 0);
+		for (auto i : indices)
+			++adjacencyOffsets[i + 1];
+		for (size_t v = 0; v < vertexCount; ++v)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		adjacency.resize(indices.size());
+		fill.assign(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); ++i)
+			adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+
+		edgeCounts.clear();
+		for (size_t i = 0; i < indices.size(); i += 3)
+			for (int e = 0; e < 3; ++e)
+				++edgeCounts[EdgeKey(indices[i + e], indices[i + (e + 1) % 3])];
+
+		collapses.clear();
+		for (auto& edge : edgeCounts)
+		{
+			auto a = (uint32_t)(edge.first >> 32), b = (uint32_t)edge.first;
+			auto border = edge.second == 1;
+
+			Quadric q = quadrics[a];
+			AddQuadric(q, quadrics[b]);
+
+			EdgeCollapse best = { INFINITY, 0, 0 };
+			uint32_t ends[2] = { a, b };
+			for (int d = 0; d < 2; ++d)
+			{
+				auto from = ends[d], to = ends[1 - d];
+				// Border vertices can only slide along the border, or the mesh would develop holes
+				if (kinds[from] == VertexKind::Locked || (kinds[from] == VertexKind::Border && (!border || kinds[to] == VertexKind::Manifold)))
+					continue;
+
+				auto error = QuadricError(q, positions[to]);
+				if (error < best.error)
+					best = EdgeCollapse { error, from, to };
+			}
+
+			if (best.error <= maxError)
+				collapses.push_back(best);
+		}
+
+		if (collapses.empty())
+			break;
+		std::sort(collapses.begin(), collapses.end());
+
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			remap[v] = (uint32_t)v;
+			touched[v] = false;
+		}
+
+		auto triangleCount = indices.size() / 3;
+		auto targetTriangleCount = targetIndexCount / 3;
+		size_t collapsedCount = 0;
+		for (auto& c : collapses)
+		{
+			if (triangleCount <= targetTriangleCount)
+				break;
+			if (touched[c.from] || touched[c.to])
+				continue;
+
+			// Reject collapses which flip any triangle around the collapsed vertex
+			bool flips = false;
+			size_t removedTriangles = 0;
+			for (auto a = adjacencyOffsets[c.from]; a < adjacencyOffsets[c.from + 1] && !flips; ++a)
+			{
+				auto tri = &indices[adjacency[a] * 3];
+				if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to)
+				{
+					++removedTriangles;
+					continue;
+				}
+
+				glm::vec3 p[3], q[3];
+				for (int i = 0; i < 3; ++i)
+				{
+					p[i] = positions[tri[i]];
+					q[i] = tri[i] == c.from ? positions[c.to] : p[i];
+				}
+
+				auto before = glm::cross(p[1] - p[0], p[2] - p[0]);
+				auto after = glm::cross(q[1] - q[0], q[2] - q[0]);
+				flips = glm::dot(before, after) <= 0.0f;
+			}
+			if (flips)
+				continue;
+
+			remap[c.from] = c.to;
+			AddQuadric(quadrics[c.to], quadrics[c.from]);
+			resultError = std::max(resultError, c.error);
+			triangleCount -= removedTriangles;
+			++collapsedCount;
+
+			touched[c.to] = true;
+			for (auto a = adjacencyOffsets[c.from]; a < adjacencyOffsets[c.from + 1]; ++a)
+				for (int i = 0; i < 3; ++i)
+					touched[indices[adjacency[a] * 3 + i]] = true;
+		}
+
+		if (collapsedCount == 0)
+			break;
+
+		// Rebuild the index list, dropping the triangles which became degenerate
+		size_t indexCount = 0;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			auto a = remap[indices[i]], b = remap[indices[i + 1]], c = remap[indices[i + 2]];
+			if (a == b || b == c || a == c)
+				continue;
+			indices[indexCount++] = a;
+			indices[indexCount++] = b;
+			indices[indexCount++] = c;
+		}
+		indices.resize(indexCount);
+	}
+
+	return resultError;
+}
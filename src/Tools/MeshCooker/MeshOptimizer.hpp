@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+///		Reorders triangles to improve post transform vertex cache hit rates (Tom Forsyth's linear speed vertex cache optimization)
+/// </summary>
+/// <param name="indices">Triangle list indices (reordered in place)</param>
+/// <param name="vertexCount">Number of vertices referenced by the indices</param>
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+/// <summary>
+///		Reorders clusters of triangles so the ones facing outwards are drawn first, reducing overdraw from most view directions.
+///		Clusters are split where the vertex cache would be cold anyway, so the cache optimization is mostly kept.
+///		Should be called after OptimizeVertexCache.
+/// </summary>
+/// <param name="indices">Triangle list indices (reordered in place)</param>
+/// <param name="positions">Vertex positions</param>
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const std::vector<glm::vec3>& positions);
+
+/// <summary>
+///		Computes a vertex order following the first use of each vertex by the indices, improving vertex fetch locality
+/// </summary>
+/// <param name="indices">Triangle list indices (remapped in place)</param>
+/// <param name="vertexCount">Number of vertices</param>
+/// <returns>New vertex order (element i is the old index of the vertex which is now at index i)</returns>
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount);
+
+/// <summary>
+///		Simplifies a triangle list with quadric error metric edge collapses (Garland and Heckbert).
+///		Vertices are only collapsed onto other existing vertices, so every level of detail can share the same vertex buffer.
+///		Vertices on open borders only collapse along them, and vertices which share their position with others (attribute seams) are kept.
+/// </summary>
+/// <param name="indices">Triangle list indices (simplified in place)</param>
+/// <param name="positions">Vertex positions</param>
+/// <param name="locked">Vertices which must be kept (such as the ones shared with other meshes, which would crack apart otherwise)</param>
+/// <param name="targetIndexCount">Stops once the index count is at or below this</param>
+/// <param name="maxError">Stops before collapses which would move the surface further than this distance</param>
+/// <returns>Error of the simplified mesh (distance in position units)</returns>
+float SimplifyMesh(std::vector<uint32_t>& indices, const std::vector<glm::vec3>& positions, const std::vector<bool>& locked, size_t targetIndexCount, float maxError);
+
+/// <summary>
+///		Computes the average number of vertex shader invocations per triangle with a FIFO vertex cache (lower is better, 0.5 is the optimum)
+/// </summary>
+float ComputeACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, size_t cacheSize = 16);
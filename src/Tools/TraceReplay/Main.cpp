@@ -0,0 +1,132 @@
+#include <Magma/Input/Window.hpp>
+#include <Magma/Graphics/GLContext.hpp>
+#include <Magma/Graphics/GPUProfiler.hpp>
+#include <Magma/Graphics/TracePlayer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace Magma;
+
+// Plays back a context trace written with the engine's --trace option, printing the CPU and GPU time of each frame.
+//
+// Usage: TraceReplay TRACE [options]
+//	--headless			Plays the trace without a visible window (only traces which render offscreen produce any pixels)
+//	--width=W			Window width (default 1400)
+//	--height=H			Window height (default 800)
+//	--skip=N			Plays the first N frames (usually resource creation) without including them in the summary
+//	--quiet				Only prints the summary
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s TRACE [--headless] [--width=W] [--height=H] [--skip=N] [--quiet]\n", argv[0]);
+		return -1;
+	}
+
+	std::string tracePath = argv[1];
+	bool headless = false, quiet = false;
+	unsigned int width = 1400, height = 800;
+	size_t skip = 0;
+	for (int i = 2; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--headless")
+			headless = true;
+		else if (arg == "--quiet")
+			quiet = true;
+		else if (arg.compare(0, 8, "--width=") == 0)
+			width = std::stoul(arg.substr(8));
+		else if (arg.compare(0, 9, "--height=") == 0)
+			height = std::stoul(arg.substr(9));
+		else if (arg.compare(0, 7, "--skip=") == 0)
+			skip = std::stoul(arg.substr(7));
+	}
+
+	Input::Window window(width, height, "Trace Replay", headless ? Input::WindowMode::Headless : Input::WindowMode::Windowed);
+	Graphics::Context* context = new Graphics::GLContext();
+	Graphics::GPUProfiler* gpuProfiler = new Graphics::GPUProfiler(*context);
+	Graphics::TracePlayer* player;
+
+	try
+	{
+		player = new Graphics::TracePlayer(*context, tracePath);
+	}
+	catch (std::runtime_error& err)
+	{
+		fprintf(stderr, "%s\n", err.what());
+		delete gpuProfiler;
+		delete context;
+		return -1;
+	}
+
+	size_t timedFrames = 0, gpuSamples = 0;
+	uint64_t gpuResultsFrame = 0;
+	double cpuTotal = 0.0, cpuMin = 0.0, cpuMax = 0.0, gpuTotal = 0.0;
+	double callTotals[(size_t)Graphics::ContextCall::Count] = {};
+
+	try
+	{
+		while (!player->IsFinished())
+		{
+			window.PollEvents();
+			gpuProfiler->BeginFrame();
+
+			auto frameStart = std::chrono::high_resolution_clock::now();
+			player->PlayFrame();
+			auto cpuMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
+
+			gpuProfiler->EndFrame();
+			window.SwapBuffers();
+
+			// GPU times are read back a few frames late, so they belong to an earlier frame than the CPU time printed with them
+			auto frame = player->GetFrameCount() - 1;
+			if (!quiet)
+				printf("Frame %zu: %zu calls, %.3f ms CPU, %.3f ms GPU (frame %zu)\n", frame, player->GetFrameCallCount(), cpuMilliseconds,
+					   gpuProfiler->GetFrameMilliseconds(), (size_t)gpuProfiler->GetResultsFrame());
+
+			if (frame < skip)
+				continue;
+
+			cpuMin = timedFrames == 0 ? cpuMilliseconds : std::min(cpuMin, cpuMilliseconds);
+			cpuMax = timedFrames == 0 ? cpuMilliseconds : std::max(cpuMax, cpuMilliseconds);
+			cpuTotal += cpuMilliseconds;
+			// Only new GPU results are sampled, as they aren't read back every frame
+			if (gpuProfiler->GetResultsFrame() != gpuResultsFrame)
+			{
+				gpuResultsFrame = gpuProfiler->GetResultsFrame();
+				gpuTotal += gpuProfiler->GetFrameMilliseconds();
+				++gpuSamples;
+			}
+			for (size_t i = 0; i < (size_t)Graphics::ContextCall::Count; ++i)
+				callTotals[i] += player->GetCallMilliseconds((Graphics::ContextCall)i);
+			++timedFrames;
+		}
+	}
+	catch (std::runtime_error& err)
+	{
+		fprintf(stderr, "%s\n", err.what());
+	}
+
+	if (timedFrames != 0)
+	{
+		printf("Played %zu frames (%zu skipped): %.3f ms CPU (min %.3f, max %.3f), %.3f ms GPU per frame on average\n",
+			   timedFrames, std::min(skip, player->GetFrameCount()), cpuTotal / timedFrames, cpuMin, cpuMax, gpuSamples != 0 ? gpuTotal / gpuSamples : 0.0);
+
+		// Calls sorted by the total CPU time spent on them
+		size_t calls[(size_t)Graphics::ContextCall::Count];
+		for (size_t i = 0; i < (size_t)Graphics::ContextCall::Count; ++i)
+			calls[i] = i;
+		std::sort(calls, calls + (size_t)Graphics::ContextCall::Count, [&](size_t a, size_t b) { return callTotals[a] > callTotals[b]; });
+		for (auto call : calls)
+			if (callTotals[call] > 0.0)
+				printf("\t%s: %.3f ms per frame\n", Graphics::GetContextCallName((Graphics::ContextCall)call), callTotals[call] / timedFrames);
+	}
+
+	delete player;
+	delete gpuProfiler;
+	delete context;
+	return 0;
+}